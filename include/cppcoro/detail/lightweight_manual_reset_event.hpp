@@ -4,8 +4,14 @@
 ///////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include <cppcoro/config.hpp>
+
+#if CPPCORO_OS_LINUX
+# include <atomic>
+#else
 # include <mutex>
 # include <condition_variable>
+#endif
 
 namespace cppcoro::detail {
 class lightweight_manual_reset_event {
@@ -23,8 +29,14 @@ public:
 
 private:
 
+#if CPPCORO_OS_LINUX
+	// 0 if not set, 1 if set, or 2 if not set and threads may be blocked
+	// waiting on the futex.
+	std::atomic<int> m_value;
+#else
 	std::mutex m_mutex;
 	std::condition_variable m_cv;
 	bool m_isSet;
+#endif
 };
 } // namespace cppcoro::detail
@@ -0,0 +1,258 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_DETAIL_LINUX_HPP_INCLUDED
+#define CPPCORO_DETAIL_LINUX_HPP_INCLUDED
+
+#include <cppcoro/config.hpp>
+
+#if !CPPCORO_OS_LINUX
+# error <cppcoro/detail/linux.hpp> is only supported on the Linux platform.
+#endif
+
+#include <utility>
+#include <cstdint>
+
+namespace cppcoro
+{
+	namespace detail
+	{
+		namespace lnx
+		{
+			using fd_t = int;
+
+			/// The kind of I/O operation described by an io_state.
+			///
+			/// The I/O engine translates each opcode into the equivalent
+			/// io_uring submission or system call.
+			enum class io_opcode : std::uint8_t
+			{
+				nop,
+				read,
+				write,
+
+				// Vectored variants of read/write. The io_state's m_buffer
+				// points to an array of m_length iovec structures.
+				readv,
+				writev,
+
+				// Flush the file's data, and its metadata unless m_flags has
+				// IORING_FSYNC_DATASYNC set, to storage.
+				fsync,
+
+				// Allocate m_length bytes of storage starting at m_offset with
+				// the fallocate() mode held in m_flags.
+				fallocate,
+
+				// Write back m_length bytes of data starting at m_offset with
+				// the sync_file_range() flags held in m_flags.
+				sync_file_range,
+
+				// Copy m_length bytes from the file described by the
+				// io_file_range that m_buffer points to, to m_fd at m_offset.
+				copy_file_range,
+
+				// Socket variants of read/write with the MSG_xxx flags held
+				// in m_flags. m_offset must be zero.
+				send,
+				recv,
+
+				// As for send/recv but m_buffer points to a msghdr.
+				sendmsg,
+				recvmsg,
+
+				// As for sendmsg/recvmsg but m_buffer points to an array of
+				// m_length mmsghdrs. The result is the number of messages
+				// transferred.
+				sendmmsg,
+				recvmmsg,
+
+				// As for recv but the buffer is picked, once data arrives, from
+				// the io_buffer_group that m_buffer points to. The completion
+				// flags hold IORING_CQE_F_BUFFER and the id of the buffer if one
+				// was picked.
+				recv_select_buffer,
+
+				// Accept a connection on the listening socket m_fd, creating
+				// the new socket with the SOCK_xxx flags held in m_flags.
+				// The result is the new socket's file descriptor.
+				accept,
+
+				// As for accept but the operation stays armed after accepting
+				// a connection and completes once for each connection accepted,
+				// with IORING_CQE_F_MORE set in the completion flags for all
+				// but its final completion.
+				accept_multishot,
+
+				// Connect the socket m_fd to the sockaddr that m_buffer points
+				// to, which is m_length bytes long.
+				connect,
+
+				// Send m_length bytes from the file described by the
+				// io_file_range that m_buffer points to, to the socket m_fd.
+				sendfile,
+
+				// As for send but the kernel sends directly from m_buffer
+				// rather than copying it. The first completion has
+				// IORING_CQE_F_MORE set if the kernel still references the
+				// buffer, in which case a final completion with
+				// IORING_CQE_F_NOTIF set follows once it no longer does.
+				send_zerocopy
+			};
+
+			/// A file descriptor and offset that an operation reads from, for
+			/// operations that already use the io_state's m_fd and m_offset
+			/// for their destination.
+			struct io_file_range
+			{
+				fd_t m_fd;
+				std::uint64_t m_offset;
+			};
+
+			/// Describes an asynchronous I/O operation that has been submitted
+			/// to an io_service.
+			///
+			/// This plays the same role as the OVERLAPPED structure does on Windows.
+			/// The address of the io_state is passed to the kernel as the
+			/// operation's user-data and is handed back along with the result of
+			/// the operation when the operation completes, at which point the
+			/// callback is invoked on an I/O thread.
+			struct io_state
+			{
+				/// \param result
+				/// The result of the operation. Non-negative values indicate success
+				/// (typically the number of bytes transferred), negative values are
+				/// the negated errno value describing the failure.
+				///
+				/// \param flags
+				/// The completion flags reported by the kernel (IORING_CQE_F_xxx).
+				using callback_type = void(
+					io_state* state,
+					std::int32_t result,
+					std::uint32_t flags);
+
+				io_state(callback_type* callback = nullptr) noexcept
+					: io_state(std::uint64_t(0), callback)
+				{}
+
+				io_state(std::uint64_t offset, callback_type* callback) noexcept
+					: m_opcode(io_opcode::nop)
+					, m_fd(-1)
+					, m_flags(0)
+					, m_pendingCallbacks(0)
+					, m_isCancelRequested(false)
+					, m_isCompletionDequeued(false)
+					, m_buffer(nullptr)
+					, m_length(0)
+					, m_offset(offset)
+					, m_callback(callback)
+					, m_next(nullptr)
+				{}
+
+				io_opcode m_opcode;
+				fd_t m_fd;
+
+				// Opcode-specific flags.
+				std::uint32_t m_flags;
+
+				// Used by multishot operations to tell when the callback for
+				// their final completion is the last of their callbacks to run.
+				// The I/O engine increments this, with an atomic builtin, for
+				// each completion that has IORING_CQE_F_MORE set before that
+				// completion can be dequeued, so that it is never decremented
+				// to zero by a callback while another is yet to run.
+				std::uint32_t m_pendingCallbacks;
+
+				// Set by the I/O engine once cancellation of the operation has
+				// been requested, for operations that it may need to wait for
+				// more than once (eg. sendfile), so that it doesn't wait again.
+				bool m_isCancelRequested;
+
+				// Set by the I/O engine, with an atomic builtin, once the final
+				// completion of the operation has been dequeued, so that a
+				// cancellation requested at the same time isn't left queued
+				// to cancel an unrelated operation that reuses the address.
+				bool m_isCompletionDequeued;
+
+				void* m_buffer;
+				std::uint64_t m_length;
+				std::uint64_t m_offset;
+				callback_type* m_callback;
+
+				// Used by readiness-based I/O engines to queue up operations
+				// that are waiting for their file descriptor to become ready.
+				io_state* m_next;
+			};
+
+			class safe_file_descriptor
+			{
+			public:
+
+				safe_file_descriptor()
+					: m_fd(-1)
+				{}
+
+				explicit safe_file_descriptor(fd_t fd)
+					: m_fd(fd)
+				{}
+
+				safe_file_descriptor(const safe_file_descriptor& other) = delete;
+
+				safe_file_descriptor(safe_file_descriptor&& other) noexcept
+					: m_fd(other.m_fd)
+				{
+					other.m_fd = -1;
+				}
+
+				~safe_file_descriptor()
+				{
+					close();
+				}
+
+				safe_file_descriptor& operator=(safe_file_descriptor fd) noexcept
+				{
+					swap(fd);
+					return *this;
+				}
+
+				constexpr fd_t fd() const { return m_fd; }
+
+				/// Calls close() and sets the fd to -1.
+				void close() noexcept;
+
+				void swap(safe_file_descriptor& other) noexcept
+				{
+					std::swap(m_fd, other.m_fd);
+				}
+
+				bool operator==(const safe_file_descriptor& other) const
+				{
+					return m_fd == other.m_fd;
+				}
+
+				bool operator!=(const safe_file_descriptor& other) const
+				{
+					return m_fd != other.m_fd;
+				}
+
+				bool operator==(fd_t fd) const
+				{
+					return m_fd == fd;
+				}
+
+				bool operator!=(fd_t fd) const
+				{
+					return m_fd != fd;
+				}
+
+			private:
+
+				fd_t m_fd;
+
+			};
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,342 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_DETAIL_LINUX_ASYNC_OPERATION_HPP_INCLUDED
+#define CPPCORO_DETAIL_LINUX_ASYNC_OPERATION_HPP_INCLUDED
+
+#include <cppcoro/cancellation_registration.hpp>
+#include <cppcoro/cancellation_token.hpp>
+#include <cppcoro/operation_cancelled.hpp>
+#include <cppcoro/io_service.hpp>
+
+#include <cppcoro/detail/linux.hpp>
+
+#include <atomic>
+#include <optional>
+#include <system_error>
+#include <coroutine>
+#include <cassert>
+#include <cerrno>
+
+namespace cppcoro
+{
+	namespace detail
+	{
+		class linux_async_operation_base
+			: protected detail::lnx::io_state
+		{
+		public:
+
+			linux_async_operation_base(
+				io_service& ioService,
+				detail::lnx::io_state::callback_type* callback) noexcept
+				: detail::lnx::io_state(callback)
+				, m_ioService(ioService)
+				, m_result(0)
+				, m_resultFlags(0)
+			{}
+
+			linux_async_operation_base(
+				io_service& ioService,
+				std::uint64_t offset,
+				detail::lnx::io_state::callback_type* callback) noexcept
+				: detail::lnx::io_state(offset, callback)
+				, m_ioService(ioService)
+				, m_result(0)
+				, m_resultFlags(0)
+			{}
+
+			detail::lnx::io_state& get_io_state() noexcept
+			{
+				return *this;
+			}
+
+			/// Start the operation described by get_io_state() on the
+			/// io_service.
+			///
+			/// \return
+			/// true if the operation will complete asynchronously, false if
+			/// it completed synchronously and m_result holds its result.
+			bool try_start_io() noexcept
+			{
+				return m_ioService.try_start_io(*this, m_result);
+			}
+
+			void cancel_io() noexcept
+			{
+				m_ioService.cancel_io(*this);
+			}
+
+			std::size_t get_result()
+			{
+				if (m_result < 0)
+				{
+					throw std::system_error{
+						-m_result,
+						std::system_category()
+					};
+				}
+
+				return static_cast<std::size_t>(m_result);
+			}
+
+			io_service& m_ioService;
+			std::int32_t m_result;
+
+			// The completion flags, eg. identifying the buffer picked by a
+			// recv_select_buffer operation. Zero if completed synchronously.
+			std::uint32_t m_resultFlags;
+
+		};
+
+		template<typename OPERATION>
+		class linux_async_operation
+			: protected linux_async_operation_base
+		{
+		protected:
+
+			linux_async_operation(io_service& ioService) noexcept
+				: linux_async_operation_base(
+					ioService,
+					&linux_async_operation::on_operation_completed)
+			{}
+
+			linux_async_operation(io_service& ioService, std::uint64_t offset) noexcept
+				: linux_async_operation_base(
+					ioService,
+					offset,
+					&linux_async_operation::on_operation_completed)
+			{}
+
+		public:
+
+			bool await_ready() const noexcept { return false; }
+
+			CPPCORO_NOINLINE
+			bool await_suspend(std::coroutine_handle<> awaitingCoroutine)
+			{
+				static_assert(std::is_base_of_v<linux_async_operation, OPERATION>);
+
+				m_awaitingCoroutine = awaitingCoroutine;
+				return static_cast<OPERATION*>(this)->try_start();
+			}
+
+			decltype(auto) await_resume()
+			{
+				return static_cast<OPERATION*>(this)->get_result();
+			}
+
+		private:
+
+			static void on_operation_completed(
+				detail::lnx::io_state* ioState,
+				std::int32_t result,
+				std::uint32_t flags) noexcept
+			{
+				auto* operation = static_cast<linux_async_operation*>(ioState);
+				operation->m_result = result;
+				operation->m_resultFlags = flags;
+				operation->m_awaitingCoroutine.resume();
+			}
+
+			std::coroutine_handle<> m_awaitingCoroutine;
+
+		};
+
+		template<typename OPERATION>
+		class linux_async_operation_cancellable
+			: protected linux_async_operation_base
+		{
+		protected:
+
+			linux_async_operation_cancellable(
+				io_service& ioService,
+				cancellation_token&& ct) noexcept
+				: linux_async_operation_base(
+					ioService,
+					&linux_async_operation_cancellable::on_operation_completed)
+				, m_state(ct.is_cancellation_requested() ? state::completed : state::not_started)
+				, m_cancellationToken(std::move(ct))
+			{
+				m_result = -ECANCELED;
+			}
+
+			linux_async_operation_cancellable(
+				io_service& ioService,
+				std::uint64_t offset,
+				cancellation_token&& ct) noexcept
+				: linux_async_operation_base(
+					ioService,
+					offset,
+					&linux_async_operation_cancellable::on_operation_completed)
+				, m_state(ct.is_cancellation_requested() ? state::completed : state::not_started)
+				, m_cancellationToken(std::move(ct))
+			{
+				m_result = -ECANCELED;
+			}
+
+			linux_async_operation_cancellable(
+				linux_async_operation_cancellable&& other) noexcept
+				: linux_async_operation_base(std::move(other))
+				, m_state(other.m_state.load(std::memory_order_relaxed))
+				, m_cancellationToken(std::move(other.m_cancellationToken))
+			{
+				assert(m_result == other.m_result);
+			}
+
+		public:
+
+			bool await_ready() const noexcept
+			{
+				return m_state.load(std::memory_order_relaxed) == state::completed;
+			}
+
+			CPPCORO_NOINLINE
+			bool await_suspend(std::coroutine_handle<> awaitingCoroutine)
+			{
+				static_assert(std::is_base_of_v<linux_async_operation_cancellable, OPERATION>);
+
+				m_awaitingCoroutine = awaitingCoroutine;
+
+				// See win32_overlapped_operation_cancellable::await_suspend() for
+				// why the cancellation callback is registered before starting the
+				// operation and why the transition to 'started' is deferred.
+				const bool canBeCancelled = m_cancellationToken.can_be_cancelled();
+				if (canBeCancelled)
+				{
+					m_cancellationCallback.emplace(
+						std::move(m_cancellationToken),
+						[this] { this->on_cancellation_requested(); });
+				}
+				else
+				{
+					m_state.store(state::started, std::memory_order_relaxed);
+				}
+
+				const bool willCompleteAsynchronously = static_cast<OPERATION*>(this)->try_start();
+				if (!willCompleteAsynchronously)
+				{
+					// Operation completed synchronously, resume awaiting coroutine immediately.
+					return false;
+				}
+
+				if (canBeCancelled)
+				{
+					state oldState = state::not_started;
+					if (!m_state.compare_exchange_strong(
+						oldState,
+						state::started,
+						std::memory_order_release,
+						std::memory_order_acquire))
+					{
+						if (oldState == state::cancellation_requested)
+						{
+							static_cast<OPERATION*>(this)->cancel();
+
+							if (!m_state.compare_exchange_strong(
+								oldState,
+								state::started,
+								std::memory_order_release,
+								std::memory_order_acquire))
+							{
+								assert(oldState == state::completed);
+								return false;
+							}
+						}
+						else
+						{
+							assert(oldState == state::completed);
+							return false;
+						}
+					}
+				}
+
+				return true;
+			}
+
+			decltype(auto) await_resume()
+			{
+				m_cancellationCallback.reset();
+
+				if (m_result == -ECANCELED)
+				{
+					throw operation_cancelled{};
+				}
+
+				return static_cast<OPERATION*>(this)->get_result();
+			}
+
+		private:
+
+			enum class state
+			{
+				not_started,
+				started,
+				cancellation_requested,
+				completed
+			};
+
+			void on_cancellation_requested() noexcept
+			{
+				auto oldState = m_state.load(std::memory_order_acquire);
+				if (oldState == state::not_started)
+				{
+					const bool transferredCancelResponsibility =
+						m_state.compare_exchange_strong(
+							oldState,
+							state::cancellation_requested,
+							std::memory_order_release,
+							std::memory_order_acquire);
+					if (transferredCancelResponsibility)
+					{
+						return;
+					}
+				}
+
+				if (oldState != state::completed)
+				{
+					static_cast<OPERATION*>(this)->cancel();
+				}
+			}
+
+			static void on_operation_completed(
+				detail::lnx::io_state* ioState,
+				std::int32_t result,
+				std::uint32_t flags) noexcept
+			{
+				auto* operation = static_cast<linux_async_operation_cancellable*>(ioState);
+
+				operation->m_result = result;
+				operation->m_resultFlags = flags;
+
+				auto state = operation->m_state.load(std::memory_order_acquire);
+				if (state == state::started)
+				{
+					operation->m_state.store(state::completed, std::memory_order_relaxed);
+					operation->m_awaitingCoroutine.resume();
+				}
+				else
+				{
+					// Racing with await_suspend(), whoever marks the operation
+					// as completed second is responsible for resuming.
+					state = operation->m_state.exchange(
+						state::completed,
+						std::memory_order_acq_rel);
+					if (state == state::started)
+					{
+						operation->m_awaitingCoroutine.resume();
+					}
+				}
+			}
+
+			std::atomic<state> m_state;
+			cppcoro::cancellation_token m_cancellationToken;
+			std::optional<cppcoro::cancellation_registration> m_cancellationCallback;
+			std::coroutine_handle<> m_awaitingCoroutine;
+
+		};
+	}
+}
+
+#endif
@@ -11,7 +11,14 @@
 #include <cppcoro/file_share_mode.hpp>
 #include <cppcoro/file_buffering_mode.hpp>
 
+#if CPPCORO_OS_WINNT
+# include <cppcoro/detail/win32.hpp>
+#elif CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
+#endif
+
 #include <filesystem>
+#include <cstdint>
 
 namespace cppcoro
 {
@@ -28,7 +35,50 @@ namespace cppcoro
 		/// Get the size of the file in bytes.
 		std::uint64_t size() const;
 
+#if CPPCORO_OS_WINNT
+		/// Get the underlying operating system file handle.
+		detail::win32::handle_t native_handle() const noexcept { return m_fileHandle.handle(); }
+#elif CPPCORO_OS_LINUX
+		/// Get the underlying operating system file descriptor.
+		detail::lnx::fd_t native_handle() const noexcept { return m_fileHandle.fd(); }
+#endif
+
 	protected:
+
+#if CPPCORO_OS_WINNT
+		file(detail::win32::safe_handle&& fileHandle) noexcept;
+
+		static detail::win32::safe_handle open(
+			detail::win32::dword_t fileAccess,
+			io_service& ioService,
+			const std::filesystem::path& path,
+			file_open_mode openMode,
+			file_share_mode shareMode,
+			file_buffering_mode bufferingMode);
+
+		detail::win32::safe_handle m_fileHandle;
+#elif CPPCORO_OS_LINUX
+		file(detail::lnx::safe_file_descriptor&& fileHandle, io_service* ioService) noexcept;
+
+		/// Open the file, translating the open and buffering modes into
+		/// their POSIX equivalents.
+		///
+		/// \param accessFlags
+		/// One of O_RDONLY, O_WRONLY or O_RDWR.
+		static detail::lnx::safe_file_descriptor open(
+			int accessFlags,
+			io_service& ioService,
+			const std::filesystem::path& path,
+			file_open_mode openMode,
+			file_share_mode shareMode,
+			file_buffering_mode bufferingMode);
+
+		detail::lnx::safe_file_descriptor m_fileHandle;
+
+		// The io_service that read and write operations are started on.
+		io_service* m_ioService;
+#endif
+
 	};
 }
 
@@ -7,6 +7,16 @@
 
 namespace cppcoro
 {
+	/// Hints and modes that control how the OS buffers file data.
+	///
+	/// On Linux these map to the following:
+	/// - sequential/random_access: posix_fadvise(POSIX_FADV_SEQUENTIAL/RANDOM)
+	/// - unbuffered: O_DIRECT
+	/// - write_through: O_DSYNC
+	/// - temporary: O_TMPFILE when opened with file_open_mode::create_always
+	///   or file_open_mode::create_new, in which case an unnamed file is
+	///   created in the directory containing the path and is deleted when
+	///   closed. Requires write access.
 	enum class file_buffering_mode
 	{
 		default_ = 0,
@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_FILE_COPY_OPERATION_HPP_INCLUDED
+#define CPPCORO_FILE_COPY_OPERATION_HPP_INCLUDED
+
+#include <cppcoro/config.hpp>
+#include <cppcoro/cancellation_registration.hpp>
+#include <cppcoro/cancellation_token.hpp>
+
+#include <atomic>
+#include <optional>
+#include <coroutine>
+
+#if CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
+# include <cppcoro/detail/linux_async_operation.hpp>
+
+namespace cppcoro
+{
+	class file_copy_operation_impl
+	{
+	public:
+
+		file_copy_operation_impl(
+			detail::lnx::fd_t sourceFileHandle,
+			std::uint64_t sourceOffset,
+			detail::lnx::fd_t destinationFileHandle,
+			std::size_t byteCount) noexcept
+			: m_source{ sourceFileHandle, sourceOffset }
+			, m_destinationFileHandle(destinationFileHandle)
+			, m_byteCount(byteCount)
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+
+	private:
+
+		detail::lnx::io_file_range m_source;
+		detail::lnx::fd_t m_destinationFileHandle;
+		std::size_t m_byteCount;
+
+	};
+
+	class file_copy_operation
+		: public cppcoro::detail::linux_async_operation<file_copy_operation>
+	{
+	public:
+
+		file_copy_operation(
+			io_service& ioService,
+			detail::lnx::fd_t sourceFileHandle,
+			std::uint64_t sourceOffset,
+			detail::lnx::fd_t destinationFileHandle,
+			std::uint64_t destinationOffset,
+			std::size_t byteCount) noexcept
+			: cppcoro::detail::linux_async_operation<file_copy_operation>(ioService, destinationOffset)
+			, m_impl(sourceFileHandle, sourceOffset, destinationFileHandle, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<file_copy_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		file_copy_operation_impl m_impl;
+
+	};
+
+	class file_copy_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<file_copy_operation_cancellable>
+	{
+	public:
+
+		file_copy_operation_cancellable(
+			io_service& ioService,
+			detail::lnx::fd_t sourceFileHandle,
+			std::uint64_t sourceOffset,
+			detail::lnx::fd_t destinationFileHandle,
+			std::uint64_t destinationOffset,
+			std::size_t byteCount,
+			cancellation_token&& cancellationToken) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<file_copy_operation_cancellable>(
+				ioService, destinationOffset, std::move(cancellationToken))
+			, m_impl(sourceFileHandle, sourceOffset, destinationFileHandle, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<file_copy_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+
+		file_copy_operation_impl m_impl;
+
+	};
+}
+#endif
+
+#endif
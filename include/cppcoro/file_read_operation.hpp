@@ -95,6 +95,164 @@ namespace cppcoro
 	};
 
 }
+#elif CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
+# include <cppcoro/detail/linux_async_operation.hpp>
+
+# include <span>
+# include <sys/uio.h>
+
+namespace cppcoro
+{
+	class file_read_operation_impl
+	{
+	public:
+
+		file_read_operation_impl(
+			detail::lnx::fd_t fileHandle,
+			void* buffer,
+			std::size_t byteCount) noexcept
+			: m_fileHandle(fileHandle)
+			, m_buffer(buffer)
+			, m_byteCount(byteCount)
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+
+	private:
+
+		detail::lnx::fd_t m_fileHandle;
+		void* m_buffer;
+		std::size_t m_byteCount;
+
+	};
+
+	class file_read_operation
+		: public cppcoro::detail::linux_async_operation<file_read_operation>
+	{
+	public:
+
+		file_read_operation(
+			io_service& ioService,
+			detail::lnx::fd_t fileHandle,
+			std::uint64_t fileOffset,
+			void* buffer,
+			std::size_t byteCount) noexcept
+			: cppcoro::detail::linux_async_operation<file_read_operation>(ioService, fileOffset)
+			, m_impl(fileHandle, buffer, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<file_read_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		file_read_operation_impl m_impl;
+
+	};
+
+	class file_read_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<file_read_operation_cancellable>
+	{
+	public:
+
+		file_read_operation_cancellable(
+			io_service& ioService,
+			detail::lnx::fd_t fileHandle,
+			std::uint64_t fileOffset,
+			void* buffer,
+			std::size_t byteCount,
+			cancellation_token&& cancellationToken) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<file_read_operation_cancellable>(
+				ioService, fileOffset, std::move(cancellationToken))
+			, m_impl(fileHandle, buffer, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<file_read_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+
+		file_read_operation_impl m_impl;
+
+	};
+
+	class file_readv_operation_impl
+	{
+	public:
+
+		file_readv_operation_impl(
+			detail::lnx::fd_t fileHandle,
+			std::span<iovec> buffers) noexcept
+			: m_fileHandle(fileHandle)
+			, m_buffers(buffers)
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+
+	private:
+
+		detail::lnx::fd_t m_fileHandle;
+		std::span<iovec> m_buffers;
+
+	};
+
+	class file_readv_operation
+		: public cppcoro::detail::linux_async_operation<file_readv_operation>
+	{
+	public:
+
+		file_readv_operation(
+			io_service& ioService,
+			detail::lnx::fd_t fileHandle,
+			std::uint64_t fileOffset,
+			std::span<iovec> buffers) noexcept
+			: cppcoro::detail::linux_async_operation<file_readv_operation>(ioService, fileOffset)
+			, m_impl(fileHandle, buffers)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<file_readv_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		file_readv_operation_impl m_impl;
+
+	};
+
+	class file_readv_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<file_readv_operation_cancellable>
+	{
+	public:
+
+		file_readv_operation_cancellable(
+			io_service& ioService,
+			detail::lnx::fd_t fileHandle,
+			std::uint64_t fileOffset,
+			std::span<iovec> buffers,
+			cancellation_token&& cancellationToken) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<file_readv_operation_cancellable>(
+				ioService, fileOffset, std::move(cancellationToken))
+			, m_impl(fileHandle, buffers)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<file_readv_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+
+		file_readv_operation_impl m_impl;
+
+	};
+}
 #endif
 
 #endif
@@ -7,6 +7,11 @@
 
 namespace cppcoro
 {
+	/// Controls the access other processes may have to a file while it is
+	/// open.
+	///
+	/// Linux does not support mandatory file sharing restrictions so the
+	/// share mode is ignored there.
 	enum class file_share_mode
 	{
 		/// Don't allow any other processes to open the file concurrently.
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_FILE_SYNC_OPERATION_HPP_INCLUDED
+#define CPPCORO_FILE_SYNC_OPERATION_HPP_INCLUDED
+
+#include <cppcoro/config.hpp>
+#include <cppcoro/cancellation_registration.hpp>
+#include <cppcoro/cancellation_token.hpp>
+
+#include <atomic>
+#include <optional>
+#include <coroutine>
+
+#if CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
+# include <cppcoro/detail/linux_async_operation.hpp>
+
+namespace cppcoro
+{
+	/// Performs one of the operations that control how a file's data is
+	/// written back to storage (fsync, fallocate or sync_file_range).
+	class file_sync_operation_impl
+	{
+	public:
+
+		file_sync_operation_impl(
+			detail::lnx::fd_t fileHandle,
+			detail::lnx::io_opcode opcode,
+			std::uint32_t flags,
+			std::uint64_t length) noexcept
+			: m_fileHandle(fileHandle)
+			, m_opcode(opcode)
+			, m_flags(flags)
+			, m_length(length)
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+
+	private:
+
+		detail::lnx::fd_t m_fileHandle;
+		detail::lnx::io_opcode m_opcode;
+		std::uint32_t m_flags;
+		std::uint64_t m_length;
+
+	};
+
+	class file_sync_operation
+		: public cppcoro::detail::linux_async_operation<file_sync_operation>
+	{
+	public:
+
+		file_sync_operation(
+			io_service& ioService,
+			detail::lnx::fd_t fileHandle,
+			detail::lnx::io_opcode opcode,
+			std::uint32_t flags,
+			std::uint64_t fileOffset,
+			std::uint64_t length) noexcept
+			: cppcoro::detail::linux_async_operation<file_sync_operation>(ioService, fileOffset)
+			, m_impl(fileHandle, opcode, flags, length)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<file_sync_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		void get_result() { (void)linux_async_operation_base::get_result(); }
+
+		file_sync_operation_impl m_impl;
+
+	};
+
+	class file_sync_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<file_sync_operation_cancellable>
+	{
+	public:
+
+		file_sync_operation_cancellable(
+			io_service& ioService,
+			detail::lnx::fd_t fileHandle,
+			detail::lnx::io_opcode opcode,
+			std::uint32_t flags,
+			std::uint64_t fileOffset,
+			std::uint64_t length,
+			cancellation_token&& cancellationToken) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<file_sync_operation_cancellable>(
+				ioService, fileOffset, std::move(cancellationToken))
+			, m_impl(fileHandle, opcode, flags, length)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<file_sync_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+
+		void get_result() { (void)linux_async_operation_base::get_result(); }
+
+		file_sync_operation_impl m_impl;
+
+	};
+}
+#endif
+
+#endif
@@ -11,7 +11,7 @@
 
 #include <atomic>
 #include <optional>
-#include <experimental/coroutine>
+#include <coroutine>
 
 #if CPPCORO_OS_WINNT
 # include <cppcoro/detail/win32.hpp>
@@ -94,6 +94,164 @@ namespace cppcoro
 	};
 }
 
-#endif // CPPCORO_OS_WINNT
+#elif CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
+# include <cppcoro/detail/linux_async_operation.hpp>
+
+# include <span>
+# include <sys/uio.h>
+
+namespace cppcoro
+{
+	class file_write_operation_impl
+	{
+	public:
+
+		file_write_operation_impl(
+			detail::lnx::fd_t fileHandle,
+			const void* buffer,
+			std::size_t byteCount) noexcept
+			: m_fileHandle(fileHandle)
+			, m_buffer(buffer)
+			, m_byteCount(byteCount)
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+
+	private:
+
+		detail::lnx::fd_t m_fileHandle;
+		const void* m_buffer;
+		std::size_t m_byteCount;
+
+	};
+
+	class file_write_operation
+		: public cppcoro::detail::linux_async_operation<file_write_operation>
+	{
+	public:
+
+		file_write_operation(
+			io_service& ioService,
+			detail::lnx::fd_t fileHandle,
+			std::uint64_t fileOffset,
+			const void* buffer,
+			std::size_t byteCount) noexcept
+			: cppcoro::detail::linux_async_operation<file_write_operation>(ioService, fileOffset)
+			, m_impl(fileHandle, buffer, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<file_write_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		file_write_operation_impl m_impl;
+
+	};
+
+	class file_write_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<file_write_operation_cancellable>
+	{
+	public:
+
+		file_write_operation_cancellable(
+			io_service& ioService,
+			detail::lnx::fd_t fileHandle,
+			std::uint64_t fileOffset,
+			const void* buffer,
+			std::size_t byteCount,
+			cancellation_token&& cancellationToken) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<file_write_operation_cancellable>(
+				ioService, fileOffset, std::move(cancellationToken))
+			, m_impl(fileHandle, buffer, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<file_write_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+
+		file_write_operation_impl m_impl;
+
+	};
+
+	class file_writev_operation_impl
+	{
+	public:
+
+		file_writev_operation_impl(
+			detail::lnx::fd_t fileHandle,
+			std::span<const iovec> buffers) noexcept
+			: m_fileHandle(fileHandle)
+			, m_buffers(buffers)
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+
+	private:
+
+		detail::lnx::fd_t m_fileHandle;
+		std::span<const iovec> m_buffers;
+
+	};
+
+	class file_writev_operation
+		: public cppcoro::detail::linux_async_operation<file_writev_operation>
+	{
+	public:
+
+		file_writev_operation(
+			io_service& ioService,
+			detail::lnx::fd_t fileHandle,
+			std::uint64_t fileOffset,
+			std::span<const iovec> buffers) noexcept
+			: cppcoro::detail::linux_async_operation<file_writev_operation>(ioService, fileOffset)
+			, m_impl(fileHandle, buffers)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<file_writev_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		file_writev_operation_impl m_impl;
+
+	};
+
+	class file_writev_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<file_writev_operation_cancellable>
+	{
+	public:
+
+		file_writev_operation_cancellable(
+			io_service& ioService,
+			detail::lnx::fd_t fileHandle,
+			std::uint64_t fileOffset,
+			std::span<const iovec> buffers,
+			cancellation_token&& cancellationToken) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<file_writev_operation_cancellable>(
+				ioService, fileOffset, std::move(cancellationToken))
+			, m_impl(fileHandle, buffers)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<file_writev_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+
+		file_writev_operation_impl m_impl;
+
+	};
+}
+#endif
 
 #endif
@@ -8,9 +8,13 @@
 #include <cppcoro/config.hpp>
 #include <cppcoro/cancellation_token.hpp>
 #include <cppcoro/cancellation_registration.hpp>
+#include <cppcoro/io_service_backend.hpp>
+#include <cppcoro/io_service_options.hpp>
 
 #if CPPCORO_OS_WINNT
 # include <cppcoro/detail/win32.hpp>
+#elif CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
 #endif
 
 #include <optional>
@@ -18,11 +22,28 @@
 #include <cstdint>
 #include <atomic>
 #include <utility>
+#include <memory>
 #include <mutex>
 #include <coroutine>
 
+#if CPPCORO_OS_LINUX
+# include <cstddef>
+# include <span>
+#endif
+
 namespace cppcoro
 {
+#if CPPCORO_OS_LINUX
+	namespace detail
+	{
+		namespace lnx
+		{
+			class io_engine;
+			class io_buffer_group;
+		}
+	}
+#endif
+
 	class io_service
 	{
 	public:
@@ -30,6 +51,20 @@ namespace cppcoro
 		class schedule_operation;
 		class timed_schedule_operation;
 
+		/// Counters describing how effective busy-polling has been.
+		///
+		/// See io_service_options::busyPollDuration.
+		struct busy_poll_stats
+		{
+			/// The number of times a thread busy-polled for events before
+			/// it would otherwise have blocked.
+			std::uint64_t pollCount = 0;
+
+			/// The number of those busy-polls that found an event before the
+			/// busy-poll duration elapsed and so avoided blocking.
+			std::uint64_t productivePollCount = 0;
+		};
+
 		/// Initialises the io_service.
 		///
 		/// Does not set a concurrency hint. All threads that enter the
@@ -43,8 +78,32 @@ namespace cppcoro
 		/// actively processing events.
 		/// Note that the number of active threads may temporarily go
 		/// above this number.
+		///
+		/// The hint is not enforced on Linux.
+		/// See io_service_options::concurrencyHint.
 		io_service(std::uint32_t concurrencyHint);
 
+		/// Initialise the io_service with a concurrency hint and a choice of
+		/// the mechanism used to wait for I/O events.
+		///
+		/// \param concurrencyHint
+		/// Specifies the target maximum number of I/O threads to be
+		/// actively processing events. Not enforced on Linux.
+		///
+		/// \param backend
+		/// The mechanism used to wait for I/O events on Linux.
+		/// This has no effect on other platforms.
+		///
+		/// \throw std::system_error
+		/// If the requested backend is not available.
+		io_service(std::uint32_t concurrencyHint, io_service_backend backend);
+
+		/// Initialise the io_service with the specified options.
+		///
+		/// \throw std::system_error
+		/// If the requested backend is not available.
+		explicit io_service(const io_service_options& options);
+
 		~io_service();
 
 		io_service(io_service&& other) = delete;
@@ -132,15 +191,133 @@ namespace cppcoro
 
 		void notify_work_finished() noexcept;
 
+		/// Query how often threads busy-polling for events found an event
+		/// before having to block.
+		///
+		/// The counters are updated with relaxed atomics so they may lag
+		/// slightly behind threads that are currently processing events.
+		busy_poll_stats get_busy_poll_stats() const noexcept;
+
 #if CPPCORO_OS_WINNT
 		detail::win32::handle_t native_iocp_handle() noexcept;
 		void ensure_winsock_initialised();
 #endif
 
+#if CPPCORO_OS_LINUX
+		/// Query the mechanism this io_service is using to wait for I/O events.
+		///
+		/// This will never be io_service_backend::automatic.
+		io_service_backend backend() const noexcept;
+
+		/// Query whether the kernel is polling this io_service's submission
+		/// queue so that starting I/O operations does not need a system call.
+		///
+		/// See io_service_options::submissionPolling.
+		bool is_submission_polling_enabled() const noexcept;
+
+		/// Start the asynchronous I/O operation described by \p state.
+		///
+		/// \param result
+		/// Receives the result of the operation if it did not complete
+		/// asynchronously.
+		///
+		/// \return
+		/// true if the operation was started, in which case the io_state's
+		/// callback will be invoked on an I/O thread once it completes.
+		/// false if the operation completed synchronously or could not be
+		/// started, in which case the callback will not be invoked and
+		/// \p result holds the result of the operation; a non-negative
+		/// value on success or the negated errno value on failure.
+		bool try_start_io(detail::lnx::io_state& state, std::int32_t& result) noexcept;
+
+		/// Register a long-lived file or socket descriptor with the kernel.
+		///
+		/// Subsequent I/O operations on the descriptor then refer to it by its
+		/// slot in a registered file table, avoiding the cost of looking up and
+		/// reference counting the file on every operation. Operations use the
+		/// registration automatically.
+		///
+		/// Sockets and files created with this io_service unregister their
+		/// descriptor automatically when they are closed. Any other descriptor
+		/// must be unregistered before it is closed, otherwise operations on a
+		/// new descriptor that reuses the same number would be applied to the
+		/// old file.
+		///
+		/// Registration only has an effect when using io_uring.
+		///
+		/// \throw std::system_error
+		/// If the descriptor could not be registered, eg. because the
+		/// registered file table is full.
+		void register_file(detail::lnx::fd_t fd);
+
+		/// Unregister a descriptor previously registered with register_file().
+		void unregister_file(detail::lnx::fd_t fd) noexcept;
+
+		/// Register a pool of I/O buffers with the kernel.
+		///
+		/// File reads and writes, and socket::send_zerocopy(), whose buffer
+		/// lies entirely within one of the registered buffers then avoid
+		/// pinning the buffer's pages on every operation. Operations use the
+		/// registration automatically.
+		///
+		/// Other socket sends and receives can't use registered buffers as
+		/// io_uring has no fixed-buffer variant of them.
+		///
+		/// Only one set of buffers can be registered at a time and the
+		/// buffers must stay valid until unregister_buffers() is called or the
+		/// io_service is destroyed. Buffers should be registered up front,
+		/// before starting any I/O, as older kernels wait for all outstanding
+		/// operations to complete while registering buffers.
+		///
+		/// Registration only has an effect when using io_uring.
+		///
+		/// \throw std::system_error
+		/// If the buffers could not be registered, eg. because buffers are
+		/// already registered or exceed the locked memory limit.
+		void register_buffers(std::span<const std::span<std::byte>> buffers);
+
+		/// Unregister the buffers registered with register_buffers().
+		void unregister_buffers() noexcept;
+
+		/// Register a group of buffers for io_opcode::recv_select_buffer
+		/// operations to pick from.
+		///
+		/// When using io_uring on kernels that support buffer rings the buffers
+		/// are handed to the kernel, which picks one only once data arrives.
+		/// Otherwise a buffer is picked from the group once the socket becomes
+		/// readable.
+		///
+		/// \throw std::system_error
+		/// If the group could not be registered.
+		void register_buffer_group(detail::lnx::io_buffer_group& group);
+
+		/// Unregister a group registered with register_buffer_group().
+		///
+		/// There must be no outstanding operations using the group.
+		void unregister_buffer_group(detail::lnx::io_buffer_group& group) noexcept;
+
+		/// Hand back a buffer picked from the group by a completed
+		/// recv_select_buffer operation so that it can be picked again.
+		void recycle_buffer(
+			detail::lnx::io_buffer_group& group,
+			std::uint16_t bufferId) noexcept;
+
+		/// Request cancellation of an operation previously started by a
+		/// successful call to try_start_io().
+		///
+		/// The operation will still complete by invoking its callback,
+		/// typically with a result of -ECANCELED if the request to cancel
+		/// was successful.
+		void cancel_io(detail::lnx::io_state& state) noexcept;
+#endif
+
 	private:
 
 		class timer_thread_state;
 		class timer_queue;
+#if CPPCORO_OS_LINUX
+		class event_loop_timer_state;
+#endif
 
 		friend class schedule_operation;
 		friend class timed_schedule_operation;
@@ -167,6 +344,10 @@ namespace cppcoro
 
 		std::atomic<std::uint32_t> m_workCount;
 
+		std::chrono::nanoseconds m_busyPollDuration;
+		std::atomic<std::uint64_t> m_busyPollCount;
+		std::atomic<std::uint64_t> m_productiveBusyPollCount;
+
 #if CPPCORO_OS_WINNT
 		detail::win32::safe_handle m_iocpHandle;
 
@@ -174,13 +355,23 @@ namespace cppcoro
 		std::mutex m_winsockInitialisationMutex;
 #endif
 
+#if CPPCORO_OS_LINUX
+		std::unique_ptr<detail::lnx::io_engine> m_ioEngine;
+#endif
+
 		// Head of a linked-list of schedule operations that are
 		// ready to run but that failed to be queued to the I/O
-		// completion port (eg. due to low memory).
+		// completion port or submission queue (eg. due to low memory).
 		std::atomic<schedule_operation*> m_scheduleOperations;
 
+		std::chrono::nanoseconds m_timerResolution;
 		std::atomic<timer_thread_state*> m_timerState;
 
+#if CPPCORO_OS_LINUX
+		// Only set if timers are processed by the event loop.
+		std::unique_ptr<event_loop_timer_state> m_eventLoopTimerState;
+#endif
+
 	};
 
 	class io_service::schedule_operation
@@ -231,6 +422,27 @@ namespace cppcoro
 
 		friend class io_service::timer_queue;
 		friend class io_service::timer_thread_state;
+#if CPPCORO_OS_LINUX
+		friend class io_service::event_loop_timer_state;
+#endif
+
+		enum class timer_state : std::uint8_t
+		{
+			// The timer is being handed to the timer thread.
+			queuing,
+
+			// The timer has been handed to the timer thread.
+			queued,
+
+			// Cancellation was requested before the timer fired. Once the
+			// timer has been queued, the cancellation request is passed on so
+			// that the timer is taken out of the timer queue and resumed.
+			cancellation_requested,
+
+			// The timer thread has taken the timer out of the timer queue
+			// because it became due.
+			fired
+		};
 
 		io_service::schedule_operation m_scheduleOperation;
 		std::chrono::high_resolution_clock::time_point m_resumeTime;
@@ -238,7 +450,19 @@ namespace cppcoro
 		cppcoro::cancellation_token m_cancellationToken;
 		std::optional<cppcoro::cancellation_registration> m_cancellationRegistration;
 
+		// Links used by the list of newly queued timers, the timer queue
+		// and the list of timers ready to resume.
 		timed_schedule_operation* m_next;
+		timed_schedule_operation* m_prev;
+
+		// Link used by the list of cancelled timers.
+		timed_schedule_operation* m_nextCancelled;
+
+		// Index of the timer queue slot the timer is linked into.
+		// Only accessed by the timer thread.
+		std::uint16_t m_timerQueueSlot;
+
+		std::atomic<timer_state> m_state;
 
 		std::atomic<std::uint32_t> m_refCount;
 
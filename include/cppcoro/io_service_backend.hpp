@@ -0,0 +1,34 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_IO_SERVICE_BACKEND_HPP_INCLUDED
+#define CPPCORO_IO_SERVICE_BACKEND_HPP_INCLUDED
+
+namespace cppcoro
+{
+	/// Selects the mechanism used by an io_service to wait for I/O events.
+	///
+	/// This only has an effect on Linux. On Windows an io_service always
+	/// uses an I/O completion port.
+	enum class io_service_backend
+	{
+		/// Use io_uring if the kernel supports it, otherwise fall back to
+		/// using epoll.
+		///
+		/// The fallback is taken if io_uring could not be set up for any
+		/// reason, eg. because it is disabled by policy on this host.
+		automatic,
+
+		/// Use io_uring.
+		///
+		/// If io_uring could not be set up then constructing the io_service
+		/// raises an exception.
+		io_uring,
+
+		/// Use a readiness-based reactor built on epoll.
+		epoll
+	};
+}
+
+#endif
@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_IO_SERVICE_GROUP_HPP_INCLUDED
+#define CPPCORO_IO_SERVICE_GROUP_HPP_INCLUDED
+
+#include <cppcoro/io_service.hpp>
+#include <cppcoro/io_service_options.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace cppcoro
+{
+	/// \brief
+	/// A group of io_service 'shards', each of which has its own event loop
+	/// running on a dedicated thread pinned to a single CPU.
+	///
+	/// Unlike a single io_service shared by many threads, the shards do not
+	/// share any state so there is no contention between the event loops.
+	/// To spread incoming connections across shards, create one listening
+	/// socket per shard, call set_reuse_port() on each and bind them all to
+	/// the same end-point. The kernel will then distribute new connections
+	/// between the listening sockets.
+	class io_service_group
+	{
+	public:
+
+		/// Initialise with one shard per CPU on the current machine.
+		io_service_group();
+
+		/// Initialise with the specified number of shards.
+		///
+		/// \param shardCount
+		/// The number of io_service shards (and event-loop threads) to create.
+		/// If zero then one shard is created per CPU.
+		explicit io_service_group(std::uint32_t shardCount);
+
+		/// Initialise with the specified number of shards, each constructed
+		/// with the specified options.
+		///
+		/// The options' concurrencyHint is ignored as each shard is only ever
+		/// serviced by a single thread.
+		///
+		/// \throw std::system_error
+		/// If any of the shards could not be created.
+		io_service_group(std::uint32_t shardCount, const io_service_options& options);
+
+		/// Stops all shards and waits for their event-loop threads to exit.
+		~io_service_group();
+
+		io_service_group(const io_service_group& other) = delete;
+		io_service_group& operator=(const io_service_group& other) = delete;
+
+		/// The number of shards in the group.
+		std::uint32_t shard_count() const noexcept
+		{
+			return static_cast<std::uint32_t>(m_shards.size());
+		}
+
+		/// Get the shard with the specified index.
+		io_service& shard(std::uint32_t index) noexcept
+		{
+			return *m_shards[index];
+		}
+
+		/// Get the shard whose event-loop thread is the current thread.
+		///
+		/// \return
+		/// A pointer to the shard or nullptr if the current thread is not
+		/// one of this group's event-loop threads.
+		io_service* current_shard() const noexcept;
+
+		/// Returns an operation that when awaited reschedules the awaiting
+		/// coroutine onto a shard.
+		///
+		/// If awaited from one of this group's event-loop threads then the
+		/// coroutine stays on that thread's shard, otherwise shards are
+		/// chosen in round-robin order.
+		[[nodiscard]]
+		io_service::schedule_operation schedule() noexcept;
+
+		/// Stop all shards.
+		///
+		/// This does not wait for the event-loop threads to exit.
+		void stop() noexcept;
+
+	private:
+
+		void run_shard(std::uint32_t shardIndex) noexcept;
+
+		void shutdown() noexcept;
+
+		static thread_local const io_service_group* s_currentGroup;
+		static thread_local io_service* s_currentShard;
+
+		std::vector<std::unique_ptr<io_service>> m_shards;
+		std::vector<std::thread> m_threads;
+
+		std::atomic<std::uint32_t> m_nextShardIndex;
+
+	};
+}
+
+#endif
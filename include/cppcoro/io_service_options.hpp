@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_IO_SERVICE_OPTIONS_HPP_INCLUDED
+#define CPPCORO_IO_SERVICE_OPTIONS_HPP_INCLUDED
+
+#include <cppcoro/io_service_backend.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace cppcoro
+{
+	/// Selects where an io_service processes the timers used by
+	/// schedule_after().
+	enum class io_service_timer_mode
+	{
+		/// Timers are processed by a dedicated timer thread which
+		/// reschedules due timers onto an I/O thread.
+		timer_thread,
+
+		/// Timers are multiplexed into the io_service's own event loop so
+		/// that due timers are resumed directly by an I/O thread from
+		/// within process_events(), without a separate thread.
+		///
+		/// This is only supported on Linux. Other platforms always use a
+		/// dedicated timer thread.
+		event_loop
+	};
+
+	/// Options used to configure an io_service on construction.
+	struct io_service_options
+	{
+		/// Specifies the target maximum number of I/O threads to be
+		/// actively processing events.
+		///
+		/// A value of zero does not set a concurrency hint.
+		///
+		/// This is only enforced on Windows, by the I/O completion port.
+		/// On Linux every thread that enters the event loop actively
+		/// processes events, so limit the number of threads that call
+		/// io_service::process_events() instead.
+		std::uint32_t concurrencyHint = 0;
+
+		/// The mechanism used to wait for I/O events on Linux.
+		///
+		/// This has no effect on other platforms.
+		io_service_backend backend = io_service_backend::automatic;
+
+		/// The resolution of the timers used by schedule_after().
+		///
+		/// Timers are rounded up to a whole number of ticks of this duration
+		/// and timers that become due within the same tick are resumed as a
+		/// batch. A coarser resolution trades timer precision for reduced
+		/// overhead when there are many timers.
+		///
+		/// Must be positive.
+		std::chrono::nanoseconds timerResolution = std::chrono::milliseconds(1);
+
+		/// Where the timers used by schedule_after() are processed.
+		io_service_timer_mode timerMode = io_service_timer_mode::timer_thread;
+
+		/// How long a thread entering a blocking wait for events should first
+		/// busy-poll for new events before blocking.
+		///
+		/// Busy-polling avoids the cost of blocking in the kernel and being
+		/// woken up again when events arrive in quick succession, at the
+		/// expense of burning CPU while the io_service is idle.
+		/// A value of zero disables busy-polling.
+		///
+		/// This currently only has an effect on Linux.
+		std::chrono::nanoseconds busyPollDuration = std::chrono::nanoseconds::zero();
+
+		/// Whether the kernel should poll the submission queue from a kernel
+		/// thread (IORING_SETUP_SQPOLL) so that starting I/O operations does
+		/// not require a system call while the kernel thread is awake.
+		///
+		/// This only has an effect when using io_uring. If the process does
+		/// not have the privileges required, or the kernel does not support
+		/// submission polling on unregistered files, then the io_service
+		/// silently falls back to submitting with io_uring_enter().
+		/// Use io_service::is_submission_polling_enabled() to find out
+		/// whether submission polling is in effect.
+		bool submissionPolling = false;
+
+		/// How long the kernel's submission polling thread keeps polling
+		/// after it runs out of work before going to sleep, at which point
+		/// the next submission needs a system call to wake it up again.
+		std::chrono::milliseconds submissionPollIdleTimeout = std::chrono::milliseconds(1000);
+
+		/// The CPU to pin the kernel's submission polling thread to.
+		///
+		/// If not set then the kernel thread may run on any CPU.
+		std::optional<std::uint32_t> submissionPollCpu = std::nullopt;
+	};
+}
+
+#endif
@@ -0,0 +1,200 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_MAPPED_FILE_HPP_INCLUDED
+#define CPPCORO_MAPPED_FILE_HPP_INCLUDED
+
+#include <cppcoro/config.hpp>
+
+#if CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <coroutine>
+#include <span>
+#include <utility>
+
+namespace cppcoro
+{
+#if CPPCORO_OS_LINUX
+	class read_only_file;
+
+	template<typename SCHEDULER>
+	class mapped_file_prefetch_operation;
+
+	/// \brief
+	/// A read-only view of a region of a file that has been mapped into
+	/// memory.
+	///
+	/// The mapping remains valid after the file it was created from has
+	/// been closed. Accessing a page of the mapping that is not resident
+	/// takes a page fault that blocks the calling thread while the page is
+	/// read from disk, so use prefetch() to load pages on a thread that may
+	/// block before touching them from an I/O thread.
+	class mapped_file
+	{
+	public:
+
+		/// Construct an empty mapping.
+		mapped_file() noexcept
+			: m_mapping(nullptr)
+			, m_mappingSize(0)
+			, m_data(nullptr)
+			, m_size(0)
+		{}
+
+		mapped_file(mapped_file&& other) noexcept
+			: m_mapping(std::exchange(other.m_mapping, nullptr))
+			, m_mappingSize(std::exchange(other.m_mappingSize, 0))
+			, m_data(std::exchange(other.m_data, nullptr))
+			, m_size(std::exchange(other.m_size, 0))
+		{}
+
+		/// Unmaps the region.
+		~mapped_file();
+
+		mapped_file& operator=(mapped_file other) noexcept
+		{
+			swap(other);
+			return *this;
+		}
+
+		void swap(mapped_file& other) noexcept
+		{
+			std::swap(m_mapping, other.m_mapping);
+			std::swap(m_mappingSize, other.m_mappingSize);
+			std::swap(m_data, other.m_data);
+			std::swap(m_size, other.m_size);
+		}
+
+		/// The contents of the mapped region of the file.
+		std::span<const std::byte> data() const noexcept
+		{
+			return { m_data, m_size };
+		}
+
+		/// The size of the mapped region in bytes.
+		std::size_t size() const noexcept { return m_size; }
+
+		/// Returns an operation that when awaited reschedules the awaiting
+		/// coroutine onto \p scheduler and then makes sure the pages
+		/// covering the specified part of the mapping are resident before
+		/// the coroutine continues.
+		///
+		/// The awaiting coroutine continues on a thread of the scheduler,
+		/// which may block while the pages are read from disk.
+		///
+		/// \param scheduler
+		/// The scheduler to load the pages on, eg. a static_thread_pool.
+		///
+		/// \param offset
+		/// The offset within the mapped region of the first byte to load.
+		///
+		/// \param length
+		/// The number of bytes to load. The range is clamped to the end
+		/// of the mapped region.
+		///
+		/// \throw std::system_error
+		/// From co_await if the pages could not be loaded, eg. because the
+		/// file has since been truncated.
+		template<typename SCHEDULER>
+		[[nodiscard]]
+		mapped_file_prefetch_operation<SCHEDULER> prefetch(
+			SCHEDULER& scheduler,
+			std::size_t offset,
+			std::size_t length) const noexcept;
+
+	private:
+
+		friend class read_only_file;
+
+		template<typename SCHEDULER>
+		friend class mapped_file_prefetch_operation;
+
+		mapped_file(
+			void* mapping,
+			std::size_t mappingSize,
+			const std::byte* data,
+			std::size_t size) noexcept
+			: m_mapping(mapping)
+			, m_mappingSize(mappingSize)
+			, m_data(data)
+			, m_size(size)
+		{}
+
+		/// Map \p length bytes of the file starting at \p offset.
+		static mapped_file map(
+			detail::lnx::fd_t fd,
+			std::uint64_t offset,
+			std::size_t length);
+
+		/// Block until the pages covering the specified range are resident.
+		void populate(std::size_t offset, std::size_t length) const;
+
+		void* m_mapping;
+		std::size_t m_mappingSize;
+		const std::byte* m_data;
+		std::size_t m_size;
+
+	};
+
+	template<typename SCHEDULER>
+	class mapped_file_prefetch_operation
+	{
+		using schedule_operation = decltype(std::declval<SCHEDULER&>().schedule());
+
+	public:
+
+		mapped_file_prefetch_operation(
+			const mapped_file& file,
+			SCHEDULER& scheduler,
+			std::size_t offset,
+			std::size_t length) noexcept
+			: m_file(file)
+			, m_scheduleOperation(scheduler.schedule())
+			, m_offset(offset)
+			, m_length(length)
+		{}
+
+		bool await_ready() noexcept
+		{
+			return m_scheduleOperation.await_ready();
+		}
+
+		decltype(auto) await_suspend(std::coroutine_handle<> awaitingCoroutine)
+		{
+			return m_scheduleOperation.await_suspend(awaitingCoroutine);
+		}
+
+		void await_resume()
+		{
+			// We are now running on the scheduler's thread so it is safe
+			// to block here while the pages are loaded.
+			m_scheduleOperation.await_resume();
+			m_file.populate(m_offset, m_length);
+		}
+
+	private:
+
+		const mapped_file& m_file;
+		schedule_operation m_scheduleOperation;
+		std::size_t m_offset;
+		std::size_t m_length;
+
+	};
+
+	template<typename SCHEDULER>
+	mapped_file_prefetch_operation<SCHEDULER> mapped_file::prefetch(
+		SCHEDULER& scheduler,
+		std::size_t offset,
+		std::size_t length) const noexcept
+	{
+		return mapped_file_prefetch_operation<SCHEDULER>{ *this, scheduler, offset, length };
+	}
+#endif
+}
+
+#endif
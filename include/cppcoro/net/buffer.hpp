@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_NET_BUFFER_HPP_INCLUDED
+#define CPPCORO_NET_BUFFER_HPP_INCLUDED
+
+#include <cstddef>
+
+namespace cppcoro::net
+{
+	/// \brief
+	/// Refers to a contiguous range of memory that data is received into.
+	///
+	/// Used with socket::recv() to scatter received data across several
+	/// buffers with a single operation.
+	class mutable_buffer
+	{
+	public:
+
+		constexpr mutable_buffer() noexcept
+			: m_data(nullptr)
+			, m_size(0)
+		{}
+
+		constexpr mutable_buffer(void* data, std::size_t size) noexcept
+			: m_data(data)
+			, m_size(size)
+		{}
+
+		constexpr void* data() const noexcept { return m_data; }
+
+		constexpr std::size_t size() const noexcept { return m_size; }
+
+	private:
+
+		void* m_data;
+		std::size_t m_size;
+
+	};
+
+	/// \brief
+	/// Refers to a contiguous range of memory holding data to send.
+	///
+	/// Used with socket::send() and socket::send_all() to gather the data
+	/// to send from several buffers with a single operation.
+	class const_buffer
+	{
+	public:
+
+		constexpr const_buffer() noexcept
+			: m_data(nullptr)
+			, m_size(0)
+		{}
+
+		constexpr const_buffer(const void* data, std::size_t size) noexcept
+			: m_data(data)
+			, m_size(size)
+		{}
+
+		constexpr const_buffer(const mutable_buffer& buffer) noexcept
+			: m_data(buffer.data())
+			, m_size(buffer.size())
+		{}
+
+		constexpr const void* data() const noexcept { return m_data; }
+
+		constexpr std::size_t size() const noexcept { return m_size; }
+
+	private:
+
+		const void* m_data;
+		std::size_t m_size;
+
+	};
+}
+
+#endif
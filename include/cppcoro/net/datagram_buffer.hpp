@@ -0,0 +1,39 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_NET_DATAGRAM_BUFFER_HPP_INCLUDED
+#define CPPCORO_NET_DATAGRAM_BUFFER_HPP_INCLUDED
+
+#include <cppcoro/net/ip_endpoint.hpp>
+
+#include <cstddef>
+
+namespace cppcoro::net
+{
+	/// \brief
+	/// Describes one datagram of a batch sent with socket::send_to_batch()
+	/// or received with socket::recv_from_batch().
+	struct datagram_buffer
+	{
+		/// The datagram's payload when sending, or the buffer to receive
+		/// the datagram into.
+		void* buffer = nullptr;
+
+		/// The size of the payload when sending, or of the buffer when
+		/// receiving.
+		std::size_t size = 0;
+
+		/// The address to send the datagram to. Set to the address the
+		/// datagram was received from when receiving.
+		ip_endpoint endpoint;
+
+		/// Set to the size of the datagram when receiving.
+		///
+		/// If this is larger than \c size then the datagram was truncated
+		/// and only its first \c size bytes were received.
+		std::size_t bytesTransferred = 0;
+	};
+}
+
+#endif
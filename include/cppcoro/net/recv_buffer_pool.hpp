@@ -0,0 +1,191 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_NET_RECV_BUFFER_POOL_HPP_INCLUDED
+#define CPPCORO_NET_RECV_BUFFER_POOL_HPP_INCLUDED
+
+#include <cppcoro/config.hpp>
+
+#if CPPCORO_OS_LINUX
+# include <cstddef>
+# include <cstdint>
+# include <memory>
+# include <utility>
+
+namespace cppcoro
+{
+	class io_service;
+
+	namespace detail
+	{
+		namespace lnx
+		{
+			class io_buffer_group;
+		}
+	}
+
+	namespace net
+	{
+		class recv_buffer_pool;
+		class socket_recv_pooled_operation_impl;
+
+		/// \brief
+		/// Holds a buffer from a recv_buffer_pool that data was received into.
+		///
+		/// The buffer is handed back to the pool when the lease is destroyed
+		/// or released.
+		class recv_buffer_lease
+		{
+		public:
+
+			/// Construct an empty lease that holds no buffer.
+			recv_buffer_lease() noexcept
+				: m_pool(nullptr)
+				, m_data(nullptr)
+				, m_size(0)
+				, m_bufferId(0)
+			{}
+
+			recv_buffer_lease(recv_buffer_lease&& other) noexcept
+				: m_pool(std::exchange(other.m_pool, nullptr))
+				, m_data(std::exchange(other.m_data, nullptr))
+				, m_size(std::exchange(other.m_size, 0))
+				, m_bufferId(other.m_bufferId)
+			{}
+
+			recv_buffer_lease& operator=(recv_buffer_lease&& other) noexcept
+			{
+				if (this != &other)
+				{
+					release();
+					m_pool = std::exchange(other.m_pool, nullptr);
+					m_data = std::exchange(other.m_data, nullptr);
+					m_size = std::exchange(other.m_size, 0);
+					m_bufferId = other.m_bufferId;
+				}
+
+				return *this;
+			}
+
+			recv_buffer_lease(const recv_buffer_lease&) = delete;
+			recv_buffer_lease& operator=(const recv_buffer_lease&) = delete;
+
+			~recv_buffer_lease()
+			{
+				release();
+			}
+
+			/// The received data.
+			std::byte* data() const noexcept { return m_data; }
+
+			/// The number of bytes received.
+			///
+			/// Zero if the lease is empty, eg. because the peer closed the
+			/// connection.
+			std::size_t size() const noexcept { return m_size; }
+
+			bool empty() const noexcept { return m_size == 0; }
+
+			/// Hand the buffer back to the pool early, leaving the lease empty.
+			void release() noexcept;
+
+		private:
+
+			friend class socket_recv_pooled_operation_impl;
+
+			recv_buffer_lease(
+				recv_buffer_pool& pool,
+				std::byte* data,
+				std::size_t size,
+				std::uint16_t bufferId) noexcept
+				: m_pool(&pool)
+				, m_data(data)
+				, m_size(size)
+				, m_bufferId(bufferId)
+			{}
+
+			recv_buffer_pool* m_pool;
+			std::byte* m_data;
+			std::size_t m_size;
+			std::uint16_t m_bufferId;
+
+		};
+
+		/// \brief
+		/// A pool of equally sized receive buffers shared by many sockets.
+		///
+		/// A socket::recv() operation that uses the pool only takes a buffer
+		/// from it once data arrives, so a large number of mostly idle
+		/// connections can each have a receive outstanding without each
+		/// needing its own buffer.
+		///
+		/// When using io_uring on kernels that support buffer rings (5.19+)
+		/// the buffers are handed to the kernel, which picks one as data is
+		/// received. Otherwise a buffer is picked once the socket becomes
+		/// readable.
+		///
+		/// The pool must outlive any operations that use it and any leases on
+		/// its buffers.
+		class recv_buffer_pool
+		{
+		public:
+
+			/// Create a pool of \p bufferCount buffers of \p bufferSize bytes
+			/// each and register it with \p ioService.
+			///
+			/// \param bufferCount
+			/// The number of buffers. Must be a power of two no greater
+			/// than 32768.
+			///
+			/// \throw std::system_error
+			/// If the pool could not be registered with the io_service.
+			///
+			/// \throw std::bad_alloc
+			/// If the buffers could not be allocated.
+			recv_buffer_pool(
+				io_service& ioService,
+				std::size_t bufferSize,
+				std::uint16_t bufferCount);
+
+			~recv_buffer_pool();
+
+			recv_buffer_pool(const recv_buffer_pool&) = delete;
+			recv_buffer_pool& operator=(const recv_buffer_pool&) = delete;
+
+			std::size_t buffer_size() const noexcept { return m_bufferSize; }
+
+			std::uint16_t buffer_count() const noexcept { return m_bufferCount; }
+
+		private:
+
+			friend class recv_buffer_lease;
+			friend class socket_recv_pooled_operation_impl;
+
+			cppcoro::detail::lnx::io_buffer_group& group() noexcept { return *m_group; }
+
+			void recycle(std::uint16_t bufferId) noexcept;
+
+			io_service& m_ioService;
+			std::size_t m_bufferSize;
+			std::uint16_t m_bufferCount;
+			std::unique_ptr<std::byte[]> m_buffers;
+			std::unique_ptr<cppcoro::detail::lnx::io_buffer_group> m_group;
+
+		};
+
+		inline void recv_buffer_lease::release() noexcept
+		{
+			if (m_pool != nullptr)
+			{
+				std::exchange(m_pool, nullptr)->recycle(m_bufferId);
+				m_data = nullptr;
+				m_size = 0;
+			}
+		}
+	}
+}
+
+#endif
+
+#endif
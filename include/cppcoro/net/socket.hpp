@@ -13,18 +13,25 @@
 #include <cppcoro/net/socket_disconnect_operation.hpp>
 #include <cppcoro/net/socket_recv_operation.hpp>
 #include <cppcoro/net/socket_recv_from_operation.hpp>
+#include <cppcoro/net/socket_recv_pooled_operation.hpp>
 #include <cppcoro/net/socket_send_operation.hpp>
+#include <cppcoro/net/socket_send_file_operation.hpp>
 #include <cppcoro/net/socket_send_to_operation.hpp>
+#include <cppcoro/net/socket_send_zerocopy_operation.hpp>
 
+#include <cppcoro/async_generator.hpp>
 #include <cppcoro/cancellation_token.hpp>
 
 #if CPPCORO_OS_WINNT
 # include <cppcoro/detail/win32.hpp>
+#elif CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
 #endif
 
 namespace cppcoro
 {
 	class io_service;
+	class readable_file;
 
 	namespace net
 	{
@@ -104,6 +111,11 @@ namespace cppcoro
 			/// operation completing synchronously or whether it should suspend the coroutine
 			/// and wait until the I/O completion event is dispatched to an I/O thread.
 			bool skip_completion_on_success() noexcept { return m_skipCompletionOnSuccess; }
+#elif CPPCORO_OS_LINUX
+			/// Get the file descriptor associated with this socket.
+			///
+			/// The socket is in non-blocking mode.
+			cppcoro::detail::lnx::fd_t native_handle() noexcept { return m_handle; }
 #endif
 
 			/// Get the address and port of the local end-point.
@@ -118,6 +130,43 @@ namespace cppcoro
 			/// end-point of the socket's associated address-family.
 			const ip_endpoint& remote_endpoint() const noexcept { return m_remoteEndPoint; }
 
+			/// Allow multiple sockets to bind to the same address and port.
+			///
+			/// This must be called before bind(). When several listening sockets
+			/// are bound to the same end-point with this option enabled, the
+			/// kernel spreads incoming connections (or datagrams) across them.
+			/// This is typically used to give each shard of an io_service_group
+			/// its own listening socket.
+			///
+			/// This is only supported on platforms with SO_REUSEPORT.
+			///
+			/// \throws std::system_error
+			/// If the option could not be set or is not supported.
+			void set_reuse_port(bool enable);
+
+#if CPPCORO_OS_LINUX
+			/// Set the size of the datagrams that the payload of each send on
+			/// this UDP socket is split into by the kernel (UDP_SEGMENT).
+			///
+			/// This lets a single send carry many datagrams while the kernel,
+			/// or the network card, does the per-datagram work. A segment size
+			/// of zero turns segmentation off. See also send_to_segmented().
+			///
+			/// \throws std::system_error
+			/// If the option could not be set or is not supported.
+			void set_udp_segment_size(std::uint16_t segmentSize);
+
+			/// Allow the kernel to coalesce datagrams received by this UDP
+			/// socket from the same source into a single receive (UDP_GRO).
+			///
+			/// Use recv_from_coalesced() to receive the size of the datagrams
+			/// that were coalesced.
+			///
+			/// \throws std::system_error
+			/// If the option could not be set or is not supported.
+			void set_udp_gro(bool enable);
+#endif
+
 			/// Bind the local end of this socket to the specified local end-point.
 			///
 			/// \param localEndPoint
@@ -192,6 +241,37 @@ namespace cppcoro
 				socket& acceptingSocket,
 				cancellation_token ct) noexcept;
 
+			/// Accept connections on this listening socket as they arrive.
+			///
+			/// On Linux a single multishot accept is kept armed for as long as
+			/// the generator is in use, rather than starting a new accept for
+			/// each connection. Connections accepted while the consumer is busy
+			/// are buffered, up to a limit beyond which further connections are
+			/// left in the listen() backlog until the consumer catches up.
+			///
+			/// The listening socket must outlive the returned generator.
+			///
+			/// \param ioService
+			/// The io_service to associate the accepted sockets with, eg. a
+			/// shard of an io_service_group.
+			///
+			/// \param ct
+			/// A cancellation token that can be used to stop accepting
+			/// connections. Once cancellation is requested, advancing the
+			/// generator throws a cppcoro::operation_cancelled exception.
+			///
+			/// \return
+			/// A generator that yields each accepted socket, which should be
+			/// moved out of the generator before advancing it.
+			/// Advancing the generator throws std::system_error if accepting
+			/// a connection fails.
+			[[nodiscard]]
+			async_generator<socket> accept_many(io_service& ioService);
+			[[nodiscard]]
+			async_generator<socket> accept_many(
+				io_service& ioService,
+				cancellation_token ct);
+
 			[[nodiscard]]
 			socket_disconnect_operation disconnect() noexcept;
 			[[nodiscard]]
@@ -207,6 +287,116 @@ namespace cppcoro
 				std::size_t size,
 				cancellation_token ct) noexcept;
 
+			/// Send the contents of several buffers, in order, with a single
+			/// operation.
+			///
+			/// At most socket_send_buffers_operation_impl::max_buffer_count
+			/// buffers are sent. The buffers must remain valid until the
+			/// operation completes.
+			///
+			/// \return
+			/// An operation that completes with the total number of bytes sent,
+			/// which may be less than the total size of the buffers, as for
+			/// send().
+			[[nodiscard]]
+			socket_send_buffers_operation send(
+				std::span<const const_buffer> buffers) noexcept;
+			[[nodiscard]]
+			socket_send_buffers_operation_cancellable send(
+				std::span<const const_buffer> buffers,
+				cancellation_token ct) noexcept;
+
+			/// Send the entire contents of several buffers, in order.
+			///
+			/// Unlike send(), the operation only completes once all of the
+			/// data has been sent, continuing after any partial sends itself,
+			/// so a frame made up of a header and a payload can be sent with a
+			/// single co_await. Any number of buffers may be sent.
+			///
+			/// \return
+			/// An operation that completes with the total number of bytes sent.
+			/// If the send fails or is cancelled part way through, some of the
+			/// data may have been sent. On Linux, the operation fails with
+			/// EMSGSIZE, without sending anything, if the total size of the
+			/// buffers is more than 0x7FFFF000 bytes.
+			[[nodiscard]]
+			socket_send_buffers_operation send_all(
+				std::span<const const_buffer> buffers) noexcept;
+			[[nodiscard]]
+			socket_send_buffers_operation_cancellable send_all(
+				std::span<const const_buffer> buffers,
+				cancellation_token ct) noexcept;
+
+#if CPPCORO_OS_LINUX
+			/// Send data over the socket without copying it into the kernel.
+			///
+			/// The kernel sends directly from \a buffer, which saves copying
+			/// large buffers but means that it may still be reading from the
+			/// buffer after the send completes. Small sends are generally
+			/// cheaper to copy with send().
+			///
+			/// With io_uring this needs Linux 6.0 or later. Otherwise, and
+			/// for sockets that don't support zero-copy sends, the data is
+			/// copied as for send().
+			///
+			/// With io_uring, a buffer that lies within the buffers registered
+			/// with io_service::register_buffers() is sent using the
+			/// registration, which avoids pinning its pages for each send.
+			///
+			/// \return
+			/// An operation that completes, once the data has been queued, with
+			/// a zerocopy_send holding the number of bytes sent, which may be
+			/// less than \a size, as for send(). The buffer must not be
+			/// modified or freed until its buffer_released() completes.
+			/// Cancellation only applies until the data has been queued.
+			///
+			/// \note
+			/// With the epoll backend the kernel reports that it has finished
+			/// with the buffer via the socket's error queue, so the socket
+			/// must stay open until then.
+			[[nodiscard]]
+			socket_send_zerocopy_operation send_zerocopy(
+				const void* buffer,
+				std::size_t size) noexcept;
+			[[nodiscard]]
+			socket_send_zerocopy_operation_cancellable send_zerocopy(
+				const void* buffer,
+				std::size_t size,
+				cancellation_token ct) noexcept;
+#endif
+
+			/// Send part of a file over the socket without copying the data
+			/// through user space.
+			///
+			/// \param file
+			/// The file to send the contents of. The file must remain open
+			/// until the operation completes.
+			///
+			/// \param offset
+			/// The offset within the file of the first byte to send.
+			///
+			/// \param size
+			/// The number of bytes to send.
+			///
+			/// \return
+			/// An operation that completes with the number of bytes sent, which
+			/// may be less than \a size, as for send().
+			///
+			/// \note
+			/// On Linux this uses sendfile(), which raises SIGPIPE if the
+			/// connection has been closed by the peer, as write() does.
+			[[nodiscard]]
+			socket_send_file_operation send_file(
+				const readable_file& file,
+				std::uint64_t offset,
+				std::size_t size) noexcept;
+			[[nodiscard]]
+			socket_send_file_operation_cancellable send_file(
+				const readable_file& file,
+				std::uint64_t offset,
+				std::size_t size,
+				cancellation_token ct) noexcept;
+
 			[[nodiscard]]
 			socket_recv_operation recv(
 				void* buffer,
@@ -217,6 +407,43 @@ namespace cppcoro
 				std::size_t size,
 				cancellation_token ct) noexcept;
 
+			/// Receive data into several buffers with a single operation,
+			/// filling each buffer before moving on to the next.
+			///
+			/// At most socket_recv_buffers_operation_impl::max_buffer_count
+			/// buffers are received into.
+			///
+			/// \return
+			/// An operation that completes with the total number of bytes
+			/// received, which is zero if the peer closed the connection.
+			[[nodiscard]]
+			socket_recv_buffers_operation recv(
+				std::span<const mutable_buffer> buffers) noexcept;
+			[[nodiscard]]
+			socket_recv_buffers_operation_cancellable recv(
+				std::span<const mutable_buffer> buffers,
+				cancellation_token ct) noexcept;
+
+#if CPPCORO_OS_LINUX
+			/// Receive data into a buffer taken from \p pool.
+			///
+			/// A buffer is only taken from the pool once data arrives, so many
+			/// mostly idle connections can each have a receive outstanding
+			/// while sharing a small number of buffers.
+			///
+			/// \return
+			/// An operation that completes with a lease on the buffer holding
+			/// the received data. The lease is empty if the peer closed the
+			/// connection. The operation fails with ENOBUFS if all of the
+			/// pool's buffers are in use when data arrives.
+			[[nodiscard]]
+			socket_recv_pooled_operation recv(recv_buffer_pool& pool) noexcept;
+			[[nodiscard]]
+			socket_recv_pooled_operation_cancellable recv(
+				recv_buffer_pool& pool,
+				cancellation_token ct) noexcept;
+#endif
+
 			[[nodiscard]]
 			socket_recv_from_operation recv_from(
 				void* buffer,
@@ -239,6 +466,86 @@ namespace cppcoro
 				std::size_t size,
 				cancellation_token ct) noexcept;
 
+#if CPPCORO_OS_LINUX
+			/// Send a buffer as a sequence of \p segmentSize byte datagrams
+			/// to \p destination, with a single operation (UDP_SEGMENT).
+			///
+			/// Every datagram but the last is \p segmentSize bytes long.
+			///
+			/// \return
+			/// An operation that completes with the number of bytes sent.
+			[[nodiscard]]
+			socket_send_to_operation send_to_segmented(
+				const ip_endpoint& destination,
+				const void* buffer,
+				std::size_t size,
+				std::uint16_t segmentSize) noexcept;
+			[[nodiscard]]
+			socket_send_to_operation_cancellable send_to_segmented(
+				const ip_endpoint& destination,
+				const void* buffer,
+				std::size_t size,
+				std::uint16_t segmentSize,
+				cancellation_token ct) noexcept;
+
+			/// Receive datagrams that the kernel may have coalesced into the
+			/// buffer, once set_udp_gro() has been enabled.
+			///
+			/// \return
+			/// An operation that completes with a tuple of the number of bytes
+			/// received, the source address and the size of the coalesced
+			/// datagrams. Every datagram but the last is of that size, so the
+			/// buffer can be split back into datagrams. If the datagrams were
+			/// not coalesced then the size is the number of bytes received.
+			[[nodiscard]]
+			socket_recv_from_coalesced_operation recv_from_coalesced(
+				void* buffer,
+				std::size_t size) noexcept;
+			[[nodiscard]]
+			socket_recv_from_coalesced_operation_cancellable recv_from_coalesced(
+				void* buffer,
+				std::size_t size,
+				cancellation_token ct) noexcept;
+
+			/// Receive a batch of datagrams with a single operation.
+			///
+			/// Completes once at least one datagram has been received, with
+			/// each received datagram's size and source address recorded in
+			/// the corresponding element of \p datagrams.
+			///
+			/// At most socket_recv_from_batch_operation_impl::max_batch_size
+			/// datagrams are received by one operation.
+			///
+			/// \return
+			/// An operation that completes with the number of datagrams
+			/// received. These fill the first elements of \p datagrams.
+			[[nodiscard]]
+			socket_recv_from_batch_operation recv_from_batch(
+				std::span<datagram_buffer> datagrams) noexcept;
+			[[nodiscard]]
+			socket_recv_from_batch_operation_cancellable recv_from_batch(
+				std::span<datagram_buffer> datagrams,
+				cancellation_token ct) noexcept;
+
+			/// Send a batch of datagrams, each to its own endpoint, with a
+			/// single operation.
+			///
+			/// At most socket_send_to_batch_operation_impl::max_batch_size
+			/// datagrams are sent by one operation.
+			///
+			/// \return
+			/// An operation that completes with the number of datagrams
+			/// sent, which may be fewer than requested, in which case the
+			/// remaining datagrams should be sent with another operation.
+			[[nodiscard]]
+			socket_send_to_batch_operation send_to_batch(
+				std::span<const datagram_buffer> datagrams) noexcept;
+			[[nodiscard]]
+			socket_send_to_batch_operation_cancellable send_to_batch(
+				std::span<const datagram_buffer> datagrams,
+				cancellation_token ct) noexcept;
+#endif
+
 			void close_send();
 			void close_recv();
 
@@ -251,11 +558,18 @@ namespace cppcoro
 			explicit socket(
 				cppcoro::detail::win32::socket_t handle,
 				bool skipCompletionOnSuccess) noexcept;
+#elif CPPCORO_OS_LINUX
+			explicit socket(
+				cppcoro::detail::lnx::fd_t handle,
+				io_service& ioService) noexcept;
 #endif
 
 #if CPPCORO_OS_WINNT
 			cppcoro::detail::win32::socket_t m_handle;
 			bool m_skipCompletionOnSuccess;
+#elif CPPCORO_OS_LINUX
+			cppcoro::detail::lnx::fd_t m_handle;
+			io_service* m_ioService;
 #endif
 
 			ip_endpoint m_localEndPoint;
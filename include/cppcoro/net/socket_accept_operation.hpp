@@ -104,6 +104,91 @@ namespace cppcoro
 	}
 }
 
-#endif // CPPCORO_OS_WINNT
+#elif CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
+# include <cppcoro/detail/linux_async_operation.hpp>
+
+namespace cppcoro
+{
+	namespace net
+	{
+		class socket;
+
+		class socket_accept_operation_impl
+		{
+		public:
+
+			socket_accept_operation_impl(
+				socket& listeningSocket,
+				socket& acceptingSocket) noexcept
+				: m_listeningSocket(listeningSocket)
+				, m_acceptingSocket(acceptingSocket)
+			{}
+
+			bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+			void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+			void get_result(cppcoro::detail::linux_async_operation_base& operation);
+
+		private:
+
+			socket& m_listeningSocket;
+			socket& m_acceptingSocket;
+
+		};
+
+		class socket_accept_operation
+			: public cppcoro::detail::linux_async_operation<socket_accept_operation>
+		{
+		public:
+
+			socket_accept_operation(
+				io_service& ioService,
+				socket& listeningSocket,
+				socket& acceptingSocket) noexcept
+				: cppcoro::detail::linux_async_operation<socket_accept_operation>(ioService)
+				, m_impl(listeningSocket, acceptingSocket)
+			{}
+
+		private:
+
+			friend class cppcoro::detail::linux_async_operation<socket_accept_operation>;
+
+			bool try_start() noexcept { return m_impl.try_start(*this); }
+			void get_result() { m_impl.get_result(*this); }
+
+			socket_accept_operation_impl m_impl;
+
+		};
+
+		class socket_accept_operation_cancellable
+			: public cppcoro::detail::linux_async_operation_cancellable<socket_accept_operation_cancellable>
+		{
+		public:
+
+			socket_accept_operation_cancellable(
+				io_service& ioService,
+				socket& listeningSocket,
+				socket& acceptingSocket,
+				cancellation_token&& ct) noexcept
+				: cppcoro::detail::linux_async_operation_cancellable<socket_accept_operation_cancellable>(
+					ioService, std::move(ct))
+				, m_impl(listeningSocket, acceptingSocket)
+			{}
+
+		private:
+
+			friend class cppcoro::detail::linux_async_operation_cancellable<socket_accept_operation_cancellable>;
+
+			bool try_start() noexcept { return m_impl.try_start(*this); }
+			void cancel() noexcept { m_impl.cancel(*this); }
+			void get_result() { m_impl.get_result(*this); }
+
+			socket_accept_operation_impl m_impl;
+
+		};
+	}
+}
+
+#endif
 
 #endif
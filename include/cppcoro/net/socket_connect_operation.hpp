@@ -90,6 +90,96 @@ namespace cppcoro
 	}
 }
 
-#endif // CPPCORO_OS_WINNT
+#elif CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
+# include <cppcoro/detail/linux_async_operation.hpp>
+
+# include <cstdint>
+
+namespace cppcoro
+{
+	namespace net
+	{
+		class socket;
+
+		class socket_connect_operation_impl
+		{
+		public:
+
+			socket_connect_operation_impl(
+				socket& socket,
+				const ip_endpoint& remoteEndPoint) noexcept
+				: m_socket(socket)
+				, m_remoteEndPoint(remoteEndPoint)
+			{}
+
+			bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+			void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+			void get_result(cppcoro::detail::linux_async_operation_base& operation);
+
+		private:
+
+			socket& m_socket;
+			ip_endpoint m_remoteEndPoint;
+
+			// Storage suitable for either sockaddr_in or sockaddr_in6.
+			alignas(4) std::uint8_t m_remoteSockaddrStorage[28];
+
+		};
+
+		class socket_connect_operation
+			: public cppcoro::detail::linux_async_operation<socket_connect_operation>
+		{
+		public:
+
+			socket_connect_operation(
+				io_service& ioService,
+				socket& socket,
+				const ip_endpoint& remoteEndPoint) noexcept
+				: cppcoro::detail::linux_async_operation<socket_connect_operation>(ioService)
+				, m_impl(socket, remoteEndPoint)
+			{}
+
+		private:
+
+			friend class cppcoro::detail::linux_async_operation<socket_connect_operation>;
+
+			bool try_start() noexcept { return m_impl.try_start(*this); }
+			decltype(auto) get_result() { return m_impl.get_result(*this); }
+
+			socket_connect_operation_impl m_impl;
+
+		};
+
+		class socket_connect_operation_cancellable
+			: public cppcoro::detail::linux_async_operation_cancellable<socket_connect_operation_cancellable>
+		{
+		public:
+
+			socket_connect_operation_cancellable(
+				io_service& ioService,
+				socket& socket,
+				const ip_endpoint& remoteEndPoint,
+				cancellation_token&& ct) noexcept
+				: cppcoro::detail::linux_async_operation_cancellable<socket_connect_operation_cancellable>(
+					ioService, std::move(ct))
+				, m_impl(socket, remoteEndPoint)
+			{}
+
+		private:
+
+			friend class cppcoro::detail::linux_async_operation_cancellable<socket_connect_operation_cancellable>;
+
+			bool try_start() noexcept { return m_impl.try_start(*this); }
+			void cancel() noexcept { m_impl.cancel(*this); }
+			void get_result() { m_impl.get_result(*this); }
+
+			socket_connect_operation_impl m_impl;
+
+		};
+	}
+}
+
+#endif
 
 #endif
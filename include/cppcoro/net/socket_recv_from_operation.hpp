@@ -101,6 +101,255 @@ namespace cppcoro::net
 
 }
 
-#endif // CPPCORO_OS_WINNT
+#elif CPPCORO_OS_LINUX
+# include <cppcoro/net/datagram_buffer.hpp>
+# include <cppcoro/detail/linux.hpp>
+# include <cppcoro/detail/linux_async_operation.hpp>
+
+# include <span>
+
+# include <sys/uio.h>
+
+namespace cppcoro::net
+{
+	class socket;
+
+	class socket_recv_from_operation_impl
+	{
+	public:
+
+		socket_recv_from_operation_impl(
+			socket& socket,
+			void* buffer,
+			std::size_t byteCount,
+			bool reportSegmentSize = false) noexcept
+			: m_socket(socket)
+			, m_buffer{ buffer, byteCount }
+			, m_reportSegmentSize(reportSegmentSize)
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		std::tuple<std::size_t, ip_endpoint> get_result(
+			cppcoro::detail::linux_async_operation_base& operation);
+
+		/// As for get_result() but also returns the size of the datagrams that
+		/// were coalesced into the buffer.
+		std::tuple<std::size_t, ip_endpoint, std::size_t> get_coalesced_result(
+			cppcoro::detail::linux_async_operation_base& operation);
+
+	private:
+
+		socket& m_socket;
+		iovec m_buffer;
+
+		// Whether to ask for the segment size of coalesced datagrams (UDP_GRO).
+		bool m_reportSegmentSize;
+
+		// Storage suitable for a msghdr.
+		alignas(void*) std::uint8_t m_messageStorage[7 * sizeof(void*)];
+
+		// Storage suitable for either sockaddr_in or sockaddr_in6.
+		alignas(4) std::uint8_t m_sourceSockaddrStorage[28];
+
+		// Storage suitable for a control message holding the segment size.
+		alignas(std::size_t) std::uint8_t m_controlStorage[24];
+
+	};
+
+	class socket_recv_from_operation
+		: public cppcoro::detail::linux_async_operation<socket_recv_from_operation>
+	{
+	public:
+
+		socket_recv_from_operation(
+			io_service& ioService,
+			socket& socket,
+			void* buffer,
+			std::size_t byteCount) noexcept
+			: cppcoro::detail::linux_async_operation<socket_recv_from_operation>(ioService)
+			, m_impl(socket, buffer, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<socket_recv_from_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		decltype(auto) get_result() { return m_impl.get_result(*this); }
+
+		socket_recv_from_operation_impl m_impl;
+
+	};
+
+	class socket_recv_from_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<socket_recv_from_operation_cancellable>
+	{
+	public:
+
+		socket_recv_from_operation_cancellable(
+			io_service& ioService,
+			socket& socket,
+			void* buffer,
+			std::size_t byteCount,
+			cancellation_token&& ct) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<socket_recv_from_operation_cancellable>(
+				ioService, std::move(ct))
+			, m_impl(socket, buffer, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<socket_recv_from_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+		decltype(auto) get_result() { return m_impl.get_result(*this); }
+
+		socket_recv_from_operation_impl m_impl;
+
+	};
+
+	class socket_recv_from_coalesced_operation
+		: public cppcoro::detail::linux_async_operation<socket_recv_from_coalesced_operation>
+	{
+	public:
+
+		socket_recv_from_coalesced_operation(
+			io_service& ioService,
+			socket& socket,
+			void* buffer,
+			std::size_t byteCount) noexcept
+			: cppcoro::detail::linux_async_operation<socket_recv_from_coalesced_operation>(ioService)
+			, m_impl(socket, buffer, byteCount, true)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<socket_recv_from_coalesced_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		decltype(auto) get_result() { return m_impl.get_coalesced_result(*this); }
+
+		socket_recv_from_operation_impl m_impl;
+
+	};
+
+	class socket_recv_from_coalesced_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<socket_recv_from_coalesced_operation_cancellable>
+	{
+	public:
+
+		socket_recv_from_coalesced_operation_cancellable(
+			io_service& ioService,
+			socket& socket,
+			void* buffer,
+			std::size_t byteCount,
+			cancellation_token&& ct) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<socket_recv_from_coalesced_operation_cancellable>(
+				ioService, std::move(ct))
+			, m_impl(socket, buffer, byteCount, true)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<socket_recv_from_coalesced_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+		decltype(auto) get_result() { return m_impl.get_coalesced_result(*this); }
+
+		socket_recv_from_operation_impl m_impl;
+
+	};
+
+	class socket_recv_from_batch_operation_impl
+	{
+	public:
+
+		/// The maximum number of datagrams received by a single operation.
+		static constexpr std::size_t max_batch_size = 32;
+
+		socket_recv_from_batch_operation_impl(
+			socket& socket,
+			std::span<datagram_buffer> datagrams) noexcept
+			: m_socket(socket)
+			, m_datagrams(datagrams.first(
+				datagrams.size() < max_batch_size ? datagrams.size() : max_batch_size))
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		std::size_t get_result(cppcoro::detail::linux_async_operation_base& operation);
+
+	private:
+
+		socket& m_socket;
+		std::span<datagram_buffer> m_datagrams;
+
+		iovec m_buffers[max_batch_size];
+
+		// Storage suitable for an array of mmsghdr.
+		alignas(void*) std::uint8_t m_messageStorage[max_batch_size][8 * sizeof(void*)];
+
+		// Storage suitable for either sockaddr_in or sockaddr_in6.
+		alignas(4) std::uint8_t m_sourceSockaddrStorage[max_batch_size][28];
+
+	};
+
+	class socket_recv_from_batch_operation
+		: public cppcoro::detail::linux_async_operation<socket_recv_from_batch_operation>
+	{
+	public:
+
+		socket_recv_from_batch_operation(
+			io_service& ioService,
+			socket& socket,
+			std::span<datagram_buffer> datagrams) noexcept
+			: cppcoro::detail::linux_async_operation<socket_recv_from_batch_operation>(ioService)
+			, m_impl(socket, datagrams)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<socket_recv_from_batch_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		decltype(auto) get_result() { return m_impl.get_result(*this); }
+
+		socket_recv_from_batch_operation_impl m_impl;
+
+	};
+
+	class socket_recv_from_batch_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<socket_recv_from_batch_operation_cancellable>
+	{
+	public:
+
+		socket_recv_from_batch_operation_cancellable(
+			io_service& ioService,
+			socket& socket,
+			std::span<datagram_buffer> datagrams,
+			cancellation_token&& ct) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<socket_recv_from_batch_operation_cancellable>(
+				ioService, std::move(ct))
+			, m_impl(socket, datagrams)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<socket_recv_from_batch_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+		decltype(auto) get_result() { return m_impl.get_result(*this); }
+
+		socket_recv_from_batch_operation_impl m_impl;
+
+	};
+
+}
+
+#endif
 
 #endif
@@ -7,8 +7,10 @@
 
 #include <cppcoro/config.hpp>
 #include <cppcoro/cancellation_token.hpp>
+#include <cppcoro/net/buffer.hpp>
 
 #include <cstdint>
+#include <span>
 
 #if CPPCORO_OS_WINNT
 # include <cppcoro/detail/win32.hpp>
@@ -87,8 +89,248 @@ namespace cppcoro::net
 
 	};
 
+	class socket_recv_buffers_operation_impl
+	{
+	public:
+
+		/// The maximum number of buffers received into by a single operation.
+		///
+		/// Any further buffers are left untouched.
+		static constexpr std::size_t max_buffer_count = 16;
+
+		socket_recv_buffers_operation_impl(
+			socket& s,
+			std::span<const mutable_buffer> buffers) noexcept
+			: m_socket(s)
+			, m_buffers(buffers.first(
+				buffers.size() < max_buffer_count ? buffers.size() : max_buffer_count))
+		{}
+
+		bool try_start(cppcoro::detail::win32_overlapped_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::win32_overlapped_operation_base& operation) noexcept;
+
+	private:
+
+		socket& m_socket;
+		std::span<const mutable_buffer> m_buffers;
+		cppcoro::detail::win32::wsabuf m_wsaBuffers[max_buffer_count];
+
+	};
+
+	class socket_recv_buffers_operation
+		: public cppcoro::detail::win32_overlapped_operation<socket_recv_buffers_operation>
+	{
+	public:
+
+		socket_recv_buffers_operation(
+			socket& s,
+			std::span<const mutable_buffer> buffers) noexcept
+			: m_impl(s, buffers)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::win32_overlapped_operation<socket_recv_buffers_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		socket_recv_buffers_operation_impl m_impl;
+
+	};
+
+	class socket_recv_buffers_operation_cancellable
+		: public cppcoro::detail::win32_overlapped_operation_cancellable<socket_recv_buffers_operation_cancellable>
+	{
+	public:
+
+		socket_recv_buffers_operation_cancellable(
+			socket& s,
+			std::span<const mutable_buffer> buffers,
+			cancellation_token&& ct) noexcept
+			: cppcoro::detail::win32_overlapped_operation_cancellable<socket_recv_buffers_operation_cancellable>(std::move(ct))
+			, m_impl(s, buffers)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::win32_overlapped_operation_cancellable<socket_recv_buffers_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { return m_impl.cancel(*this); }
+
+		socket_recv_buffers_operation_impl m_impl;
+
+	};
+
 }
 
-#endif // CPPCORO_OS_WINNT
+#elif CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
+# include <cppcoro/detail/linux_async_operation.hpp>
+
+# include <sys/uio.h>
+
+namespace cppcoro::net
+{
+	class socket;
+
+	class socket_recv_operation_impl
+	{
+	public:
+
+		socket_recv_operation_impl(
+			socket& s,
+			void* buffer,
+			std::size_t byteCount) noexcept
+			: m_socket(s)
+			, m_buffer(buffer)
+			, m_byteCount(byteCount)
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+
+	private:
+
+		socket& m_socket;
+		void* m_buffer;
+		std::size_t m_byteCount;
+
+	};
+
+	class socket_recv_operation
+		: public cppcoro::detail::linux_async_operation<socket_recv_operation>
+	{
+	public:
+
+		socket_recv_operation(
+			io_service& ioService,
+			socket& s,
+			void* buffer,
+			std::size_t byteCount) noexcept
+			: cppcoro::detail::linux_async_operation<socket_recv_operation>(ioService)
+			, m_impl(s, buffer, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<socket_recv_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		socket_recv_operation_impl m_impl;
+
+	};
+
+	class socket_recv_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<socket_recv_operation_cancellable>
+	{
+	public:
+
+		socket_recv_operation_cancellable(
+			io_service& ioService,
+			socket& s,
+			void* buffer,
+			std::size_t byteCount,
+			cancellation_token&& ct) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<socket_recv_operation_cancellable>(
+				ioService, std::move(ct))
+			, m_impl(s, buffer, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<socket_recv_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+
+		socket_recv_operation_impl m_impl;
+
+	};
+
+	class socket_recv_buffers_operation_impl
+	{
+	public:
+
+		/// The maximum number of buffers received into by a single operation.
+		///
+		/// Any further buffers are left untouched.
+		static constexpr std::size_t max_buffer_count = 16;
+
+		socket_recv_buffers_operation_impl(
+			socket& s,
+			std::span<const mutable_buffer> buffers) noexcept
+			: m_socket(s)
+			, m_buffers(buffers.first(
+				buffers.size() < max_buffer_count ? buffers.size() : max_buffer_count))
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+
+	private:
+
+		socket& m_socket;
+		std::span<const mutable_buffer> m_buffers;
+		iovec m_iovecs[max_buffer_count];
+
+		// Storage suitable for a msghdr.
+		alignas(void*) std::uint8_t m_messageStorage[7 * sizeof(void*)];
+
+	};
+
+	class socket_recv_buffers_operation
+		: public cppcoro::detail::linux_async_operation<socket_recv_buffers_operation>
+	{
+	public:
+
+		socket_recv_buffers_operation(
+			io_service& ioService,
+			socket& s,
+			std::span<const mutable_buffer> buffers) noexcept
+			: cppcoro::detail::linux_async_operation<socket_recv_buffers_operation>(ioService)
+			, m_impl(s, buffers)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<socket_recv_buffers_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		socket_recv_buffers_operation_impl m_impl;
+
+	};
+
+	class socket_recv_buffers_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<socket_recv_buffers_operation_cancellable>
+	{
+	public:
+
+		socket_recv_buffers_operation_cancellable(
+			io_service& ioService,
+			socket& s,
+			std::span<const mutable_buffer> buffers,
+			cancellation_token&& ct) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<socket_recv_buffers_operation_cancellable>(
+				ioService, std::move(ct))
+			, m_impl(s, buffers)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<socket_recv_buffers_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+
+		socket_recv_buffers_operation_impl m_impl;
+
+	};
+
+}
+
+#endif
 
 #endif
@@ -0,0 +1,188 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_NET_SOCKET_SEND_FILE_OPERATION_HPP_INCLUDED
+#define CPPCORO_NET_SOCKET_SEND_FILE_OPERATION_HPP_INCLUDED
+
+#include <cppcoro/config.hpp>
+#include <cppcoro/cancellation_token.hpp>
+
+#include <cstdint>
+
+#if CPPCORO_OS_WINNT
+# include <cppcoro/detail/win32.hpp>
+# include <cppcoro/detail/win32_overlapped_operation.hpp>
+
+namespace cppcoro::net
+{
+	class socket;
+
+	class socket_send_file_operation_impl
+	{
+	public:
+
+		socket_send_file_operation_impl(
+			socket& s,
+			detail::win32::handle_t fileHandle,
+			std::size_t byteCount) noexcept
+			: m_socket(s)
+			, m_fileHandle(fileHandle)
+			, m_byteCount(byteCount)
+		{}
+
+		bool try_start(cppcoro::detail::win32_overlapped_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::win32_overlapped_operation_base& operation) noexcept;
+
+	private:
+
+		socket& m_socket;
+		detail::win32::handle_t m_fileHandle;
+		std::size_t m_byteCount;
+
+	};
+
+	class socket_send_file_operation
+		: public cppcoro::detail::win32_overlapped_operation<socket_send_file_operation>
+	{
+	public:
+
+		socket_send_file_operation(
+			socket& s,
+			detail::win32::handle_t fileHandle,
+			std::uint64_t fileOffset,
+			std::size_t byteCount) noexcept
+			: cppcoro::detail::win32_overlapped_operation<socket_send_file_operation>(fileOffset)
+			, m_impl(s, fileHandle, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::win32_overlapped_operation<socket_send_file_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		socket_send_file_operation_impl m_impl;
+
+	};
+
+	class socket_send_file_operation_cancellable
+		: public cppcoro::detail::win32_overlapped_operation_cancellable<socket_send_file_operation_cancellable>
+	{
+	public:
+
+		socket_send_file_operation_cancellable(
+			socket& s,
+			detail::win32::handle_t fileHandle,
+			std::uint64_t fileOffset,
+			std::size_t byteCount,
+			cancellation_token&& ct) noexcept
+			: cppcoro::detail::win32_overlapped_operation_cancellable<socket_send_file_operation_cancellable>(
+				fileOffset, std::move(ct))
+			, m_impl(s, fileHandle, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::win32_overlapped_operation_cancellable<socket_send_file_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { return m_impl.cancel(*this); }
+
+		socket_send_file_operation_impl m_impl;
+
+	};
+
+}
+
+#elif CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
+# include <cppcoro/detail/linux_async_operation.hpp>
+
+namespace cppcoro::net
+{
+	class socket;
+
+	class socket_send_file_operation_impl
+	{
+	public:
+
+		socket_send_file_operation_impl(
+			socket& s,
+			detail::lnx::fd_t fileHandle,
+			std::uint64_t fileOffset,
+			std::size_t byteCount) noexcept
+			: m_socket(s)
+			, m_source{ fileHandle, fileOffset }
+			, m_byteCount(byteCount)
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+
+	private:
+
+		socket& m_socket;
+		detail::lnx::io_file_range m_source;
+		std::size_t m_byteCount;
+
+	};
+
+	class socket_send_file_operation
+		: public cppcoro::detail::linux_async_operation<socket_send_file_operation>
+	{
+	public:
+
+		socket_send_file_operation(
+			io_service& ioService,
+			socket& s,
+			detail::lnx::fd_t fileHandle,
+			std::uint64_t fileOffset,
+			std::size_t byteCount) noexcept
+			: cppcoro::detail::linux_async_operation<socket_send_file_operation>(ioService)
+			, m_impl(s, fileHandle, fileOffset, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<socket_send_file_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		socket_send_file_operation_impl m_impl;
+
+	};
+
+	class socket_send_file_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<socket_send_file_operation_cancellable>
+	{
+	public:
+
+		socket_send_file_operation_cancellable(
+			io_service& ioService,
+			socket& s,
+			detail::lnx::fd_t fileHandle,
+			std::uint64_t fileOffset,
+			std::size_t byteCount,
+			cancellation_token&& ct) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<socket_send_file_operation_cancellable>(
+				ioService, std::move(ct))
+			, m_impl(s, fileHandle, fileOffset, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<socket_send_file_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { return m_impl.cancel(*this); }
+
+		socket_send_file_operation_impl m_impl;
+
+	};
+
+}
+
+#endif
+
+#endif
@@ -7,13 +7,17 @@
 
 #include <cppcoro/config.hpp>
 #include <cppcoro/cancellation_token.hpp>
+#include <cppcoro/net/buffer.hpp>
 
 #include <cstdint>
+#include <span>
 
 #if CPPCORO_OS_WINNT
 # include <cppcoro/detail/win32.hpp>
 # include <cppcoro/detail/win32_overlapped_operation.hpp>
 
+# include <memory>
+
 namespace cppcoro::net
 {
 	class socket;
@@ -87,8 +91,318 @@ namespace cppcoro::net
 
 	};
 
+	class socket_send_buffers_operation_impl
+	{
+	public:
+
+		/// The maximum number of buffers sent by a single send().
+		///
+		/// Any further buffers are not sent, as if the send were partial.
+		/// A send_all() sends all of its buffers.
+		static constexpr std::size_t max_buffer_count = 16;
+
+		socket_send_buffers_operation_impl(
+			socket& s,
+			std::span<const const_buffer> buffers,
+			bool sendAll) noexcept
+			: m_socket(s)
+			, m_buffers(sendAll || buffers.size() < max_buffer_count ?
+				buffers : buffers.first(max_buffer_count))
+		{}
+
+		bool try_start(cppcoro::detail::win32_overlapped_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::win32_overlapped_operation_base& operation) noexcept;
+
+	private:
+
+		socket& m_socket;
+		std::span<const const_buffer> m_buffers;
+		cppcoro::detail::win32::wsabuf m_wsaBuffers[max_buffer_count];
+
+		// Used instead of m_wsaBuffers by a send_all() of more buffers.
+		std::unique_ptr<cppcoro::detail::win32::wsabuf[]> m_allWsaBuffers;
+
+	};
+
+	class socket_send_buffers_operation
+		: public cppcoro::detail::win32_overlapped_operation<socket_send_buffers_operation>
+	{
+	public:
+
+		// Overlapped sends on stream sockets only complete once all of the
+		// data has been sent, so \p sendAll only lifts the buffer count limit.
+		socket_send_buffers_operation(
+			socket& s,
+			std::span<const const_buffer> buffers,
+			bool sendAll = false) noexcept
+			: m_impl(s, buffers, sendAll)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::win32_overlapped_operation<socket_send_buffers_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		socket_send_buffers_operation_impl m_impl;
+
+	};
+
+	class socket_send_buffers_operation_cancellable
+		: public cppcoro::detail::win32_overlapped_operation_cancellable<socket_send_buffers_operation_cancellable>
+	{
+	public:
+
+		socket_send_buffers_operation_cancellable(
+			socket& s,
+			std::span<const const_buffer> buffers,
+			cancellation_token&& ct,
+			bool sendAll = false) noexcept
+			: cppcoro::detail::win32_overlapped_operation_cancellable<socket_send_buffers_operation_cancellable>(std::move(ct))
+			, m_impl(s, buffers, sendAll)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::win32_overlapped_operation_cancellable<socket_send_buffers_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { return m_impl.cancel(*this); }
+
+		socket_send_buffers_operation_impl m_impl;
+
+	};
+
 }
 
-#endif // CPPCORO_OS_WINNT
+#elif CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
+# include <cppcoro/detail/linux_async_operation.hpp>
+
+# include <atomic>
+
+# include <sys/uio.h>
+
+namespace cppcoro::net
+{
+	class socket;
+
+	class socket_send_operation_impl
+	{
+	public:
+
+		socket_send_operation_impl(
+			socket& s,
+			const void* buffer,
+			std::size_t byteCount) noexcept
+			: m_socket(s)
+			, m_buffer(buffer)
+			, m_byteCount(byteCount)
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+
+	private:
+
+		socket& m_socket;
+		const void* m_buffer;
+		std::size_t m_byteCount;
+
+	};
+
+	class socket_send_operation
+		: public cppcoro::detail::linux_async_operation<socket_send_operation>
+	{
+	public:
+
+		socket_send_operation(
+			io_service& ioService,
+			socket& s,
+			const void* buffer,
+			std::size_t byteCount) noexcept
+			: cppcoro::detail::linux_async_operation<socket_send_operation>(ioService)
+			, m_impl(s, buffer, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<socket_send_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		socket_send_operation_impl m_impl;
+
+	};
+
+	class socket_send_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<socket_send_operation_cancellable>
+	{
+	public:
+
+		socket_send_operation_cancellable(
+			io_service& ioService,
+			socket& s,
+			const void* buffer,
+			std::size_t byteCount,
+			cancellation_token&& ct) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<socket_send_operation_cancellable>(
+				ioService, std::move(ct))
+			, m_impl(s, buffer, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<socket_send_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+
+		socket_send_operation_impl m_impl;
+
+	};
+
+	class socket_send_buffers_operation_impl
+	{
+	public:
+
+		/// The maximum number of buffers sent by a single sendmsg.
+		///
+		/// A send() doesn't send any further buffers, as if the send were
+		/// partial, whereas a send_all() sends them with further sendmsgs.
+		static constexpr std::size_t max_buffer_count = 16;
+
+		socket_send_buffers_operation_impl(
+			socket& s,
+			std::span<const const_buffer> buffers,
+			bool sendAll) noexcept
+			: m_socket(s)
+			, m_buffers(sendAll || buffers.size() < max_buffer_count ?
+				buffers : buffers.first(max_buffer_count))
+			, m_sendAll(sendAll)
+			, m_nextBuffer(0)
+			, m_operation(nullptr)
+			, m_bytesSent(0)
+			, m_isLocked(false)
+			, m_isCancellationRequested(false)
+		{}
+
+		// Only valid before the operation has been started.
+		socket_send_buffers_operation_impl(
+			socket_send_buffers_operation_impl&& other) noexcept
+			: socket_send_buffers_operation_impl(
+				other.m_socket, other.m_buffers, other.m_sendAll)
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+
+	private:
+
+		/// The io_state of each sendmsg made on behalf of a send_all().
+		///
+		/// Its completion is only forwarded to the operation once all of the
+		/// data has been sent, the send has failed or it has been cancelled.
+		struct send_all_state : cppcoro::detail::lnx::io_state
+		{
+			socket_send_buffers_operation_impl* m_impl = nullptr;
+		};
+
+		static void on_send_all_completed(
+			cppcoro::detail::lnx::io_state* ioState,
+			std::int32_t result,
+			std::uint32_t flags) noexcept;
+
+		/// Account for \p result, the result of the last sendmsg, and prepare
+		/// to send the remaining data.
+		///
+		/// \return
+		/// true if there is more data to send, otherwise false, in which
+		/// case \p result holds the result of the operation.
+		bool try_advance(std::int32_t& result) noexcept;
+
+		/// Prepare a sendmsg of as many of the buffers that have not yet been
+		/// sent as fit in m_iovecs.
+		void prepare_message() noexcept;
+
+		void lock() noexcept;
+		void unlock() noexcept;
+
+		socket& m_socket;
+		std::span<const const_buffer> m_buffers;
+		bool m_sendAll;
+
+		// The index of the first buffer that is not in m_iovecs.
+		std::size_t m_nextBuffer;
+		iovec m_iovecs[max_buffer_count];
+
+		// Storage suitable for a msghdr.
+		alignas(void*) std::uint8_t m_messageStorage[7 * sizeof(void*)];
+
+		send_all_state m_sendAllState;
+		cppcoro::detail::linux_async_operation_base* m_operation;
+		std::size_t m_bytesSent;
+
+		// Held while a send_all() is resubmitted or cancelled so that the
+		// final completion can't be forwarded while either is in progress.
+		std::atomic<bool> m_isLocked;
+		bool m_isCancellationRequested;
+
+	};
+
+	class socket_send_buffers_operation
+		: public cppcoro::detail::linux_async_operation<socket_send_buffers_operation>
+	{
+	public:
+
+		socket_send_buffers_operation(
+			io_service& ioService,
+			socket& s,
+			std::span<const const_buffer> buffers,
+			bool sendAll = false) noexcept
+			: cppcoro::detail::linux_async_operation<socket_send_buffers_operation>(ioService)
+			, m_impl(s, buffers, sendAll)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<socket_send_buffers_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		socket_send_buffers_operation_impl m_impl;
+
+	};
+
+	class socket_send_buffers_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<socket_send_buffers_operation_cancellable>
+	{
+	public:
+
+		socket_send_buffers_operation_cancellable(
+			io_service& ioService,
+			socket& s,
+			std::span<const const_buffer> buffers,
+			cancellation_token&& ct,
+			bool sendAll = false) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<socket_send_buffers_operation_cancellable>(
+				ioService, std::move(ct))
+			, m_impl(s, buffers, sendAll)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<socket_send_buffers_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+
+		socket_send_buffers_operation_impl m_impl;
+
+	};
+
+}
+
+#endif
 
 #endif
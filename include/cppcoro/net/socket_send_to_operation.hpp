@@ -95,6 +95,198 @@ namespace cppcoro::net
 
 }
 
-#endif // CPPCORO_OS_WINNT
+#elif CPPCORO_OS_LINUX
+# include <cppcoro/net/datagram_buffer.hpp>
+# include <cppcoro/detail/linux.hpp>
+# include <cppcoro/detail/linux_async_operation.hpp>
+
+# include <span>
+
+# include <sys/uio.h>
+
+namespace cppcoro::net
+{
+	class socket;
+
+	class socket_send_to_operation_impl
+	{
+	public:
+
+		socket_send_to_operation_impl(
+			socket& s,
+			const ip_endpoint& destination,
+			const void* buffer,
+			std::size_t byteCount,
+			std::uint16_t segmentSize) noexcept
+			: m_socket(s)
+			, m_destination(destination)
+			, m_buffer{ const_cast<void*>(buffer), byteCount }
+			, m_segmentSize(segmentSize)
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+
+	private:
+
+		socket& m_socket;
+		ip_endpoint m_destination;
+		iovec m_buffer;
+
+		// If non-zero, the size of the datagrams that the kernel splits the
+		// buffer into (UDP_SEGMENT).
+		std::uint16_t m_segmentSize;
+
+		// Storage suitable for a msghdr.
+		alignas(void*) std::uint8_t m_messageStorage[7 * sizeof(void*)];
+
+		// Storage suitable for either sockaddr_in or sockaddr_in6.
+		alignas(4) std::uint8_t m_destinationSockaddrStorage[28];
+
+		// Storage suitable for a control message holding the segment size.
+		alignas(std::size_t) std::uint8_t m_controlStorage[24];
+
+	};
+
+	class socket_send_to_operation
+		: public cppcoro::detail::linux_async_operation<socket_send_to_operation>
+	{
+	public:
+
+		socket_send_to_operation(
+			io_service& ioService,
+			socket& s,
+			const ip_endpoint& destination,
+			const void* buffer,
+			std::size_t byteCount,
+			std::uint16_t segmentSize = 0) noexcept
+			: cppcoro::detail::linux_async_operation<socket_send_to_operation>(ioService)
+			, m_impl(s, destination, buffer, byteCount, segmentSize)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<socket_send_to_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		socket_send_to_operation_impl m_impl;
+
+	};
+
+	class socket_send_to_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<socket_send_to_operation_cancellable>
+	{
+	public:
+
+		socket_send_to_operation_cancellable(
+			io_service& ioService,
+			socket& s,
+			const ip_endpoint& destination,
+			const void* buffer,
+			std::size_t byteCount,
+			cancellation_token&& ct,
+			std::uint16_t segmentSize = 0) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<socket_send_to_operation_cancellable>(
+				ioService, std::move(ct))
+			, m_impl(s, destination, buffer, byteCount, segmentSize)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<socket_send_to_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+
+		socket_send_to_operation_impl m_impl;
+
+	};
+
+	class socket_send_to_batch_operation_impl
+	{
+	public:
+
+		/// The maximum number of datagrams sent by a single operation.
+		static constexpr std::size_t max_batch_size = 32;
+
+		socket_send_to_batch_operation_impl(
+			socket& s,
+			std::span<const datagram_buffer> datagrams) noexcept
+			: m_socket(s)
+			, m_datagrams(datagrams.first(
+				datagrams.size() < max_batch_size ? datagrams.size() : max_batch_size))
+		{}
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+
+	private:
+
+		socket& m_socket;
+		std::span<const datagram_buffer> m_datagrams;
+
+		iovec m_buffers[max_batch_size];
+
+		// Storage suitable for an array of mmsghdr.
+		alignas(void*) std::uint8_t m_messageStorage[max_batch_size][8 * sizeof(void*)];
+
+		// Storage suitable for either sockaddr_in or sockaddr_in6.
+		alignas(4) std::uint8_t m_destinationSockaddrStorage[max_batch_size][28];
+
+	};
+
+	class socket_send_to_batch_operation
+		: public cppcoro::detail::linux_async_operation<socket_send_to_batch_operation>
+	{
+	public:
+
+		socket_send_to_batch_operation(
+			io_service& ioService,
+			socket& s,
+			std::span<const datagram_buffer> datagrams) noexcept
+			: cppcoro::detail::linux_async_operation<socket_send_to_batch_operation>(ioService)
+			, m_impl(s, datagrams)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<socket_send_to_batch_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+
+		socket_send_to_batch_operation_impl m_impl;
+
+	};
+
+	class socket_send_to_batch_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<socket_send_to_batch_operation_cancellable>
+	{
+	public:
+
+		socket_send_to_batch_operation_cancellable(
+			io_service& ioService,
+			socket& s,
+			std::span<const datagram_buffer> datagrams,
+			cancellation_token&& ct) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<socket_send_to_batch_operation_cancellable>(
+				ioService, std::move(ct))
+			, m_impl(s, datagrams)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<socket_send_to_batch_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+
+		socket_send_to_batch_operation_impl m_impl;
+
+	};
+
+}
+
+#endif
 
 #endif
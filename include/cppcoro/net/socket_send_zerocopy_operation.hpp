@@ -0,0 +1,195 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_NET_SOCKET_SEND_ZEROCOPY_OPERATION_HPP_INCLUDED
+#define CPPCORO_NET_SOCKET_SEND_ZEROCOPY_OPERATION_HPP_INCLUDED
+
+#include <cppcoro/config.hpp>
+#include <cppcoro/cancellation_token.hpp>
+
+#if CPPCORO_OS_LINUX
+# include <cppcoro/detail/linux.hpp>
+# include <cppcoro/detail/linux_async_operation.hpp>
+
+# include <coroutine>
+# include <cstddef>
+# include <utility>
+
+namespace cppcoro::net
+{
+	class socket;
+	class socket_send_zerocopy_operation_impl;
+	class zerocopy_send_state;
+
+	/// \brief
+	/// The result of a socket::send_zerocopy() operation, once its data has
+	/// been queued for sending.
+	///
+	/// The kernel may still be reading the data from the buffer at this
+	/// point, so the buffer must not be modified or freed until
+	/// buffer_released() completes. This is the case even if the result
+	/// is destroyed first.
+	class zerocopy_send
+	{
+	public:
+
+		class buffer_released_operation;
+
+		zerocopy_send(zerocopy_send&& other) noexcept
+			: m_state(std::exchange(other.m_state, nullptr))
+			, m_bytesSent(other.m_bytesSent)
+		{}
+
+		zerocopy_send& operator=(zerocopy_send&& other) noexcept;
+
+		zerocopy_send(const zerocopy_send&) = delete;
+		zerocopy_send& operator=(const zerocopy_send&) = delete;
+
+		~zerocopy_send();
+
+		/// The number of bytes sent, which may be less than requested, as
+		/// for socket::send().
+		std::size_t bytes_sent() const noexcept { return m_bytesSent; }
+
+		/// Query whether the kernel has finished with the buffer.
+		bool is_buffer_released() const noexcept;
+
+		/// Wait for the kernel to finish with the buffer.
+		///
+		/// \return
+		/// An awaitable that completes once the buffer may be modified or
+		/// freed. The result of the co_await expression has type 'void'.
+		[[nodiscard]]
+		buffer_released_operation buffer_released() noexcept;
+
+	private:
+
+		friend class socket_send_zerocopy_operation_impl;
+
+		zerocopy_send(zerocopy_send_state* state, std::size_t bytesSent) noexcept
+			: m_state(state)
+			, m_bytesSent(bytesSent)
+		{}
+
+		zerocopy_send_state* m_state;
+		std::size_t m_bytesSent;
+
+	};
+
+	class zerocopy_send::buffer_released_operation
+	{
+	public:
+
+		explicit buffer_released_operation(zerocopy_send_state* state) noexcept
+			: m_state(state)
+		{}
+
+		bool await_ready() const noexcept;
+		bool await_suspend(std::coroutine_handle<> awaitingCoroutine) noexcept;
+		void await_resume() const noexcept {}
+
+	private:
+
+		zerocopy_send_state* m_state;
+
+	};
+
+	class socket_send_zerocopy_operation_impl
+	{
+	public:
+
+		socket_send_zerocopy_operation_impl(
+			socket& s,
+			const void* buffer,
+			std::size_t byteCount) noexcept
+			: m_socket(s)
+			, m_buffer(buffer)
+			, m_byteCount(byteCount)
+			, m_state(nullptr)
+		{}
+
+		socket_send_zerocopy_operation_impl(
+			socket_send_zerocopy_operation_impl&& other) noexcept
+			: m_socket(other.m_socket)
+			, m_buffer(other.m_buffer)
+			, m_byteCount(other.m_byteCount)
+			, m_state(std::exchange(other.m_state, nullptr))
+		{}
+
+		~socket_send_zerocopy_operation_impl();
+
+		bool try_start(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		void cancel(cppcoro::detail::linux_async_operation_base& operation) noexcept;
+		zerocopy_send get_result(cppcoro::detail::linux_async_operation_base& operation);
+
+	private:
+
+		socket& m_socket;
+		const void* m_buffer;
+		std::size_t m_byteCount;
+
+		// Tracks the send until the kernel has finished with the buffer,
+		// which may be after this operation has been destroyed.
+		zerocopy_send_state* m_state;
+
+	};
+
+	class socket_send_zerocopy_operation
+		: public cppcoro::detail::linux_async_operation<socket_send_zerocopy_operation>
+	{
+	public:
+
+		socket_send_zerocopy_operation(
+			io_service& ioService,
+			socket& s,
+			const void* buffer,
+			std::size_t byteCount) noexcept
+			: cppcoro::detail::linux_async_operation<socket_send_zerocopy_operation>(ioService)
+			, m_impl(s, buffer, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation<socket_send_zerocopy_operation>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		decltype(auto) get_result() { return m_impl.get_result(*this); }
+
+		socket_send_zerocopy_operation_impl m_impl;
+
+	};
+
+	class socket_send_zerocopy_operation_cancellable
+		: public cppcoro::detail::linux_async_operation_cancellable<socket_send_zerocopy_operation_cancellable>
+	{
+	public:
+
+		socket_send_zerocopy_operation_cancellable(
+			io_service& ioService,
+			socket& s,
+			const void* buffer,
+			std::size_t byteCount,
+			cancellation_token&& ct) noexcept
+			: cppcoro::detail::linux_async_operation_cancellable<socket_send_zerocopy_operation_cancellable>(
+				ioService, std::move(ct))
+			, m_impl(s, buffer, byteCount)
+		{}
+
+	private:
+
+		friend class cppcoro::detail::linux_async_operation_cancellable<socket_send_zerocopy_operation_cancellable>;
+
+		bool try_start() noexcept { return m_impl.try_start(*this); }
+		void cancel() noexcept { m_impl.cancel(*this); }
+		decltype(auto) get_result() { return m_impl.get_result(*this); }
+
+		socket_send_zerocopy_operation_impl m_impl;
+
+	};
+
+}
+
+#endif
+
+#endif
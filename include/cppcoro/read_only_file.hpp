@@ -8,6 +8,7 @@
 #include <cppcoro/readable_file.hpp>
 #include <cppcoro/file_share_mode.hpp>
 #include <cppcoro/file_buffering_mode.hpp>
+#include <cppcoro/mapped_file.hpp>
 
 #include <filesystem>
 
@@ -43,12 +44,40 @@ namespace cppcoro
 		[[nodiscard]]
 		static read_only_file open(
 			io_service& ioService,
-			const std::experimental::filesystem::path& path,
+			const std::filesystem::path& path,
 			file_share_mode shareMode = file_share_mode::read,
 			file_buffering_mode bufferingMode = file_buffering_mode::default_);
 
+#if CPPCORO_OS_LINUX
+		/// Map the whole file into memory for reading.
+		///
+		/// \throw std::system_error
+		/// If the file could not be mapped.
+		[[nodiscard]]
+		mapped_file map() const;
+
+		/// Map part of the file into memory for reading.
+		///
+		/// \param offset
+		/// The offset within the file of the start of the region to map.
+		/// This need not be a multiple of the page size.
+		///
+		/// \param length
+		/// The number of bytes to map.
+		///
+		/// \throw std::system_error
+		/// If the file could not be mapped.
+		[[nodiscard]]
+		mapped_file map(std::uint64_t offset, std::size_t length) const;
+#endif
+
 	protected:
 
+#if CPPCORO_OS_WINNT
+		read_only_file(detail::win32::safe_handle&& fileHandle) noexcept;
+#elif CPPCORO_OS_LINUX
+		read_only_file(detail::lnx::safe_file_descriptor&& fileHandle, io_service& ioService) noexcept;
+#endif
 
 	};
 }
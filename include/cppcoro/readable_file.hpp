@@ -7,10 +7,13 @@
 
 #include <cppcoro/file.hpp>
 #include <cppcoro/file_read_operation.hpp>
+#include <cppcoro/file_copy_operation.hpp>
 #include <cppcoro/cancellation_token.hpp>
 
 namespace cppcoro
 {
+	class writable_file;
+
 	class readable_file : virtual public file
 	{
 	public:
@@ -55,6 +58,85 @@ namespace cppcoro
 			std::size_t byteCount,
 			cancellation_token ct) const noexcept;
 
+#if CPPCORO_OS_LINUX
+		/// Read some data from the file into several buffers.
+		///
+		/// Reads from the file starting at \a offset, filling each of the
+		/// \a buffers in turn, as a single operation (like preadv()).
+		///
+		/// \param offset
+		/// The offset within the file to start reading from.
+		///
+		/// \param buffers
+		/// The buffers to read the file contents into. The array of iovec
+		/// structures and the buffers they describe must remain valid until
+		/// the operation completes.
+		///
+		/// \param ct
+		/// An optional cancellation_token that can be used to cancel the
+		/// read operation before it completes.
+		///
+		/// \return
+		/// An object that represents the read-operation.
+		/// This object must be co_await'ed to start the read operation.
+		/// The result is the total number of bytes read.
+		[[nodiscard]]
+		file_readv_operation read(
+			std::uint64_t offset,
+			std::span<iovec> buffers) const noexcept;
+		[[nodiscard]]
+		file_readv_operation_cancellable read(
+			std::uint64_t offset,
+			std::span<iovec> buffers,
+			cancellation_token ct) const noexcept;
+
+		/// Copy some data from this file to another file, like
+		/// copy_file_range().
+		///
+		/// The data is copied within the kernel without passing through user
+		/// space and, on file systems that support it, the copy may share the
+		/// underlying storage with the source.
+		///
+		/// On Linux the copy is performed synchronously by an I/O thread, so
+		/// at most 1MiB is copied by each operation to avoid holding up other
+		/// events for long. Copy larger amounts with a loop.
+		///
+		/// \param offset
+		/// The offset within this file to start copying from.
+		///
+		/// \param destination
+		/// The file to copy the data to.
+		///
+		/// \param destinationOffset
+		/// The offset within the destination file to start writing to.
+		///
+		/// \param byteCount
+		/// The number of bytes to copy.
+		///
+		/// \param ct
+		/// An optional cancellation_token that can be used to cancel the
+		/// copy operation before it starts.
+		///
+		/// \return
+		/// An object that represents the copy operation.
+		/// This object must be co_await'ed to start the operation.
+		/// The result is the number of bytes copied, which may be less than
+		/// \a byteCount, and is zero if \a offset is at the end of this file.
+		[[nodiscard]]
+		file_copy_operation copy_to(
+			std::uint64_t offset,
+			writable_file& destination,
+			std::uint64_t destinationOffset,
+			std::size_t byteCount) const noexcept;
+		[[nodiscard]]
+		file_copy_operation_cancellable copy_to(
+			std::uint64_t offset,
+			writable_file& destination,
+			std::uint64_t destinationOffset,
+			std::size_t byteCount,
+			cancellation_token ct) const noexcept;
+#endif
+
 	protected:
 
 		using file::file;
@@ -10,7 +10,6 @@
 #include <memory>
 #include <thread>
 #include <vector>
-#include <mutex>
 #include <experimental/coroutine>
 
 namespace cppcoro
@@ -77,9 +76,21 @@ namespace cppcoro
 		void notify_intent_to_sleep(std::uint32_t threadIndex) noexcept;
 		void try_clear_intent_to_sleep(std::uint32_t threadIndex) noexcept;
 
-		schedule_operation* try_global_dequeue() noexcept;
+		/// Try to take an operation from one of the global queues.
+		///
+		/// Any other operations taken from the same queue are moved to the
+		/// local queue of the thread with index \p thisThreadIndex.
+		///
+		/// \return
+		/// A pointer to the operation that was dequeued, or nullptr if all of
+		/// the global queues were empty.
+		schedule_operation* try_global_dequeue(std::uint32_t thisThreadIndex) noexcept;
 
-		/// Try to steal a task from another thread.
+		/// Try to steal tasks from another thread, first from the other
+		/// threads' local queues and then from their overflow queues.
+		///
+		/// Up to half of the tasks in the chosen thread's local queue are
+		/// stolen at once. All but one are moved to this thread's local queue.
 		///
 		/// \return
 		/// A pointer to the operation that was stolen if one could be stolen
@@ -90,6 +101,7 @@ namespace cppcoro
 		void wake_one_thread() noexcept;
 
 		class thread_state;
+		class lock_free_queue;
 
 		static thread_local thread_state* s_currentState;
 		static thread_local static_thread_pool* s_currentThreadPool;
@@ -101,11 +113,9 @@ namespace cppcoro
 
 		std::atomic<bool> m_stopRequested;
 
-		std::mutex m_globalQueueMutex;
-		std::atomic<schedule_operation*> m_globalQueueHead;
-
-		//alignas(std::hardware_destructive_interference_size)
-		std::atomic<schedule_operation*> m_globalQueueTail;
+		// Operations scheduled from outside of the pool's threads, sharded
+		// into one queue per thread to spread contention between producers.
+		const std::unique_ptr<lock_free_queue[]> m_globalQueues;
 
 		//alignas(std::hardware_destructive_interference_size)
 		std::atomic<std::uint32_t> m_sleepingThreadCount;
@@ -7,6 +7,7 @@
 
 #include <cppcoro/file.hpp>
 #include <cppcoro/file_write_operation.hpp>
+#include <cppcoro/file_sync_operation.hpp>
 #include <cppcoro/cancellation_token.hpp>
 
 namespace cppcoro
@@ -61,6 +62,86 @@ namespace cppcoro
 			std::size_t byteCount,
 			cancellation_token ct) noexcept;
 
+#if CPPCORO_OS_LINUX
+		/// Write some data to the file from several buffers.
+		///
+		/// Writes the contents of each of the \a buffers in turn to the file
+		/// starting at \a offset as a single operation (like pwritev()).
+		///
+		/// \param offset
+		/// The offset within the file to start writing from.
+		///
+		/// \param buffers
+		/// The buffers containing the data to be written to the file. The
+		/// array of iovec structures and the buffers they describe must
+		/// remain valid until the operation completes.
+		///
+		/// \param ct
+		/// An optional cancellation_token that can be used to cancel the
+		/// write operation before it completes.
+		///
+		/// \return
+		/// An object that represents the write operation.
+		/// This object must be co_await'ed to start the write operation.
+		/// The result is the total number of bytes written.
+		[[nodiscard]]
+		file_writev_operation write(
+			std::uint64_t offset,
+			std::span<const iovec> buffers) noexcept;
+		[[nodiscard]]
+		file_writev_operation_cancellable write(
+			std::uint64_t offset,
+			std::span<const iovec> buffers,
+			cancellation_token ct) noexcept;
+
+		/// Flush the file's data and metadata to storage, like fsync().
+		///
+		/// \return
+		/// An object that represents the flush operation.
+		/// This object must be co_await'ed to start the operation.
+		[[nodiscard]]
+		file_sync_operation flush() noexcept;
+		[[nodiscard]]
+		file_sync_operation_cancellable flush(cancellation_token ct) noexcept;
+
+		/// Flush the file's data to storage, along with only the metadata
+		/// needed to read it back (eg. the file size), like fdatasync().
+		[[nodiscard]]
+		file_sync_operation flush_data() noexcept;
+		[[nodiscard]]
+		file_sync_operation_cancellable flush_data(cancellation_token ct) noexcept;
+
+		/// Allocate storage for the specified range of the file, like
+		/// fallocate(), extending the size of the file if necessary.
+		///
+		/// Writing into preallocated storage avoids having to allocate
+		/// blocks, and update the file's metadata, on each write.
+		[[nodiscard]]
+		file_sync_operation preallocate(
+			std::uint64_t offset,
+			std::uint64_t length) noexcept;
+		[[nodiscard]]
+		file_sync_operation_cancellable preallocate(
+			std::uint64_t offset,
+			std::uint64_t length,
+			cancellation_token ct) noexcept;
+
+		/// Write back the dirty pages in the specified range of the file and
+		/// wait for the write-back to complete, like sync_file_range().
+		///
+		/// Unlike flush_data() this neither writes back metadata nor flushes
+		/// the disk's write cache, so it does not guarantee durability.
+		[[nodiscard]]
+		file_sync_operation sync_range(
+			std::uint64_t offset,
+			std::uint64_t length) noexcept;
+		[[nodiscard]]
+		file_sync_operation_cancellable sync_range(
+			std::uint64_t offset,
+			std::uint64_t length,
+			cancellation_token ct) noexcept;
+#endif
+
 	protected:
 
 		using file::file;
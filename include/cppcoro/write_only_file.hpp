@@ -10,7 +10,7 @@
 #include <cppcoro/file_buffering_mode.hpp>
 #include <cppcoro/file_open_mode.hpp>
 
-#include <experimental/filesystem>
+#include <filesystem>
 
 namespace cppcoro
 {
@@ -48,7 +48,7 @@ namespace cppcoro
 		[[nodiscard]]
 		static write_only_file open(
 			io_service& ioService,
-			const std::experimental::filesystem::path& path,
+			const std::filesystem::path& path,
 			file_open_mode openMode = file_open_mode::create_or_open,
 			file_share_mode shareMode = file_share_mode::none,
 			file_buffering_mode bufferingMode = file_buffering_mode::default_);
@@ -57,6 +57,8 @@ namespace cppcoro
 
 #if CPPCORO_OS_WINNT
 		write_only_file(detail::win32::safe_handle&& fileHandle) noexcept;
+#elif CPPCORO_OS_LINUX
+		write_only_file(detail::lnx::safe_file_descriptor&& fileHandle, io_service& ioService) noexcept;
 #endif
 
 	};
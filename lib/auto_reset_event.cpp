@@ -9,6 +9,11 @@
 # define WIN32_LEAN_AND_MEAN
 # include <Windows.h>
 # include <system_error>
+#elif CPPCORO_OS_LINUX
+# include "futex.hpp"
+
+# include <cerrno>
+# include <system_error>
 #endif
 
 namespace cppcoro
@@ -64,6 +69,73 @@ namespace cppcoro
 		}
 	}
 
+#elif CPPCORO_OS_LINUX
+
+	auto_reset_event::auto_reset_event(bool initiallySet)
+		: m_value(initiallySet ? 1 : 0)
+	{}
+
+	auto_reset_event::~auto_reset_event()
+	{}
+
+	void auto_reset_event::set()
+	{
+		// Only make the system call if a thread may be waiting.
+		if (m_value.exchange(1, std::memory_order_release) == 2)
+		{
+			if (cppcoro::detail::lnx::futex_wake(m_value, 1) == -1)
+			{
+				throw std::system_error
+				{
+					errno,
+					std::system_category(),
+					"auto_reset_event: futex wake failed"
+				};
+			}
+		}
+	}
+
+	void auto_reset_event::wait()
+	{
+		int oldValue = 1;
+		if (m_value.compare_exchange_strong(
+			oldValue, 0, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		while (true)
+		{
+			if (oldValue == 1)
+			{
+				// Other threads may still be blocked waiting, so leave the
+				// event marked as such when consuming the signal so that the
+				// next call to set() wakes one of them.
+				if (m_value.compare_exchange_weak(
+					oldValue, 2, std::memory_order_acquire, std::memory_order_relaxed))
+				{
+					return;
+				}
+			}
+			else if (oldValue == 2 || m_value.compare_exchange_weak(
+				oldValue, 2, std::memory_order_relaxed, std::memory_order_relaxed))
+			{
+				if (cppcoro::detail::lnx::futex_wait(m_value, 2) == -1 &&
+					errno != EAGAIN && errno != EINTR)
+				{
+					throw std::system_error
+					{
+						errno,
+						std::system_category(),
+						"auto_reset_event: futex wait failed"
+					};
+				}
+
+				oldValue = m_value.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
 #else
 
 	auto_reset_event::auto_reset_event(bool initiallySet)
@@ -9,6 +9,8 @@
 
 #if CPPCORO_OS_WINNT
 # include <cppcoro/detail/win32.hpp>
+#elif CPPCORO_OS_LINUX
+# include <atomic>
 #else
 # include <mutex>
 # include <condition_variable>
@@ -32,6 +34,10 @@ namespace cppcoro
 
 #if CPPCORO_OS_WINNT
 		cppcoro::detail::win32::safe_handle m_event;
+#elif CPPCORO_OS_LINUX
+		// 0 if not set, 1 if set, or 2 if not set and threads may be
+		// blocked waiting on the futex.
+		std::atomic<int> m_value;
 #else
 		std::mutex m_mutex;
 		std::condition_variable m_cv;
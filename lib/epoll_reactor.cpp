@@ -0,0 +1,976 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "epoll_reactor.hpp"
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <system_error>
+
+#include <fcntl.h>
+#include <linux/errqueue.h>
+#include <linux/io_uring.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace
+{
+	namespace local
+	{
+		using cppcoro::detail::lnx::io_state;
+		using cppcoro::detail::lnx::io_opcode;
+
+		// Allow many more completions to be queued than the nominal number of
+		// entries, to match the completion queue sizing of io_uring.
+		constexpr std::uint32_t completion_queue_size_multiplier = 8;
+
+		// An io_state offset of this value means "use the current file position"
+		// as it does for io_uring.
+		constexpr std::uint64_t current_position = std::numeric_limits<std::uint64_t>::max();
+
+		// Posted completions whose user-data is the address of an io_state
+		// tagged with this value are for operations that are performed by
+		// the thread that dequeues them. io_states are at least 8-byte
+		// aligned and the io_service never posts user-data with this bit set.
+		constexpr std::uint64_t deferred_operation_tag = 4;
+
+		std::uint32_t round_up_to_power_of_two(std::uint32_t value) noexcept
+		{
+			std::uint32_t result = 1;
+			while (result < value)
+			{
+				result <<= 1;
+			}
+			return result;
+		}
+
+		cppcoro::detail::lnx::safe_file_descriptor check_fd(int fd, const char* what)
+		{
+			if (fd == -1)
+			{
+				throw std::system_error
+				{
+					errno,
+					std::system_category(),
+					what
+				};
+			}
+
+			return cppcoro::detail::lnx::safe_file_descriptor{ fd };
+		}
+
+		/// Attempt to perform the operation without blocking.
+		///
+		/// \param flags
+		/// Receives the completion flags, eg. identifying the buffer picked
+		/// by a recv_select_buffer operation.
+		///
+		/// \return
+		/// false if the operation would block, otherwise true and \p result
+		/// holds the result of the operation.
+		bool try_perform(io_state& state, std::int32_t& result, std::uint32_t& flags) noexcept
+		{
+			flags = 0;
+
+			ssize_t count = 0;
+			do
+			{
+				switch (state.m_opcode)
+				{
+				case io_opcode::nop:
+					count = 0;
+					break;
+				case io_opcode::read:
+					if (state.m_offset != current_position)
+					{
+						count = ::pread(
+							state.m_fd,
+							state.m_buffer,
+							state.m_length,
+							static_cast<off_t>(state.m_offset));
+						if (count != -1 || errno != ESPIPE)
+						{
+							break;
+						}
+
+						// Not seekable (eg. a pipe or socket). io_uring ignores
+						// the offset in this case so we do too.
+					}
+					count = ::read(state.m_fd, state.m_buffer, state.m_length);
+					break;
+				case io_opcode::write:
+					if (state.m_offset != current_position)
+					{
+						count = ::pwrite(
+							state.m_fd,
+							state.m_buffer,
+							state.m_length,
+							static_cast<off_t>(state.m_offset));
+						if (count != -1 || errno != ESPIPE)
+						{
+							break;
+						}
+
+						// Not seekable (eg. a pipe or socket). io_uring ignores
+						// the offset in this case so we do too.
+					}
+					count = ::write(state.m_fd, state.m_buffer, state.m_length);
+					break;
+				case io_opcode::readv:
+					if (state.m_offset != current_position)
+					{
+						count = ::preadv(
+							state.m_fd,
+							static_cast<const iovec*>(state.m_buffer),
+							static_cast<int>(state.m_length),
+							static_cast<off_t>(state.m_offset));
+						if (count != -1 || errno != ESPIPE)
+						{
+							break;
+						}
+					}
+					count = ::readv(
+						state.m_fd,
+						static_cast<const iovec*>(state.m_buffer),
+						static_cast<int>(state.m_length));
+					break;
+				case io_opcode::writev:
+					if (state.m_offset != current_position)
+					{
+						count = ::pwritev(
+							state.m_fd,
+							static_cast<const iovec*>(state.m_buffer),
+							static_cast<int>(state.m_length),
+							static_cast<off_t>(state.m_offset));
+						if (count != -1 || errno != ESPIPE)
+						{
+							break;
+						}
+					}
+					count = ::writev(
+						state.m_fd,
+						static_cast<const iovec*>(state.m_buffer),
+						static_cast<int>(state.m_length));
+					break;
+				case io_opcode::fsync:
+					count = (state.m_flags & IORING_FSYNC_DATASYNC) != 0 ?
+						::fdatasync(state.m_fd) : ::fsync(state.m_fd);
+					break;
+				case io_opcode::fallocate:
+					count = ::fallocate(
+						state.m_fd,
+						static_cast<int>(state.m_flags),
+						static_cast<off_t>(state.m_offset),
+						static_cast<off_t>(state.m_length));
+					break;
+				case io_opcode::sync_file_range:
+					count = ::sync_file_range(
+						state.m_fd,
+						static_cast<off_t>(state.m_offset),
+						static_cast<off_t>(state.m_length),
+						state.m_flags);
+					break;
+				case io_opcode::copy_file_range:
+					result = perform_copy_file_range(state);
+					return true;
+				case io_opcode::send:
+					count = ::send(
+						state.m_fd,
+						state.m_buffer,
+						state.m_length,
+						static_cast<int>(state.m_flags));
+					break;
+				case io_opcode::recv:
+					count = ::recv(
+						state.m_fd,
+						state.m_buffer,
+						state.m_length,
+						static_cast<int>(state.m_flags));
+					break;
+				case io_opcode::send_zerocopy:
+					count = ::send(
+						state.m_fd,
+						state.m_buffer,
+						state.m_length,
+						static_cast<int>(state.m_flags) | MSG_ZEROCOPY);
+					if (count == -1 && errno == ENOBUFS)
+					{
+						// Too many zero-copy sends are outstanding on the
+						// socket. Copy the data instead.
+						count = ::send(
+							state.m_fd,
+							state.m_buffer,
+							state.m_length,
+							static_cast<int>(state.m_flags));
+					}
+					else if (count > 0)
+					{
+						// The kernel will notify us once it has finished with
+						// the buffer. See process_zerocopy_notifications().
+						flags = IORING_CQE_F_MORE;
+					}
+					break;
+				case io_opcode::sendmsg:
+					count = ::sendmsg(
+						state.m_fd,
+						static_cast<const msghdr*>(state.m_buffer),
+						static_cast<int>(state.m_flags));
+					break;
+				case io_opcode::recvmsg:
+					count = ::recvmsg(
+						state.m_fd,
+						static_cast<msghdr*>(state.m_buffer),
+						static_cast<int>(state.m_flags));
+					break;
+				case io_opcode::accept:
+				case io_opcode::accept_multishot:
+					count = ::accept4(
+						state.m_fd,
+						nullptr,
+						nullptr,
+						static_cast<int>(state.m_flags));
+					break;
+				case io_opcode::connect:
+					count = ::connect(
+						state.m_fd,
+						static_cast<const sockaddr*>(state.m_buffer),
+						static_cast<socklen_t>(state.m_length));
+					if (count == -1)
+					{
+						if (errno == EINPROGRESS || errno == EALREADY)
+						{
+							// Wait for the socket to become writable, at which
+							// point calling connect() again reports the outcome.
+							return false;
+						}
+
+						if (errno == EISCONN)
+						{
+							count = 0;
+						}
+					}
+					break;
+				case io_opcode::sendfile:
+					result = perform_sendfile(state);
+					return result != -EAGAIN;
+				case io_opcode::sendmmsg:
+				case io_opcode::recvmmsg:
+					result = perform_message_batch(state);
+					return result != -EAGAIN;
+				case io_opcode::recv_select_buffer:
+					result = perform_recv_select_buffer(state, flags);
+					return result != -EAGAIN;
+				}
+			} while (count == -1 && errno == EINTR);
+
+			if (count == -1)
+			{
+				if (errno == EAGAIN || errno == EWOULDBLOCK)
+				{
+					return false;
+				}
+
+				result = -errno;
+				return true;
+			}
+
+			result = static_cast<std::int32_t>(count);
+			return true;
+		}
+
+		/// Query whether the operation needs to wait for its file descriptor
+		/// to become ready. Other operations are performed synchronously.
+		bool waits_for_readiness(const io_state& state) noexcept
+		{
+			switch (state.m_opcode)
+			{
+			case io_opcode::read:
+			case io_opcode::write:
+			case io_opcode::readv:
+			case io_opcode::writev:
+			case io_opcode::send:
+			case io_opcode::recv:
+			case io_opcode::sendmsg:
+			case io_opcode::recvmsg:
+			case io_opcode::sendmmsg:
+			case io_opcode::recvmmsg:
+			case io_opcode::recv_select_buffer:
+			case io_opcode::accept:
+			case io_opcode::accept_multishot:
+			case io_opcode::connect:
+			case io_opcode::sendfile:
+			case io_opcode::send_zerocopy:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		/// Query whether the operation waits for its file descriptor to become
+		/// readable, as opposed to writable.
+		bool is_read_operation(const io_state& state) noexcept
+		{
+			switch (state.m_opcode)
+			{
+			case io_opcode::read:
+			case io_opcode::readv:
+			case io_opcode::recv:
+			case io_opcode::recvmsg:
+			case io_opcode::recvmmsg:
+			case io_opcode::recv_select_buffer:
+			case io_opcode::accept:
+			case io_opcode::accept_multishot:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		void push_back(io_state*& head, io_state*& tail, io_state* state) noexcept
+		{
+			state->m_next = nullptr;
+			if (tail == nullptr)
+			{
+				head = state;
+			}
+			else
+			{
+				tail->m_next = state;
+			}
+			tail = state;
+		}
+
+		io_state* pop_front(io_state*& head, io_state*& tail) noexcept
+		{
+			io_state* state = head;
+			head = state->m_next;
+			if (head == nullptr)
+			{
+				tail = nullptr;
+			}
+			return state;
+		}
+
+		bool remove(io_state*& head, io_state*& tail, io_state* state) noexcept
+		{
+			io_state* previous = nullptr;
+			for (io_state* current = head; current != nullptr; current = current->m_next)
+			{
+				if (current == state)
+				{
+					(previous == nullptr ? head : previous->m_next) = current->m_next;
+					if (tail == current)
+					{
+						tail = previous;
+					}
+					return true;
+				}
+				previous = current;
+			}
+			return false;
+		}
+	}
+}
+
+cppcoro::detail::lnx::epoll_reactor::descriptor_state::descriptor_state(fd_t fd) noexcept
+	: m_fd(fd)
+	, m_isRegistered(false)
+	, m_readersHead(nullptr)
+	, m_readersTail(nullptr)
+	, m_writersHead(nullptr)
+	, m_writersTail(nullptr)
+	, m_zerocopySupport(zerocopy_support::unknown)
+	, m_zerocopyHead(nullptr)
+	, m_zerocopyTail(nullptr)
+	, m_releasedHead(nullptr)
+	, m_releasedTail(nullptr)
+	, m_nextZerocopyId(0)
+{}
+
+cppcoro::detail::lnx::epoll_reactor::epoll_reactor(std::uint32_t entries)
+	: m_epollFd(local::check_fd(
+		::epoll_create1(EPOLL_CLOEXEC),
+		"Error creating io_service: epoll_create1"))
+	, m_wakeUpFd(local::check_fd(
+		::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC),
+		"Error creating io_service: eventfd"))
+	, m_waitingThreadCount(0)
+	, m_completionMask(local::round_up_to_power_of_two(
+		entries * local::completion_queue_size_multiplier) - 1)
+	, m_completionHead(0)
+	, m_completionTail(0)
+{
+	m_completions = std::make_unique<completion[]>(m_completionMask + 1);
+
+	// The wake-up eventfd is registered level-triggered with null user-data
+	// so that it stays signalled until some thread resets it.
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.ptr = nullptr;
+	if (::epoll_ctl(m_epollFd.fd(), EPOLL_CTL_ADD, m_wakeUpFd.fd(), &event) == -1)
+	{
+		throw std::system_error
+		{
+			errno,
+			std::system_category(),
+			"Error creating io_service: epoll_ctl"
+		};
+	}
+}
+
+cppcoro::detail::lnx::epoll_reactor::~epoll_reactor()
+{
+}
+
+cppcoro::io_service_backend
+cppcoro::detail::lnx::epoll_reactor::backend() const noexcept
+{
+	return io_service_backend::epoll;
+}
+
+bool cppcoro::detail::lnx::epoll_reactor::try_post(std::uint64_t userData) noexcept
+{
+	return try_push_completion(completion{ userData, 0, 0 });
+}
+
+bool cppcoro::detail::lnx::epoll_reactor::try_start(
+	io_state& state, std::int32_t& result) noexcept
+{
+	if (state.m_opcode == io_opcode::copy_file_range)
+	{
+		// This can't be waited for either, but it may take a while, so have
+		// an I/O thread perform it rather than blocking the awaiting thread.
+		// See try_pop_completion().
+		const completion deferred{
+			reinterpret_cast<std::uintptr_t>(&state) | local::deferred_operation_tag,
+			0,
+			0
+		};
+		if (try_push_completion(deferred))
+		{
+			return true;
+		}
+
+		// The completion queue is full. Perform it now instead.
+	}
+
+	if (!local::waits_for_readiness(state))
+	{
+		// Eg. fsync() which can't be waited for with epoll.
+		std::uint32_t flags;
+		if (!local::try_perform(state, result, flags))
+		{
+			result = -EAGAIN;
+		}
+
+		return false;
+	}
+
+	auto* descriptor = get_descriptor_state(state.m_fd);
+	if (descriptor == nullptr)
+	{
+		result = -ENOMEM;
+		return false;
+	}
+
+	std::lock_guard lock{ descriptor->m_mutex };
+
+	const bool isRead = local::is_read_operation(state);
+	auto& head = isRead ? descriptor->m_readersHead : descriptor->m_writersHead;
+	auto& tail = isRead ? descriptor->m_readersTail : descriptor->m_writersTail;
+
+	local::push_back(head, tail, &state);
+
+	const int errorCode = update_registration(*descriptor);
+	if (errorCode != 0)
+	{
+		local::remove(head, tail, &state);
+
+		if (errorCode == EPERM)
+		{
+			// The file descriptor doesn't support readiness notification.
+			// This is the case for regular files and directories, for which
+			// reads and writes never wait for an event, so just perform the
+			// operation synchronously.
+			std::uint32_t flags;
+			if (!local::try_perform(state, result, flags))
+			{
+				result = -EAGAIN;
+			}
+		}
+		else
+		{
+			result = -errorCode;
+		}
+
+		return false;
+	}
+
+	// Check for zero-copy support only after update_registration(), which
+	// forgets it if the descriptor number has been reused for another socket.
+	// The operation can't be performed until we release the descriptor's mutex.
+	if (state.m_opcode == io_opcode::send_zerocopy &&
+		!try_enable_zerocopy(*descriptor))
+	{
+		// Fall back to a copying send, which completes only once.
+		state.m_opcode = io_opcode::send;
+	}
+
+	return true;
+}
+
+void cppcoro::detail::lnx::epoll_reactor::cancel(io_state& state) noexcept
+{
+	auto* descriptor = find_descriptor_state(state.m_fd);
+	if (descriptor == nullptr)
+	{
+		return;
+	}
+
+	std::lock_guard lock{ descriptor->m_mutex };
+
+	const bool isRead = local::is_read_operation(state);
+	auto& head = isRead ? descriptor->m_readersHead : descriptor->m_writersHead;
+	auto& tail = isRead ? descriptor->m_readersTail : descriptor->m_writersTail;
+
+	if (!local::remove(head, tail, &state))
+	{
+		// The operation has already completed.
+		return;
+	}
+
+	const completion cancelled{ reinterpret_cast<std::uintptr_t>(&state), -ECANCELED, 0 };
+	if (!try_push_completion(cancelled))
+	{
+		// The completion queue is full.
+		// Leave the operation queued so that it runs to completion instead.
+		local::push_back(head, tail, &state);
+	}
+
+	(void)update_registration(*descriptor);
+}
+
+bool cppcoro::detail::lnx::epoll_reactor::try_dequeue(
+	completion& result, bool waitForCompletion)
+{
+	while (true)
+	{
+		if (try_pop_completion(result))
+		{
+			return true;
+		}
+
+		int timeout = 0;
+		if (waitForCompletion)
+		{
+			// Register as a waiter before checking the queue one last time so
+			// that a concurrent try_post() either sees us waiting and signals
+			// the eventfd or has already made its completion visible to us.
+			m_waitingThreadCount.fetch_add(1, std::memory_order_seq_cst);
+			if (try_pop_completion(result))
+			{
+				m_waitingThreadCount.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+
+			timeout = -1;
+		}
+
+		epoll_event event;
+		const int count = ::epoll_wait(m_epollFd.fd(), &event, 1, timeout);
+		const int errorCode = errno;
+
+		if (waitForCompletion)
+		{
+			m_waitingThreadCount.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		if (count == -1)
+		{
+			if (errorCode == EINTR)
+			{
+				return false;
+			}
+
+			throw std::system_error
+			{
+				errorCode,
+				std::system_category(),
+				"Error processing events: epoll_wait"
+			};
+		}
+
+		if (count == 0)
+		{
+			return false;
+		}
+
+		if (event.data.ptr == nullptr)
+		{
+			reset_wake_up();
+			continue;
+		}
+
+		auto& descriptor = *static_cast<descriptor_state*>(event.data.ptr);
+		if (try_complete_ready_operation(descriptor, event.events, result))
+		{
+			return true;
+		}
+	}
+}
+
+bool cppcoro::detail::lnx::epoll_reactor::try_push_completion(
+	const completion& value) noexcept
+{
+	{
+		std::lock_guard lock{ m_completionMutex };
+		if (m_completionTail - m_completionHead > m_completionMask)
+		{
+			return false;
+		}
+
+		m_completions[m_completionTail & m_completionMask] = value;
+		++m_completionTail;
+	}
+
+	// Pairs with the increment of m_waitingThreadCount in try_dequeue().
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_waitingThreadCount.load(std::memory_order_relaxed) != 0)
+	{
+		signal_wake_up();
+	}
+
+	return true;
+}
+
+bool cppcoro::detail::lnx::epoll_reactor::try_pop_completion(completion& result) noexcept
+{
+	bool moreAvailable;
+	{
+		std::lock_guard lock{ m_completionMutex };
+		if (m_completionHead == m_completionTail)
+		{
+			return false;
+		}
+
+		result = m_completions[m_completionHead & m_completionMask];
+		++m_completionHead;
+		moreAvailable = m_completionHead != m_completionTail;
+	}
+
+	// The wake-up signal may have been consumed on behalf of several posted
+	// completions. Pass it on so that other waiting threads pick up the rest.
+	if (moreAvailable && m_waitingThreadCount.load(std::memory_order_relaxed) != 0)
+	{
+		signal_wake_up();
+	}
+
+	if ((result.m_userData & local::deferred_operation_tag) != 0)
+	{
+		result.m_userData &= ~local::deferred_operation_tag;
+		result.m_result = perform_copy_file_range(
+			*reinterpret_cast<io_state*>(static_cast<std::uintptr_t>(result.m_userData)));
+	}
+
+	return true;
+}
+
+cppcoro::detail::lnx::epoll_reactor::descriptor_state*
+cppcoro::detail::lnx::epoll_reactor::find_descriptor_state(fd_t fd) noexcept
+{
+	std::lock_guard lock{ m_descriptorMutex };
+	auto iter = m_descriptors.find(fd);
+	return iter != m_descriptors.end() ? iter->second.get() : nullptr;
+}
+
+cppcoro::detail::lnx::epoll_reactor::descriptor_state*
+cppcoro::detail::lnx::epoll_reactor::get_descriptor_state(fd_t fd) noexcept
+{
+	std::lock_guard lock{ m_descriptorMutex };
+	try
+	{
+		auto& descriptor = m_descriptors[fd];
+		if (!descriptor)
+		{
+			descriptor = std::make_unique<descriptor_state>(fd);
+		}
+
+		return descriptor.get();
+	}
+	catch (const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+
+int cppcoro::detail::lnx::epoll_reactor::update_registration(
+	descriptor_state& descriptor) noexcept
+{
+	std::uint32_t events = 0;
+	if (descriptor.m_readersHead != nullptr)
+	{
+		events |= EPOLLIN | EPOLLRDHUP;
+	}
+	if (descriptor.m_writersHead != nullptr || descriptor.m_releasedHead != nullptr)
+	{
+		events |= EPOLLOUT;
+	}
+	if (descriptor.m_zerocopyHead != nullptr)
+	{
+		// Zero-copy notifications are queued to the socket's error queue.
+		events |= EPOLLERR;
+	}
+
+	if (events == 0)
+	{
+		// Nothing is waiting. The one-shot registration is left disarmed.
+		return 0;
+	}
+
+	epoll_event event{};
+	event.events = events | EPOLLONESHOT;
+	event.data.ptr = &descriptor;
+
+	if (descriptor.m_isRegistered)
+	{
+		if (::epoll_ctl(m_epollFd.fd(), EPOLL_CTL_MOD, descriptor.m_fd, &event) == 0)
+		{
+			return 0;
+		}
+
+		if (errno != ENOENT)
+		{
+			return errno;
+		}
+
+		// The file descriptor was closed, which removes it from the epoll
+		// set, and the descriptor number has since been reused.
+		descriptor.m_isRegistered = false;
+		descriptor.m_zerocopySupport = zerocopy_support::unknown;
+		descriptor.m_nextZerocopyId = 0;
+	}
+
+	if (::epoll_ctl(m_epollFd.fd(), EPOLL_CTL_ADD, descriptor.m_fd, &event) == -1)
+	{
+		return errno;
+	}
+
+	descriptor.m_isRegistered = true;
+	return 0;
+}
+
+bool cppcoro::detail::lnx::epoll_reactor::try_complete_ready_operation(
+	descriptor_state& descriptor,
+	std::uint32_t events,
+	completion& result) noexcept
+{
+	std::lock_guard lock{ descriptor.m_mutex };
+
+	if ((events & EPOLLERR) != 0 &&
+		descriptor.m_zerocopySupport == zerocopy_support::enabled)
+	{
+		// Drain the error queue even if no sends are waiting for their
+		// notifications, as it otherwise keeps reporting EPOLLERR.
+		process_zerocopy_notifications(descriptor);
+	}
+
+	io_state* state = nullptr;
+	std::int32_t value = 0;
+	std::uint32_t flags = 0;
+
+	if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0 &&
+		descriptor.m_readersHead != nullptr &&
+		local::try_perform(*descriptor.m_readersHead, value, flags))
+	{
+		if (descriptor.m_readersHead->m_opcode == io_opcode::accept_multishot && value >= 0)
+		{
+			// Leave the operation queued to accept the next connection.
+			// See io_state::m_pendingCallbacks.
+			state = descriptor.m_readersHead;
+			flags = IORING_CQE_F_MORE;
+			__atomic_add_fetch(&state->m_pendingCallbacks, 1, __ATOMIC_RELAXED);
+		}
+		else
+		{
+			state = local::pop_front(descriptor.m_readersHead, descriptor.m_readersTail);
+		}
+	}
+	else if (
+		(events & (EPOLLOUT | EPOLLHUP | EPOLLERR)) != 0 &&
+		descriptor.m_writersHead != nullptr &&
+		local::try_perform(*descriptor.m_writersHead, value, flags))
+	{
+		state = local::pop_front(descriptor.m_writersHead, descriptor.m_writersTail);
+
+		if ((flags & IORING_CQE_F_MORE) != 0)
+		{
+			// A zero-copy send. Hold on to the operation until the kernel
+			// notifies us that it has finished with the buffer.
+			// See io_state::m_pendingCallbacks.
+			state->m_offset = descriptor.m_nextZerocopyId++;
+			local::push_back(descriptor.m_zerocopyHead, descriptor.m_zerocopyTail, state);
+			__atomic_add_fetch(&state->m_pendingCallbacks, 1, __ATOMIC_RELAXED);
+		}
+	}
+
+	// Hand out the final completions of zero-copy sends whose buffers have
+	// been released.
+	while (descriptor.m_releasedHead != nullptr)
+	{
+		if (state == nullptr)
+		{
+			state = local::pop_front(descriptor.m_releasedHead, descriptor.m_releasedTail);
+			value = 0;
+			flags = IORING_CQE_F_NOTIF;
+			continue;
+		}
+
+		const completion released{
+			reinterpret_cast<std::uintptr_t>(descriptor.m_releasedHead),
+			0,
+			IORING_CQE_F_NOTIF
+		};
+		if (!try_push_completion(released))
+		{
+			// The completion queue is full. update_registration() waits for
+			// the socket to become writable so that we try again soon.
+			break;
+		}
+
+		local::pop_front(descriptor.m_releasedHead, descriptor.m_releasedTail);
+	}
+
+	const int errorCode = update_registration(descriptor);
+	if (errorCode != 0)
+	{
+		// We can no longer be notified when the remaining operations are
+		// ready so fail them rather than leaving them queued forever.
+		const auto failAll = [&](io_state*& head, io_state*& tail)
+		{
+			while (head != nullptr)
+			{
+				const completion failed{
+					reinterpret_cast<std::uintptr_t>(head), -errorCode, 0 };
+				if (!try_push_completion(failed))
+				{
+					break;
+				}
+
+				local::pop_front(head, tail);
+			}
+		};
+
+		failAll(descriptor.m_readersHead, descriptor.m_readersTail);
+		failAll(descriptor.m_writersHead, descriptor.m_writersTail);
+	}
+
+	if (state == nullptr)
+	{
+		return false;
+	}
+
+	result.m_userData = reinterpret_cast<std::uintptr_t>(state);
+	result.m_result = value;
+	result.m_flags = flags;
+	return true;
+}
+
+bool cppcoro::detail::lnx::epoll_reactor::try_enable_zerocopy(
+	descriptor_state& descriptor) noexcept
+{
+	if (descriptor.m_zerocopySupport == zerocopy_support::unknown)
+	{
+		const int enable = 1;
+		const int result = ::setsockopt(
+			descriptor.m_fd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable));
+		descriptor.m_zerocopySupport = result == 0 ?
+			zerocopy_support::enabled : zerocopy_support::unsupported;
+	}
+
+	return descriptor.m_zerocopySupport == zerocopy_support::enabled;
+}
+
+void cppcoro::detail::lnx::epoll_reactor::process_zerocopy_notifications(
+	descriptor_state& descriptor) noexcept
+{
+	while (true)
+	{
+		alignas(cmsghdr) std::uint8_t control[
+			CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+
+		msghdr message{};
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+
+		if (::recvmsg(descriptor.m_fd, &message, MSG_ERRQUEUE) == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			// Typically EAGAIN once the error queue is empty.
+			return;
+		}
+
+		for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+			cmsg != nullptr;
+			cmsg = CMSG_NXTHDR(&message, cmsg))
+		{
+			const bool isExtendedError =
+				(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+				(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+			if (!isExtendedError)
+			{
+				continue;
+			}
+
+			sock_extended_err error;
+			std::memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+			if (error.ee_errno != 0 || error.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+			{
+				continue;
+			}
+
+			// The kernel has finished with the buffers of the sends with
+			// ids from ee_info to ee_data inclusive.
+			const std::uint32_t first = error.ee_info;
+			const std::uint32_t last = error.ee_data;
+
+			io_state* current = descriptor.m_zerocopyHead;
+			while (current != nullptr)
+			{
+				io_state* next = current->m_next;
+
+				const auto id = static_cast<std::uint32_t>(current->m_offset);
+				if (id - first <= last - first)
+				{
+					local::remove(descriptor.m_zerocopyHead, descriptor.m_zerocopyTail, current);
+					local::push_back(descriptor.m_releasedHead, descriptor.m_releasedTail, current);
+				}
+
+				current = next;
+			}
+		}
+	}
+}
+
+void cppcoro::detail::lnx::epoll_reactor::signal_wake_up() noexcept
+{
+	const std::uint64_t value = 1;
+	(void)::write(m_wakeUpFd.fd(), &value, sizeof(value));
+}
+
+void cppcoro::detail::lnx::epoll_reactor::reset_wake_up() noexcept
+{
+	std::uint64_t value;
+	(void)::read(m_wakeUpFd.fd(), &value, sizeof(value));
+}
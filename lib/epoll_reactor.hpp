@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_PRIVATE_EPOLL_REACTOR_HPP_INCLUDED
+#define CPPCORO_PRIVATE_EPOLL_REACTOR_HPP_INCLUDED
+
+#include <cppcoro/config.hpp>
+#include <cppcoro/detail/linux.hpp>
+
+#include "io_engine.hpp"
+#include "spin_mutex.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace cppcoro
+{
+	namespace detail
+	{
+		namespace lnx
+		{
+			/// \brief
+			/// An io_engine built on epoll for kernels where io_uring is not
+			/// available.
+			///
+			/// Operations on file descriptors that support readiness notification
+			/// (pipes, sockets, etc.) are queued until epoll reports that the file
+			/// descriptor is ready and are then performed with a non-blocking system
+			/// call by whichever I/O thread received the notification. Operations
+			/// on file descriptors that don't support readiness notification
+			/// (eg. regular files) are performed synchronously.
+			///
+			/// Posted completions are held in a bounded queue. An eventfd registered
+			/// with the epoll instance is used to wake up I/O threads that are blocked
+			/// waiting for events when a completion is posted.
+			class epoll_reactor final : public io_engine
+			{
+			public:
+
+				/// Create a new epoll reactor.
+				///
+				/// \param entries
+				/// Used to size the queue of posted completions.
+				///
+				/// \throw std::system_error
+				/// If the epoll instance or eventfd could not be created.
+				explicit epoll_reactor(std::uint32_t entries);
+
+				~epoll_reactor();
+
+				epoll_reactor(const epoll_reactor&) = delete;
+				epoll_reactor& operator=(const epoll_reactor&) = delete;
+
+				io_service_backend backend() const noexcept override;
+
+				bool try_post(std::uint64_t userData) noexcept override;
+
+				bool try_start(io_state& state, std::int32_t& result) noexcept override;
+
+				void cancel(io_state& state) noexcept override;
+
+				bool try_dequeue(completion& result, bool waitForCompletion) override;
+
+			private:
+
+				enum class zerocopy_support : std::uint8_t
+				{
+					unknown,
+					enabled,
+					unsupported
+				};
+
+				/// The operations waiting for a particular file descriptor to
+				/// become ready.
+				struct descriptor_state
+				{
+					explicit descriptor_state(fd_t fd) noexcept;
+
+					spin_mutex m_mutex;
+					fd_t m_fd;
+					bool m_isRegistered;
+					io_state* m_readersHead;
+					io_state* m_readersTail;
+					io_state* m_writersHead;
+					io_state* m_writersTail;
+
+					// Whether SO_ZEROCOPY has been enabled on the socket.
+					zerocopy_support m_zerocopySupport;
+
+					// send_zerocopy operations whose data has been sent but whose
+					// buffer the kernel may still reference, in the order they
+					// were sent. Each has its notification id in m_offset.
+					io_state* m_zerocopyHead;
+					io_state* m_zerocopyTail;
+
+					// send_zerocopy operations whose buffer has been released but
+					// whose final completion could not yet be queued.
+					io_state* m_releasedHead;
+					io_state* m_releasedTail;
+
+					// The notification id that the kernel will assign to the
+					// next zero-copy send on the socket.
+					std::uint32_t m_nextZerocopyId;
+				};
+
+				bool try_push_completion(const completion& value) noexcept;
+				bool try_pop_completion(completion& result) noexcept;
+
+				descriptor_state* find_descriptor_state(fd_t fd) noexcept;
+				descriptor_state* get_descriptor_state(fd_t fd) noexcept;
+
+				/// Re-arm the one-shot epoll registration for the descriptor with
+				/// the events that its queued operations are waiting for.
+				///
+				/// Must be called with the descriptor's mutex held.
+				///
+				/// \return
+				/// 0 on success, otherwise the errno value describing the failure.
+				int update_registration(descriptor_state& descriptor) noexcept;
+
+				/// Enable zero-copy sends on the descriptor's socket, if not
+				/// already done.
+				///
+				/// Must be called with the descriptor's mutex held.
+				///
+				/// \return
+				/// false if the socket doesn't support zero-copy sends.
+				bool try_enable_zerocopy(descriptor_state& descriptor) noexcept;
+
+				/// Read the zero-copy completion notifications from the
+				/// socket's error queue, moving the operations whose buffers
+				/// have been released to the descriptor's released list.
+				///
+				/// Must be called with the descriptor's mutex held.
+				void process_zerocopy_notifications(descriptor_state& descriptor) noexcept;
+
+				/// Perform the first ready operation queued on the descriptor.
+				///
+				/// \return
+				/// true if an operation was performed, in which case \p result
+				/// holds its completion.
+				bool try_complete_ready_operation(
+					descriptor_state& descriptor,
+					std::uint32_t events,
+					completion& result) noexcept;
+
+				void signal_wake_up() noexcept;
+				void reset_wake_up() noexcept;
+
+				safe_file_descriptor m_epollFd;
+				safe_file_descriptor m_wakeUpFd;
+
+				// Number of threads that are, or are about to be, blocked in a
+				// call to epoll_wait(). Used to avoid signalling the eventfd when
+				// there is nobody to wake up.
+				std::atomic<std::uint32_t> m_waitingThreadCount;
+
+				// Bounded queue of posted completions.
+				spin_mutex m_completionMutex;
+				std::unique_ptr<completion[]> m_completions;
+				std::uint32_t m_completionMask;
+				std::uint32_t m_completionHead;
+				std::uint32_t m_completionTail;
+
+				// Descriptor states are created the first time an operation is
+				// started on a file descriptor and live as long as the reactor
+				// so that their addresses can be used as epoll user-data.
+				std::mutex m_descriptorMutex;
+				std::unordered_map<fd_t, std::unique_ptr<descriptor_state>> m_descriptors;
+
+			};
+		}
+	}
+}
+
+#endif
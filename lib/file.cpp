@@ -9,8 +9,29 @@
 #include <system_error>
 #include <cassert>
 
+#if CPPCORO_OS_WINNT
+# ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+# endif
+# include <Windows.h>
+#elif CPPCORO_OS_LINUX
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <cerrno>
+#endif
+
 cppcoro::file::~file()
-{}
+{
+#if CPPCORO_OS_LINUX
+	if (m_ioService != nullptr && m_fileHandle != -1)
+	{
+		// Drop any registration before m_fileHandle closes the descriptor
+		// so that it can't be applied to a new descriptor that reuses the
+		// same number.
+		m_ioService->unregister_file(m_fileHandle.fd());
+	}
+#endif
+}
 
 std::uint64_t cppcoro::file::size() const
 {
@@ -29,9 +50,24 @@ std::uint64_t cppcoro::file::size() const
 	}
 
 	return size.QuadPart;
+#elif CPPCORO_OS_LINUX
+	struct stat fileStat;
+	if (::fstat(m_fileHandle.fd(), &fileStat) == -1)
+	{
+		throw std::system_error
+		{
+			errno,
+			std::system_category(),
+			"error getting file size: fstat"
+		};
+	}
+
+	return static_cast<std::uint64_t>(fileStat.st_size);
 #endif
 }
 
+#if CPPCORO_OS_WINNT
+
 cppcoro::file::file(detail::win32::safe_handle&& fileHandle) noexcept
 	: m_fileHandle(std::move(fileHandle))
 {
@@ -40,7 +76,7 @@ cppcoro::file::file(detail::win32::safe_handle&& fileHandle) noexcept
 cppcoro::detail::win32::safe_handle cppcoro::file::open(
 	detail::win32::dword_t fileAccess,
 	io_service& ioService,
-	const std::experimental::filesystem::path& path,
+	const std::filesystem::path& path,
 	file_open_mode openMode,
 	file_share_mode shareMode,
 	file_buffering_mode bufferingMode)
@@ -159,3 +195,102 @@ cppcoro::detail::win32::safe_handle cppcoro::file::open(
 
 	return std::move(fileHandle);
 }
+
+#elif CPPCORO_OS_LINUX
+
+cppcoro::file::file(
+	detail::lnx::safe_file_descriptor&& fileHandle,
+	io_service* ioService) noexcept
+	: m_fileHandle(std::move(fileHandle))
+	, m_ioService(ioService)
+{
+}
+
+cppcoro::detail::lnx::safe_file_descriptor cppcoro::file::open(
+	int accessFlags,
+	[[maybe_unused]] io_service& ioService,
+	const std::filesystem::path& path,
+	file_open_mode openMode,
+	[[maybe_unused]] file_share_mode shareMode,
+	file_buffering_mode bufferingMode)
+{
+	// Linux has no equivalent of the Windows share modes so shareMode is
+	// ignored. Operations are started on the io_service when they are
+	// awaited so, unlike Windows, there is no need to associate the file
+	// with the io_service here.
+
+	int flags = accessFlags | O_CLOEXEC;
+	switch (openMode)
+	{
+	case file_open_mode::create_or_open:
+		flags |= O_CREAT;
+		break;
+	case file_open_mode::create_always:
+		flags |= O_CREAT | O_TRUNC;
+		break;
+	case file_open_mode::create_new:
+		flags |= O_CREAT | O_EXCL;
+		break;
+	case file_open_mode::open_existing:
+		break;
+	case file_open_mode::truncate_existing:
+		flags |= O_TRUNC;
+		break;
+	}
+
+	if ((bufferingMode & file_buffering_mode::unbuffered) == file_buffering_mode::unbuffered)
+	{
+		flags |= O_DIRECT;
+	}
+	if ((bufferingMode & file_buffering_mode::write_through) == file_buffering_mode::write_through)
+	{
+		flags |= O_DSYNC;
+	}
+
+	std::filesystem::path openPath = path;
+	if ((bufferingMode & file_buffering_mode::temporary) == file_buffering_mode::temporary &&
+		(openMode == file_open_mode::create_always || openMode == file_open_mode::create_new))
+	{
+		// Create an unnamed file in the target directory that is deleted
+		// once it is closed, rather than a named file the caller has to
+		// clean up.
+		openPath = path.parent_path();
+		if (openPath.empty())
+		{
+			openPath = ".";
+		}
+
+		flags = (flags & ~(O_CREAT | O_EXCL | O_TRUNC)) | O_TMPFILE;
+	}
+
+	detail::lnx::safe_file_descriptor fileHandle{ ::open(openPath.c_str(), flags, 0666) };
+	if (fileHandle.fd() == -1)
+	{
+		throw std::system_error
+		{
+			errno,
+			std::system_category(),
+			"error opening file: open"
+		};
+	}
+
+	int advice = POSIX_FADV_NORMAL;
+	if ((bufferingMode & file_buffering_mode::random_access) == file_buffering_mode::random_access)
+	{
+		advice = POSIX_FADV_RANDOM;
+	}
+	else if ((bufferingMode & file_buffering_mode::sequential) == file_buffering_mode::sequential)
+	{
+		advice = POSIX_FADV_SEQUENTIAL;
+	}
+
+	if (advice != POSIX_FADV_NORMAL)
+	{
+		// The access pattern is only a hint so failure to apply it is ignored.
+		(void)::posix_fadvise(fileHandle.fd(), 0, 0, advice);
+	}
+
+	return fileHandle;
+}
+
+#endif
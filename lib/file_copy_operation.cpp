@@ -0,0 +1,39 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cppcoro/file_copy_operation.hpp>
+
+#if CPPCORO_OS_LINUX
+
+namespace
+{
+	namespace local
+	{
+		// The copy is performed synchronously by an I/O thread, so limit
+		// how long it holds up the other events that the thread could be
+		// processing.
+		constexpr std::size_t max_copy_size = 1024 * 1024;
+	}
+}
+
+bool cppcoro::file_copy_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	auto& state = operation.get_io_state();
+	state.m_opcode = detail::lnx::io_opcode::copy_file_range;
+	state.m_fd = m_destinationFileHandle;
+	state.m_buffer = &m_source;
+	state.m_length = m_byteCount <= local::max_copy_size ?
+		m_byteCount : local::max_copy_size;
+	return operation.try_start_io();
+}
+
+void cppcoro::file_copy_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+#endif
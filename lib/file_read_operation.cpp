@@ -50,4 +50,60 @@ void cppcoro::file_read_operation_impl::cancel(
 	(void)::CancelIoEx(m_fileHandle, operation.get_overlapped());
 }
 
-#endif // CPPCORO_OS_WINNT
+#elif CPPCORO_OS_LINUX
+
+namespace
+{
+	namespace local
+	{
+		// Linux transfers at most this many bytes in a single read/write.
+		constexpr std::size_t max_transfer_size = 0x7FFFF000;
+
+		// Linux accepts at most this many buffers (IOV_MAX) in a single
+		// vectored read/write.
+		constexpr std::size_t max_buffer_count = 1024;
+	}
+}
+
+bool cppcoro::file_read_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	auto& state = operation.get_io_state();
+	state.m_opcode = detail::lnx::io_opcode::read;
+	state.m_fd = m_fileHandle;
+	state.m_buffer = m_buffer;
+	state.m_length = static_cast<std::uint32_t>(
+		m_byteCount <= local::max_transfer_size ?
+		m_byteCount : local::max_transfer_size);
+
+	// The epoll reactor performs operations on regular files synchronously,
+	// in which case the result is left in operation.m_result.
+	return operation.try_start_io();
+}
+
+void cppcoro::file_read_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+bool cppcoro::file_readv_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	auto& state = operation.get_io_state();
+	state.m_opcode = detail::lnx::io_opcode::readv;
+	state.m_fd = m_fileHandle;
+	state.m_buffer = m_buffers.data();
+	state.m_length = static_cast<std::uint32_t>(
+		m_buffers.size() <= local::max_buffer_count ?
+		m_buffers.size() : local::max_buffer_count);
+	return operation.try_start_io();
+}
+
+void cppcoro::file_readv_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+#endif
@@ -0,0 +1,27 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cppcoro/file_sync_operation.hpp>
+
+#if CPPCORO_OS_LINUX
+
+bool cppcoro::file_sync_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	auto& state = operation.get_io_state();
+	state.m_opcode = m_opcode;
+	state.m_fd = m_fileHandle;
+	state.m_flags = m_flags;
+	state.m_length = m_length;
+	return operation.try_start_io();
+}
+
+void cppcoro::file_sync_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+#endif
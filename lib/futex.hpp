@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_PRIVATE_FUTEX_HPP_INCLUDED
+#define CPPCORO_PRIVATE_FUTEX_HPP_INCLUDED
+
+#include <cppcoro/config.hpp>
+
+#if CPPCORO_OS_LINUX
+# include <atomic>
+
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+
+namespace cppcoro
+{
+	namespace detail
+	{
+		namespace lnx
+		{
+			static_assert(
+				sizeof(std::atomic<int>) == sizeof(int) &&
+				std::atomic<int>::is_always_lock_free,
+				"futex operations require std::atomic<int> to have the layout of int");
+
+			/// Block the calling thread until woken by futex_wake(), provided
+			/// that \p word still holds \p expected.
+			///
+			/// May return spuriously, so callers must re-check \p word.
+			///
+			/// \return
+			/// 0 if woken, otherwise -1 with errno set, eg. to EAGAIN if
+			/// \p word didn't hold \p expected or to EINTR if interrupted.
+			inline int futex_wait(std::atomic<int>& word, int expected) noexcept
+			{
+				return static_cast<int>(::syscall(
+					SYS_futex,
+					reinterpret_cast<int*>(&word),
+					FUTEX_WAIT_PRIVATE,
+					expected,
+					nullptr,
+					nullptr,
+					0));
+			}
+
+			/// Wake up to \p count threads blocked in futex_wait() on \p word.
+			///
+			/// Only the address of \p word is used, so this is safe to call
+			/// even if another thread may have destroyed it in the meantime.
+			///
+			/// \return
+			/// The number of threads woken, or -1 with errno set on failure.
+			inline int futex_wake(std::atomic<int>& word, int count) noexcept
+			{
+				return static_cast<int>(::syscall(
+					SYS_futex,
+					reinterpret_cast<int*>(&word),
+					FUTEX_WAKE_PRIVATE,
+					count,
+					nullptr,
+					nullptr,
+					0));
+			}
+		}
+	}
+}
+#endif
+
+#endif
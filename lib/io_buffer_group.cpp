@@ -0,0 +1,49 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "io_buffer_group.hpp"
+
+#include <mutex>
+
+cppcoro::detail::lnx::io_buffer_group::io_buffer_group(
+	std::byte* buffers,
+	std::uint32_t bufferSize,
+	std::uint16_t bufferCount)
+	: m_groupId(0)
+	, m_ring(nullptr)
+	, m_ringSize(0)
+	, m_ringTail(0)
+	, m_buffers(buffers)
+	, m_bufferSize(bufferSize)
+	, m_bufferCount(bufferCount)
+{
+	// Hand out the lowest numbered buffers first.
+	m_freeBuffers.reserve(bufferCount);
+	for (std::uint32_t i = bufferCount; i > 0; --i)
+	{
+		m_freeBuffers.push_back(static_cast<std::uint16_t>(i - 1));
+	}
+}
+
+bool cppcoro::detail::lnx::io_buffer_group::try_acquire(std::uint16_t& bufferId) noexcept
+{
+	std::lock_guard lock{ m_mutex };
+	if (m_freeBuffers.empty())
+	{
+		return false;
+	}
+
+	bufferId = m_freeBuffers.back();
+	m_freeBuffers.pop_back();
+	return true;
+}
+
+void cppcoro::detail::lnx::io_buffer_group::release(std::uint16_t bufferId) noexcept
+{
+	std::lock_guard lock{ m_mutex };
+
+	// Can't throw as we reserved capacity for every buffer up front.
+	m_freeBuffers.push_back(bufferId);
+}
@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_PRIVATE_IO_BUFFER_GROUP_HPP_INCLUDED
+#define CPPCORO_PRIVATE_IO_BUFFER_GROUP_HPP_INCLUDED
+
+#include <cppcoro/config.hpp>
+
+#include "spin_mutex.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cppcoro
+{
+	namespace detail
+	{
+		namespace lnx
+		{
+			/// \brief
+			/// A group of equally sized buffers that io_opcode::recv_select_buffer
+			/// operations pick a buffer from once data arrives.
+			///
+			/// Buffers are identified by their index within the group. A buffer
+			/// picked by an operation belongs to the operation's owner until it
+			/// is handed back with io_engine::recycle_buffer().
+			///
+			/// An engine either hands the buffers to the kernel to pick from, or
+			/// picks them itself from the group's free list.
+			class io_buffer_group
+			{
+			public:
+
+				/// \throw std::bad_alloc
+				io_buffer_group(
+					std::byte* buffers,
+					std::uint32_t bufferSize,
+					std::uint16_t bufferCount);
+
+				io_buffer_group(const io_buffer_group&) = delete;
+				io_buffer_group& operator=(const io_buffer_group&) = delete;
+
+				std::byte* buffer(std::uint16_t bufferId) const noexcept
+				{
+					return m_buffers + static_cast<std::size_t>(bufferId) * m_bufferSize;
+				}
+
+				std::uint32_t buffer_size() const noexcept { return m_bufferSize; }
+
+				std::uint16_t buffer_count() const noexcept { return m_bufferCount; }
+
+				/// Take a buffer from the free list.
+				///
+				/// \return
+				/// false if all of the buffers are in use.
+				bool try_acquire(std::uint16_t& bufferId) noexcept;
+
+				/// Return a buffer to the free list.
+				void release(std::uint16_t bufferId) noexcept;
+
+				// The following are used by engines that hand the buffers to
+				// the kernel.
+
+				// The id that the buffers were registered with the kernel under.
+				std::uint16_t m_groupId;
+
+				// The ring that buffers are handed back to the kernel through, or
+				// null if the engine picks buffers from the free list instead.
+				void* m_ring;
+				std::size_t m_ringSize;
+
+				// The next ring entry to fill in. Protected by m_mutex.
+				std::uint16_t m_ringTail;
+
+				spin_mutex m_mutex;
+
+			private:
+
+				std::byte* m_buffers;
+				std::uint32_t m_bufferSize;
+				std::uint16_t m_bufferCount;
+
+				// Protected by m_mutex.
+				std::vector<std::uint16_t> m_freeBuffers;
+
+			};
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "io_engine.hpp"
+#include "io_uring_queue.hpp"
+#include "epoll_reactor.hpp"
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#include <linux/io_uring.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+	namespace local
+	{
+		thread_local cppcoro::detail::lnx::io_engine* t_batchingEngine = nullptr;
+	}
+}
+
+cppcoro::detail::lnx::io_engine::submission_batch::submission_batch(
+	io_engine& engine) noexcept
+	: m_engine(engine)
+	, m_previousEngine(std::exchange(local::t_batchingEngine, &engine))
+{}
+
+cppcoro::detail::lnx::io_engine::submission_batch::~submission_batch()
+{
+	local::t_batchingEngine = m_previousEngine;
+	m_engine.submit_pending();
+}
+
+bool cppcoro::detail::lnx::io_engine::is_batching_submissions() const noexcept
+{
+	return local::t_batchingEngine == this;
+}
+
+std::unique_ptr<cppcoro::detail::lnx::io_engine>
+cppcoro::detail::lnx::create_io_engine(
+	const io_service_options& options,
+	std::uint32_t entries)
+{
+	switch (options.backend)
+	{
+	case io_service_backend::io_uring:
+		return std::make_unique<io_uring_queue>(entries, options);
+
+	case io_service_backend::epoll:
+		return std::make_unique<epoll_reactor>(entries);
+
+	case io_service_backend::automatic:
+	default:
+		try
+		{
+			return std::make_unique<io_uring_queue>(entries, options);
+		}
+		catch (const std::system_error&)
+		{
+			// io_uring is either not supported by this kernel or has been
+			// disabled (eg. via the kernel.io_uring_disabled sysctl or by a
+			// seccomp policy). Fall back to using epoll.
+		}
+
+		return std::make_unique<epoll_reactor>(entries);
+	}
+}
+
+std::int32_t cppcoro::detail::lnx::perform_copy_file_range(
+	const io_state& state) noexcept
+{
+	const auto& source = *static_cast<const io_file_range*>(state.m_buffer);
+
+	auto inputOffset = static_cast<loff_t>(source.m_offset);
+	auto outputOffset = static_cast<loff_t>(state.m_offset);
+
+	ssize_t count;
+	do
+	{
+		count = ::copy_file_range(
+			source.m_fd,
+			&inputOffset,
+			state.m_fd,
+			&outputOffset,
+			static_cast<std::size_t>(state.m_length),
+			0);
+	} while (count == -1 && errno == EINTR);
+
+	return count == -1 ? -errno : static_cast<std::int32_t>(count);
+}
+
+std::int32_t cppcoro::detail::lnx::perform_sendfile(const io_state& state) noexcept
+{
+	const auto& source = *static_cast<const io_file_range*>(state.m_buffer);
+
+	auto inputOffset = static_cast<off_t>(source.m_offset);
+
+	ssize_t count;
+	do
+	{
+		count = ::sendfile(
+			state.m_fd,
+			source.m_fd,
+			&inputOffset,
+			static_cast<std::size_t>(state.m_length));
+	} while (count == -1 && errno == EINTR);
+
+	if (count == -1)
+	{
+		return errno == EWOULDBLOCK ? -EAGAIN : -errno;
+	}
+
+	return static_cast<std::int32_t>(count);
+}
+
+std::int32_t cppcoro::detail::lnx::perform_message_batch(const io_state& state) noexcept
+{
+	auto* messages = static_cast<mmsghdr*>(state.m_buffer);
+	const auto messageCount = static_cast<unsigned int>(state.m_length);
+	const int flags = static_cast<int>(state.m_flags) | MSG_DONTWAIT;
+
+	int count;
+	do
+	{
+		count = state.m_opcode == io_opcode::sendmmsg ?
+			::sendmmsg(state.m_fd, messages, messageCount, flags) :
+			::recvmmsg(state.m_fd, messages, messageCount, flags, nullptr);
+	} while (count == -1 && errno == EINTR);
+
+	if (count == -1)
+	{
+		return errno == EWOULDBLOCK ? -EAGAIN : -errno;
+	}
+
+	return count;
+}
+
+std::int32_t cppcoro::detail::lnx::perform_recv_select_buffer(
+	const io_state& state,
+	std::uint32_t& flags) noexcept
+{
+	auto& group = *static_cast<io_buffer_group*>(state.m_buffer);
+
+	flags = 0;
+
+	std::uint16_t bufferId;
+	if (!group.try_acquire(bufferId))
+	{
+		return -ENOBUFS;
+	}
+
+	ssize_t count;
+	do
+	{
+		count = ::recv(
+			state.m_fd,
+			group.buffer(bufferId),
+			group.buffer_size(),
+			static_cast<int>(state.m_flags) | MSG_DONTWAIT);
+	} while (count == -1 && errno == EINTR);
+
+	if (count <= 0)
+	{
+		// No data, so don't hold on to the buffer.
+		const int errorCode = errno;
+		group.release(bufferId);
+
+		if (count == 0)
+		{
+			return 0;
+		}
+
+		return errorCode == EWOULDBLOCK ? -EAGAIN : -errorCode;
+	}
+
+	flags = IORING_CQE_F_BUFFER | (std::uint32_t(bufferId) << IORING_CQE_BUFFER_SHIFT);
+	return static_cast<std::int32_t>(count);
+}
@@ -0,0 +1,240 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_PRIVATE_IO_ENGINE_HPP_INCLUDED
+#define CPPCORO_PRIVATE_IO_ENGINE_HPP_INCLUDED
+
+#include <cppcoro/config.hpp>
+#include <cppcoro/io_service_backend.hpp>
+#include <cppcoro/io_service_options.hpp>
+#include <cppcoro/detail/linux.hpp>
+
+#include "io_buffer_group.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace cppcoro
+{
+	namespace detail
+	{
+		namespace lnx
+		{
+			/// \brief
+			/// Interface to the kernel mechanism that an io_service uses to start
+			/// I/O operations and to wait for them to complete.
+			///
+			/// All operations are thread-safe.
+			class io_engine
+			{
+			public:
+
+				struct completion
+				{
+					std::uint64_t m_userData;
+					std::int32_t m_result;
+					std::uint32_t m_flags;
+				};
+
+				/// Scope during which operations started by the current thread on
+				/// the specified engine may be queued up rather than being handed
+				/// to the kernel immediately. Any queued operations are handed to
+				/// the kernel when the scope exits.
+				///
+				/// This lets an I/O thread batch up all of the operations started
+				/// while processing one completion event into a single system call.
+				class submission_batch
+				{
+				public:
+
+					explicit submission_batch(io_engine& engine) noexcept;
+					~submission_batch();
+
+					submission_batch(const submission_batch&) = delete;
+					submission_batch& operator=(const submission_batch&) = delete;
+
+				private:
+
+					io_engine& m_engine;
+					io_engine* m_previousEngine;
+
+				};
+
+				virtual ~io_engine() = default;
+
+				virtual io_service_backend backend() const noexcept = 0;
+
+				/// Query whether a kernel thread is polling for submissions.
+				virtual bool is_submission_polling_enabled() const noexcept { return false; }
+
+				/// Queue a completion with the specified user-data to be returned
+				/// from a subsequent call to try_dequeue().
+				///
+				/// The user-data must be zero or have its lowest bit set so that
+				/// it can't be mistaken for the address of an io_state.
+				///
+				/// \return
+				/// false if the completion could not be queued because the
+				/// queue was full.
+				virtual bool try_post(std::uint64_t userData) noexcept = 0;
+
+				/// Start the I/O operation described by \p state.
+				///
+				/// \return
+				/// true if the operation was started, in which case a completion
+				/// with the address of \p state as the user-data will be returned
+				/// from a subsequent call to try_dequeue().
+				/// false if the operation completed synchronously or could not be
+				/// started, in which case \p result holds the result.
+				virtual bool try_start(io_state& state, std::int32_t& result) noexcept = 0;
+
+				/// Request cancellation of an operation that was started by a
+				/// successful call to try_start().
+				virtual void cancel(io_state& state) noexcept = 0;
+
+				/// Register a long-lived file descriptor with the kernel so that
+				/// operations on it avoid per-operation file reference counting.
+				///
+				/// Operations started on a registered file descriptor use the
+				/// registration automatically.
+				///
+				/// \return
+				/// Zero on success, otherwise the errno value describing the failure.
+				virtual int register_file([[maybe_unused]] fd_t fd) noexcept { return 0; }
+
+				/// Remove a registration made by register_file().
+				virtual void unregister_file([[maybe_unused]] fd_t fd) noexcept {}
+
+				/// Register a set of buffers with the kernel so that operations
+				/// that read into or write from them avoid pinning the user pages
+				/// on every operation.
+				///
+				/// Read, write and send_zerocopy operations whose buffer lies
+				/// entirely within one of the registered buffers use the
+				/// registration automatically.
+				///
+				/// \return
+				/// Zero on success, otherwise the errno value describing the failure.
+				virtual int register_buffers(
+					[[maybe_unused]] std::span<const std::span<std::byte>> buffers) noexcept
+				{
+					return 0;
+				}
+
+				/// Remove the buffers registered by register_buffers().
+				virtual void unregister_buffers() noexcept {}
+
+				/// Prepare a group of buffers for io_opcode::recv_select_buffer
+				/// operations to pick from.
+				///
+				/// \return
+				/// Zero on success, otherwise the errno value describing the failure.
+				virtual int register_buffer_group([[maybe_unused]] io_buffer_group& group) noexcept { return 0; }
+
+				/// Remove a registration made by register_buffer_group().
+				///
+				/// There must be no outstanding operations using the group.
+				virtual void unregister_buffer_group([[maybe_unused]] io_buffer_group& group) noexcept {}
+
+				/// Hand back a buffer that a completed operation picked from the
+				/// group so that it can be picked again.
+				virtual void recycle_buffer(io_buffer_group& group, std::uint16_t bufferId) noexcept
+				{
+					group.release(bufferId);
+				}
+
+				/// Dequeue a single completion.
+				///
+				/// \param waitForCompletion
+				/// If true then blocks until a completion is available.
+				/// Note that this may still return without a completion, eg. if
+				/// the wait was interrupted by a signal.
+				///
+				/// \return
+				/// true if a completion was dequeued.
+				virtual bool try_dequeue(completion& result, bool waitForCompletion) = 0;
+
+			protected:
+
+				/// Hand any operations that were queued up while the current
+				/// thread was batching submissions to the kernel.
+				virtual void submit_pending() noexcept {}
+
+				/// Query whether the current thread is inside a submission_batch
+				/// scope for this engine.
+				bool is_batching_submissions() const noexcept;
+
+			};
+
+			/// Create an io_engine using the backend and engine settings from
+			/// the specified options.
+			///
+			/// \param entries
+			/// The number of operations that can be queued for submission
+			/// to the kernel at once.
+			///
+			/// \throw std::system_error
+			/// If the engine could not be created.
+			std::unique_ptr<io_engine> create_io_engine(
+				const io_service_options& options,
+				std::uint32_t entries);
+
+			/// Perform an io_opcode::copy_file_range operation synchronously.
+			///
+			/// Neither io_uring nor epoll can wait for a copy_file_range(),
+			/// so engines call this from the I/O thread that dequeues a
+			/// completion posted for the operation, rather than blocking the
+			/// thread that starts it. The data is still copied within the
+			/// kernel without passing through user space.
+			///
+			/// \return
+			/// The number of bytes copied or the negated errno value.
+			std::int32_t perform_copy_file_range(const io_state& state) noexcept;
+
+			/// Attempt to perform an io_opcode::sendfile operation without
+			/// blocking.
+			///
+			/// There is no io_uring equivalent of sendfile(), so engines wait
+			/// for the socket to become writable and then call this. The socket
+			/// must be in non-blocking mode.
+			///
+			/// \return
+			/// The number of bytes sent or the negated errno value, which is
+			/// -EAGAIN if the socket is not ready.
+			std::int32_t perform_sendfile(const io_state& state) noexcept;
+
+			/// Attempt to perform an io_opcode::sendmmsg or io_opcode::recvmmsg
+			/// operation without blocking.
+			///
+			/// There is no io_uring equivalent of sendmmsg() or recvmmsg(), so
+			/// engines wait for the socket to become ready and then call this.
+			///
+			/// \return
+			/// The number of messages transferred or the negated errno value,
+			/// which is -EAGAIN if the socket is not ready.
+			std::int32_t perform_message_batch(const io_state& state) noexcept;
+
+			/// Attempt to perform an io_opcode::recv_select_buffer operation
+			/// without blocking, picking the buffer from the group's free list.
+			///
+			/// Used by engines that can't have the kernel pick the buffer. A
+			/// buffer is only taken from the group if data was received.
+			///
+			/// \param flags
+			/// Receives the completion flags identifying the buffer picked.
+			///
+			/// \return
+			/// The number of bytes received or the negated errno value, which
+			/// is -EAGAIN if the socket is not ready and -ENOBUFS if all of the
+			/// group's buffers are in use.
+			std::int32_t perform_recv_select_buffer(
+				const io_state& state,
+				std::uint32_t& flags) noexcept;
+		}
+	}
+}
+
+#endif
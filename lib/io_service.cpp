@@ -9,77 +9,151 @@
 #include <system_error>
 #include <cassert>
 #include <algorithm>
+#include <bit>
 #include <thread>
 
+#if CPPCORO_OS_LINUX
+# include "io_engine.hpp"
+# include "spin_mutex.hpp"
+# include "spin_wait.hpp"
+# include <cerrno>
+# include <mutex>
+# include <poll.h>
+# include <sys/eventfd.h>
+# include <sys/timerfd.h>
+# include <unistd.h>
+#endif
+
+namespace
+{
+	namespace local
+	{
+#if CPPCORO_OS_LINUX
+		// Number of operations that can be queued for submission to the kernel.
+		// The completion queue is sized as a multiple of this.
+		constexpr std::uint32_t submission_queue_size = 512;
+
+		// Completions with this user-data are wake-up events posted by
+		// post_wake_up_event().
+		constexpr std::uint64_t wake_up_user_data = 0;
+
+		// Coroutines scheduled via io_service::schedule() are posted with the
+		// address of the coroutine frame tagged with this bit so that they can
+		// be distinguished from io_state completions, which are always at
+		// least 8-byte aligned.
+		constexpr std::uint64_t scheduled_coroutine_tag = 1;
+#endif
+	}
+}
+
 namespace cppcoro {
 /// \brief
-/// A queue of pending timers that supports efficiently determining
-/// and dequeueing the earliest-due timers in the queue.
+/// A queue of pending timers implemented as a hierarchical timing wheel.
+///
+/// Time is divided into ticks of a configurable duration, counted from
+/// the time the queue was created. The wheel has 'level_count' levels
+/// of 64 slots each. Level 0 has one slot per tick for timers due within
+/// the current run of 64 ticks. Each higher level covers 64 times the
+/// range of the level below with 64 times coarser slots. As time advances,
+/// the timers in a higher-level slot are cascaded down into the lower
+/// levels once the lower levels start covering that slot's range.
+/// Timers due beyond the range of the wheel are held in an overflow list
+/// which is redistributed each time the wheel completes a full rotation.
 ///
-/// Implementation utilises a heap-sorted vector of entries with an
-/// additional sorted linked-list that can be used as a fallback in
-/// cases that there was insufficient memory to store all timer
-/// entries in the vector.
+/// Enqueueing and removing a timer are O(1) and expiry is batched per
+/// tick. Each non-empty slot is a doubly-linked list of timers and a
+/// bitmap of occupied slots per level lets empty runs of slots be skipped.
 ///
-/// This fallback is required to guarantee that all operations on this
-/// queue are noexcept.s
+/// Timers never fire early but may fire up to one tick late.
+///
+/// All operations on this queue are noexcept and it must only be accessed
+/// by the timer thread.
 class io_service::timer_queue
 {
 public:
 
 	using time_point = std::chrono::high_resolution_clock::time_point;
 
-	timer_queue() noexcept;
+	// Value of timed_schedule_operation::m_timerQueueSlot for timers that
+	// are not in a timer queue.
+	static constexpr std::uint16_t not_queued = 0xFFFF;
+
+	explicit timer_queue(std::chrono::nanoseconds tickDuration) noexcept;
 
 	~timer_queue();
 
 	bool is_empty() const noexcept;
 
+	/// Returns the time of the next tick at which the queue needs to be
+	/// serviced by a call to dequeue_due_timers().
+	///
+	/// This is either the tick at which the earliest timer is due or the
+	/// tick at which timers need to be cascaded to a lower level.
 	time_point earliest_due_time() const noexcept;
 
 	void enqueue_timer(io_service::timed_schedule_operation* timer) noexcept;
 
+	/// Remove a timer from the queue.
+	///
+	/// Does nothing if the timer is not in the queue.
+	void remove_timer(io_service::timed_schedule_operation* timer) noexcept;
+
 	void dequeue_due_timers(
 		time_point currentTime,
 		io_service::timed_schedule_operation*& timerList) noexcept;
 
-	void remove_cancelled_timers(
-		io_service::timed_schedule_operation*& timerList) noexcept;
-
 private:
 
-	struct timer_entry
-	{
-		timer_entry(io_service::timed_schedule_operation* timer)
-			: m_dueTime(timer->m_resumeTime)
-			, m_timer(timer)
-		{}
+	static constexpr std::uint32_t bits_per_level = 6;
+	static constexpr std::uint32_t slots_per_level = 1u << bits_per_level;
+	static constexpr std::uint64_t slot_mask = slots_per_level - 1;
+	static constexpr std::uint32_t level_count = 4;
 
-		time_point m_dueTime;
-		io_service::timed_schedule_operation* m_timer;
-	};
+	static constexpr std::uint16_t overflow_slot = level_count * slots_per_level;
 
-	static bool compare_entries(const timer_entry& a, const timer_entry& b) noexcept
-	{
-		return a.m_dueTime > b.m_dueTime;
-	}
+	std::uint64_t tick_at_or_after(time_point time) const noexcept;
+	std::uint64_t tick_at_or_before(time_point time) const noexcept;
+	time_point tick_time(std::uint64_t tick) const noexcept;
+
+	void link(io_service::timed_schedule_operation* timer) noexcept;
+	void unlink(io_service::timed_schedule_operation* timer) noexcept;
+
+	/// Detach the list of timers in the specified slot.
+	io_service::timed_schedule_operation* take_slot(std::uint16_t slot) noexcept;
+
+	/// Redistribute the timers in the slot of the specified level that the
+	/// current tick has just entered.
+	void cascade(std::uint32_t level) noexcept;
 
-	// A heap-sorted list of active timer entries
-	// Earliest due timer is at the front of the queue
-	std::vector<timer_entry> m_timerEntries;
+	/// Redistribute the timers in the overflow list.
+	void cascade_overflow() noexcept;
 
-	// Linked-list of overflow timer entries used in case there was
-	// insufficient memory available to grow m_timerEntries.
-	// List is sorted in ascending order of due-time using insertion-sort.
-	// This is required to support the noexcept guarantee of enqueue_timer().
-	io_service::timed_schedule_operation* m_overflowTimers;
+	std::chrono::nanoseconds m_tickDuration;
+	time_point m_epoch;
+
+	// All ticks before this one have been processed.
+	std::uint64_t m_currentTick;
+
+	std::size_t m_timerCount;
+
+	// Bit N of m_occupiedSlots[L] is set if slot N of level L is non-empty.
+	std::uint64_t m_occupiedSlots[level_count];
+
+	// Heads of the slot lists. The last entry is the overflow list.
+	io_service::timed_schedule_operation* m_slots[level_count * slots_per_level + 1];
 
 };
 
-io_service::timer_queue::timer_queue() noexcept
-	: m_timerEntries()
-	, m_overflowTimers(nullptr)
-{}
+io_service::timer_queue::timer_queue(std::chrono::nanoseconds tickDuration) noexcept
+	: m_tickDuration(tickDuration)
+	, m_epoch(std::chrono::high_resolution_clock::now())
+	, m_currentTick(0)
+	, m_timerCount(0)
+	, m_occupiedSlots{}
+	, m_slots{}
+{
+	assert(m_tickDuration.count() > 0);
+}
 
 io_service::timer_queue::~timer_queue()
 {
@@ -88,51 +162,69 @@ io_service::timer_queue::~timer_queue()
 
 bool io_service::timer_queue::is_empty() const noexcept
 {
-	return m_timerEntries.empty() && m_overflowTimers == nullptr;
+	return m_timerCount == 0;
 }
 
 io_service::timer_queue::time_point
 io_service::timer_queue::earliest_due_time() const noexcept
 {
-	if (!m_timerEntries.empty())
+	if (m_timerCount == 0)
 	{
-		if (m_overflowTimers != nullptr)
+		return time_point::max();
+	}
+
+	// Timers are placed by comparing their due tick with the current tick,
+	// so a slot at level L > 0 is only ever occupied if it lies after the
+	// current tick's slot at that level, or is the current tick's slot and
+	// the current tick is the start of that slot's range and the slot has
+	// not yet been cascaded. The first occupied slot found, searching from
+	// level 0 upwards, is therefore the earliest.
+	for (std::uint32_t level = 0; level < level_count; ++level)
+	{
+		const std::uint32_t shift = level * bits_per_level;
+		const std::uint64_t currentSlot = (m_currentTick >> shift) & slot_mask;
+		const std::uint64_t candidates = m_occupiedSlots[level] & (~std::uint64_t(0) << currentSlot);
+		if (candidates != 0)
 		{
-			return std::min(
-				m_timerEntries.front().m_dueTime,
-				m_overflowTimers->m_resumeTime);
+			const std::uint64_t slot = std::countr_zero(candidates);
+			const std::uint32_t levelShift = shift + bits_per_level;
+			return tick_time(((m_currentTick >> levelShift) << levelShift) | (slot << shift));
 		}
-
-		return m_timerEntries.front().m_dueTime;
 	}
-	else if (m_overflowTimers != nullptr)
+
+	// Only overflow timers remain. These are redistributed when the wheel
+	// next completes a full rotation.
+	const std::uint32_t wheelBits = level_count * bits_per_level;
+	const std::uint64_t wheelMask = (std::uint64_t(1) << wheelBits) - 1;
+	if ((m_currentTick & wheelMask) == 0)
 	{
-		return m_overflowTimers->m_resumeTime;
+		return tick_time(m_currentTick);
 	}
 
-	return time_point::max();
+	return tick_time(((m_currentTick >> wheelBits) + 1) << wheelBits);
 }
 
 void io_service::timer_queue::enqueue_timer(
 	io_service::timed_schedule_operation* timer) noexcept
 {
-	try
+	if (m_timerCount == 0)
 	{
-		m_timerEntries.emplace_back(timer);
-		std::push_heap(m_timerEntries.begin(), m_timerEntries.end(), compare_entries);
+		// Timers are placed relative to the current tick so skip ahead over
+		// any time that has passed while the queue was empty.
+		m_currentTick = std::max(
+			m_currentTick,
+			tick_at_or_before(std::chrono::high_resolution_clock::now()));
 	}
-	catch (...)
-	{
-		const auto& newDueTime = timer->m_resumeTime;
 
-		auto** current = &m_overflowTimers;
-		while ((*current) != nullptr && (*current)->m_resumeTime <= newDueTime)
-		{
-			current = &(*current)->m_next;
-		}
+	link(timer);
+}
 
-		timer->m_next = *current;
-		*current = timer;
+void io_service::timer_queue::remove_timer(
+	io_service::timed_schedule_operation* timer) noexcept
+{
+	if (timer->m_timerQueueSlot != not_queued)
+	{
+		unlink(timer);
 	}
 }
 
@@ -140,130 +232,586 @@ void io_service::timer_queue::dequeue_due_timers(
 	time_point currentTime,
 	io_service::timed_schedule_operation*& timerList) noexcept
 {
-	while (!m_timerEntries.empty() && m_timerEntries.front().m_dueTime <= currentTime)
+	if (currentTime < m_epoch)
 	{
-		auto* timer = m_timerEntries.front().m_timer;
-		std::pop_heap(m_timerEntries.begin(), m_timerEntries.end(), compare_entries);
-		m_timerEntries.pop_back();
+		return;
+	}
+
+	const std::uint64_t lastDueTick = tick_at_or_before(currentTime);
+
+	while (m_timerCount > 0 && m_currentTick <= lastDueTick)
+	{
+		// On entering a new run of slots at some level, first move the
+		// timers from the corresponding higher-level slot down the wheel.
+		const std::uint32_t wheelBits = level_count * bits_per_level;
+		if ((m_currentTick & ((std::uint64_t(1) << wheelBits) - 1)) == 0)
+		{
+			cascade_overflow();
+		}
+
+		for (std::uint32_t level = level_count - 1; level > 0; --level)
+		{
+			if ((m_currentTick & ((std::uint64_t(1) << (level * bits_per_level)) - 1)) == 0)
+			{
+				cascade(level);
+			}
+		}
+
+		// Expire all timers due on the current tick.
+		const auto slot = static_cast<std::uint16_t>(m_currentTick & slot_mask);
+		auto* timer = take_slot(slot);
+		while (timer != nullptr)
+		{
+			auto* next = timer->m_next;
+			timer->m_next = timerList;
+			timerList = timer;
+			timer = next;
+		}
+
+		// Skip ahead to the next occupied level 0 slot, stopping at the end
+		// of the current run of slots so that higher levels get cascaded.
+		std::uint64_t nextTick = (m_currentTick | slot_mask) + 1;
+		if (slot + 1u < slots_per_level)
+		{
+			const std::uint64_t candidates = m_occupiedSlots[0] & (~std::uint64_t(0) << (slot + 1));
+			if (candidates != 0)
+			{
+				nextTick = (m_currentTick & ~slot_mask) + std::countr_zero(candidates);
+			}
+		}
 
-		timer->m_next = timerList;
-		timerList = timer;
+		m_currentTick = std::min(nextTick, lastDueTick + 1);
 	}
 
-	while (m_overflowTimers != nullptr && m_overflowTimers->m_resumeTime <= currentTime)
+	if (m_timerCount == 0)
 	{
-		auto* timer = m_overflowTimers;
-		m_overflowTimers = timer->m_next;
-		timer->m_next = timerList;
-		timerList = timer;
+		m_currentTick = std::max(m_currentTick, lastDueTick + 1);
 	}
 }
 
-void io_service::timer_queue::remove_cancelled_timers(
-	io_service::timed_schedule_operation*& timerList) noexcept
+std::uint64_t io_service::timer_queue::tick_at_or_after(time_point time) const noexcept
 {
-	// Perform a linear scan of all timers looking for any that have
-	// had cancellation requested.
+	if (time <= m_epoch)
+	{
+		return 0;
+	}
+
+	const auto elapsed = static_cast<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(time - m_epoch).count());
+	const auto tickDuration = static_cast<std::uint64_t>(m_tickDuration.count());
+	return elapsed / tickDuration + (elapsed % tickDuration != 0 ? 1 : 0);
+}
 
-	const auto addTimerToList = [&](timed_schedule_operation* timer)
+std::uint64_t io_service::timer_queue::tick_at_or_before(time_point time) const noexcept
+{
+	if (time <= m_epoch)
 	{
-		timer->m_next = timerList;
-		timerList = timer;
-	};
+		return 0;
+	}
 
-	const auto isTimerCancelled = [](const timer_entry& entry)
+	const auto elapsed = static_cast<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(time - m_epoch).count());
+	return elapsed / static_cast<std::uint64_t>(m_tickDuration.count());
+}
+
+io_service::timer_queue::time_point
+io_service::timer_queue::tick_time(std::uint64_t tick) const noexcept
+{
+	const auto maxTicks = static_cast<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(time_point::max() - m_epoch).count() /
+		m_tickDuration.count());
+	if (tick >= maxTicks)
 	{
-		return entry.m_timer->m_cancellationToken.is_cancellation_requested();
-	};
+		return time_point::max();
+	}
+
+	return m_epoch + std::chrono::duration_cast<time_point::duration>(
+		m_tickDuration * static_cast<std::int64_t>(tick));
+}
+
+void io_service::timer_queue::link(
+	io_service::timed_schedule_operation* timer) noexcept
+{
+	// Timers that are already due are placed in the current tick's slot.
+	const std::uint64_t dueTick = std::max(tick_at_or_after(timer->m_resumeTime), m_currentTick);
+
+	// The level is determined by the most significant group of bits in
+	// which the due tick differs from the current tick.
+	const std::uint64_t difference = dueTick ^ m_currentTick;
+	const std::uint32_t level = difference == 0 ?
+		0 : static_cast<std::uint32_t>(std::bit_width(difference) - 1) / bits_per_level;
 
-	auto firstCancelledEntry = std::find_if(
-		m_timerEntries.begin(),
-		m_timerEntries.end(),
-		isTimerCancelled);
-	if (firstCancelledEntry != m_timerEntries.end())
+	std::uint16_t slot = overflow_slot;
+	if (level < level_count)
 	{
-		auto nonCancelledEnd = firstCancelledEntry;
-		addTimerToList(nonCancelledEnd->m_timer);
+		const std::uint64_t slotInLevel = (dueTick >> (level * bits_per_level)) & slot_mask;
+		slot = static_cast<std::uint16_t>(level * slots_per_level + slotInLevel);
+		m_occupiedSlots[level] |= std::uint64_t(1) << slotInLevel;
+	}
 
-		for (auto iter = firstCancelledEntry + 1;
-			iter != m_timerEntries.end();
-			++iter)
-		{
-			if (isTimerCancelled(*iter))
-			{
-				addTimerToList(iter->m_timer);
-			}
-			else
-			{
-				*nonCancelledEnd++ = std::move(*iter);
-			}
-		}
+	auto*& head = m_slots[slot];
+	timer->m_prev = nullptr;
+	timer->m_next = head;
+	if (head != nullptr)
+	{
+		head->m_prev = timer;
+	}
+	head = timer;
 
-		m_timerEntries.erase(nonCancelledEnd, m_timerEntries.end());
+	timer->m_timerQueueSlot = slot;
+	++m_timerCount;
+}
+
+void io_service::timer_queue::unlink(
+	io_service::timed_schedule_operation* timer) noexcept
+{
+	const std::uint16_t slot = timer->m_timerQueueSlot;
 
-		std::make_heap(
-			m_timerEntries.begin(),
-			m_timerEntries.end(),
-			compare_entries);
+	if (timer->m_prev != nullptr)
+	{
+		timer->m_prev->m_next = timer->m_next;
+	}
+	else
+	{
+		m_slots[slot] = timer->m_next;
 	}
 
+	if (timer->m_next != nullptr)
 	{
-		timed_schedule_operation** current = &m_overflowTimers;
-		while ((*current) != nullptr)
-		{
-			auto* timer = (*current);
-			if (timer->m_cancellationToken.is_cancellation_requested())
-			{
-				*current = timer->m_next;
-				addTimerToList(timer);
-			}
-			else
-			{
-				current = &timer->m_next;
-			}
-		}
+		timer->m_next->m_prev = timer->m_prev;
+	}
+
+	if (m_slots[slot] == nullptr && slot != overflow_slot)
+	{
+		m_occupiedSlots[slot / slots_per_level] &= ~(std::uint64_t(1) << (slot % slots_per_level));
+	}
+
+	timer->m_timerQueueSlot = not_queued;
+	--m_timerCount;
+}
+
+io_service::timed_schedule_operation*
+io_service::timer_queue::take_slot(std::uint16_t slot) noexcept
+{
+	auto* timers = std::exchange(m_slots[slot], nullptr);
+	if (slot != overflow_slot)
+	{
+		m_occupiedSlots[slot / slots_per_level] &= ~(std::uint64_t(1) << (slot % slots_per_level));
+	}
+
+	for (auto* timer = timers; timer != nullptr; timer = timer->m_next)
+	{
+		timer->m_timerQueueSlot = not_queued;
+		--m_timerCount;
+	}
+
+	return timers;
+}
+
+void io_service::timer_queue::cascade(std::uint32_t level) noexcept
+{
+	const std::uint64_t slotInLevel = (m_currentTick >> (level * bits_per_level)) & slot_mask;
+	auto* timer = take_slot(static_cast<std::uint16_t>(level * slots_per_level + slotInLevel));
+	while (timer != nullptr)
+	{
+		auto* next = timer->m_next;
+		link(timer);
+		timer = next;
+	}
+}
+
+void io_service::timer_queue::cascade_overflow() noexcept
+{
+	auto* timer = take_slot(overflow_slot);
+	while (timer != nullptr)
+	{
+		auto* next = timer->m_next;
+		link(timer);
+		timer = next;
 	}
 }
 
 class io_service::timer_thread_state {
 public:
 
-	timer_thread_state();
+	explicit timer_thread_state(std::chrono::nanoseconds timerResolution);
 	~timer_thread_state();
 
 	timer_thread_state(const timer_thread_state& other) = delete;
 	timer_thread_state& operator=(const timer_thread_state& other) = delete;
 
-	void request_timer_cancellation() noexcept;
+	void request_timer_cancellation(io_service::timed_schedule_operation* timer) noexcept;
 
 	void run() noexcept;
 
+	void wait_for_wake_up(timer_queue::time_point dueTime) noexcept;
+
 	void wake_up_timer_thread() noexcept;
 
+#if CPPCORO_OS_LINUX
+	detail::lnx::safe_file_descriptor m_wakeUpEvent;
+#endif
+
+	const std::chrono::nanoseconds m_timerResolution;
+
 	std::atomic<io_service::timed_schedule_operation*> m_newlyQueuedTimers;
-	std::atomic<bool> m_timerCancellationRequested;
+	std::atomic<io_service::timed_schedule_operation*> m_cancelledTimers;
 	std::atomic<bool> m_shutDownRequested;
 
 	std::thread m_thread;
 };
 
 
+#if CPPCORO_OS_LINUX
+/// \brief
+/// Timer state used when timers are processed by the event loop.
+///
+/// Timers are held in a timer_queue that is shared by all I/O threads
+/// and protected by a spin-lock. A timerfd armed for the earliest time the
+/// queue needs servicing is read through the io_service's own I/O engine
+/// so that due timers are dequeued and resumed directly by whichever I/O
+/// thread receives the completion.
+class io_service::event_loop_timer_state : private detail::lnx::io_state
+{
+public:
+
+	event_loop_timer_state(io_service& service, std::chrono::nanoseconds timerResolution);
+	~event_loop_timer_state();
+
+	event_loop_timer_state(const event_loop_timer_state& other) = delete;
+	event_loop_timer_state& operator=(const event_loop_timer_state& other) = delete;
+
+	/// Queue the timer.
+	///
+	/// \return
+	/// false if cancellation of the timer was requested before it could be
+	/// queued, in which case the caller is responsible for resuming it.
+	bool try_enqueue_timer(timed_schedule_operation* timer) noexcept;
+
+	void request_timer_cancellation(timed_schedule_operation* timer) noexcept;
+
+	/// Restart the read of the timerfd if it could not be started earlier,
+	/// eg. because the submission queue was full, or if it failed.
+	///
+	/// Called by each I/O thread on every iteration of the event loop.
+	///
+	/// \return
+	/// true if the read still needs restarting, in which case the event loop
+	/// must not block waiting for an event as none may ever arrive.
+	bool retry_failed_read() noexcept;
+
+private:
+
+	static void on_timer_fd_read_completed(
+		detail::lnx::io_state* state,
+		std::int32_t result,
+		std::uint32_t flags) noexcept;
+
+	void process_due_timers() noexcept;
+
+	/// Re-arm the timerfd for the earliest time the queue needs servicing
+	/// and ensure there is a read of the timerfd outstanding.
+	///
+	/// Must be called with m_mutex held.
+	void update_timer_fd() noexcept;
+
+	io_service& m_service;
+	detail::lnx::safe_file_descriptor m_timerFd;
+
+	spin_mutex m_mutex;
+	timer_queue m_timerQueue;
+	timer_queue::time_point m_armedTime;
+	bool m_isReadPending;
+	std::uint64_t m_expirationCount;
+
+	// Set if the read of the timerfd could not be started, or failed,
+	// until it is restarted.
+	std::atomic<bool> m_isReadRetryNeeded;
+
+};
+
+io_service::event_loop_timer_state::event_loop_timer_state(
+	io_service& service,
+	std::chrono::nanoseconds timerResolution)
+	: detail::lnx::io_state(&event_loop_timer_state::on_timer_fd_read_completed)
+	, m_service(service)
+	// io_uring waits for a blocking read of the timerfd to complete, whereas
+	// a non-blocking read may fail with EAGAIN on older kernels. The epoll
+	// reactor needs it to be non-blocking as it reads once it is readable.
+	, m_timerFd(::timerfd_create(
+		CLOCK_MONOTONIC,
+		service.backend() == io_service_backend::epoll ?
+			TFD_NONBLOCK | TFD_CLOEXEC : TFD_CLOEXEC))
+	, m_timerQueue(timerResolution)
+	, m_armedTime(timer_queue::time_point::max())
+	, m_isReadPending(false)
+	, m_expirationCount(0)
+	, m_isReadRetryNeeded(false)
+{
+	if (m_timerFd == -1)
+	{
+		throw std::system_error
+		{
+			errno,
+			std::system_category(),
+			"Error creating io_service: timerfd_create"
+		};
+	}
+
+	m_opcode = detail::lnx::io_opcode::read;
+	m_fd = m_timerFd.fd();
+	m_buffer = &m_expirationCount;
+	m_length = sizeof(m_expirationCount);
+	m_offset = std::numeric_limits<std::uint64_t>::max();
+}
+
+io_service::event_loop_timer_state::~event_loop_timer_state()
+{
+	// Disarm the timer so that a read that is still outstanding never
+	// completes. It is cancelled when the I/O engine is destroyed.
+	const itimerspec disarm{};
+	(void)::timerfd_settime(m_timerFd.fd(), 0, &disarm, nullptr);
+}
+
+bool io_service::event_loop_timer_state::try_enqueue_timer(
+	timed_schedule_operation* timer) noexcept
+{
+	using timer_state = timed_schedule_operation::timer_state;
+
+	std::lock_guard lock{ m_mutex };
+
+	if (timer->m_state.load(std::memory_order_relaxed) == timer_state::cancellation_requested)
+	{
+		return false;
+	}
+
+	timer->m_state.store(timer_state::queued, std::memory_order_relaxed);
+	m_timerQueue.enqueue_timer(timer);
+	update_timer_fd();
+	return true;
+}
+
+void io_service::event_loop_timer_state::request_timer_cancellation(
+	timed_schedule_operation* timer) noexcept
+{
+	using timer_state = timed_schedule_operation::timer_state;
+
+	{
+		std::lock_guard lock{ m_mutex };
+
+		const auto state = timer->m_state.load(std::memory_order_relaxed);
+		if (state == timer_state::queuing)
+		{
+			// try_enqueue_timer() will see the request and not queue the timer.
+			timer->m_state.store(timer_state::cancellation_requested, std::memory_order_relaxed);
+			return;
+		}
+
+		if (state != timer_state::queued)
+		{
+			// Already fired.
+			return;
+		}
+
+		timer->m_state.store(timer_state::cancellation_requested, std::memory_order_relaxed);
+
+		// We don't bother re-arming the timerfd here. If this was the earliest
+		// timer then we'll just get a spurious wake-up.
+		m_timerQueue.remove_timer(timer);
+	}
+
+	if (timer->m_refCount.fetch_sub(1, std::memory_order_release) == 1)
+	{
+		m_service.schedule_impl(&timer->m_scheduleOperation);
+	}
+}
+
+bool io_service::event_loop_timer_state::retry_failed_read() noexcept
+{
+	if (!m_isReadRetryNeeded.load(std::memory_order_relaxed))
+	{
+		return false;
+	}
+
+	std::lock_guard lock{ m_mutex };
+	update_timer_fd();
+	return m_isReadRetryNeeded.load(std::memory_order_relaxed);
+}
+
+void io_service::event_loop_timer_state::on_timer_fd_read_completed(
+	detail::lnx::io_state* state,
+	std::int32_t result,
+	[[maybe_unused]] std::uint32_t flags) noexcept
+{
+	auto* timerState = static_cast<event_loop_timer_state*>(state);
+
+	if (result >= 0)
+	{
+		timerState->process_due_timers();
+		return;
+	}
+
+	std::lock_guard lock{ timerState->m_mutex };
+	timerState->m_isReadPending = false;
+
+	if (result == -ECANCELED || result == -EINTR)
+	{
+		// The read was interrupted before the timer expired, eg. older
+		// kernels cancel io_uring requests made by a thread that exits.
+		// The timerfd is still armed so just wait for it again.
+		timerState->update_timer_fd();
+	}
+	else
+	{
+		// Eg. -EAGAIN, which we don't expect as the timerfd is only
+		// non-blocking when the epoll reactor waits for it to be readable.
+		// Force the timerfd to be re-armed, as we don't know what state it
+		// was left in, and have the event loop restart the read. Restarting
+		// it straight away could spin until the timer expires, whereas the
+		// event loop processes any other events, and backs off, before it
+		// retries.
+		timerState->m_armedTime = timer_queue::time_point::min();
+		timerState->m_isReadRetryNeeded.store(true, std::memory_order_relaxed);
+	}
+}
+
+void io_service::event_loop_timer_state::process_due_timers() noexcept
+{
+	using timer_state = timed_schedule_operation::timer_state;
+
+	timed_schedule_operation* timersReadyToResume = nullptr;
+
+	{
+		std::lock_guard lock{ m_mutex };
+
+		// The timerfd is one-shot so it is no longer armed, unless this was a
+		// spurious completion in which case we'll just re-arm it anyway.
+		m_isReadPending = false;
+		m_armedTime = timer_queue::time_point::max();
+
+		m_timerQueue.dequeue_due_timers(
+			std::chrono::high_resolution_clock::now(),
+			timersReadyToResume);
+
+		for (auto* timer = timersReadyToResume; timer != nullptr; timer = timer->m_next)
+		{
+			timer->m_state.store(timer_state::fired, std::memory_order_relaxed);
+		}
+
+		update_timer_fd();
+	}
+
+	// Resume the last timer that becomes ready inline on this thread and
+	// reschedule the rest onto other I/O threads so that they can run in
+	// parallel.
+	timed_schedule_operation* timerToResume = nullptr;
+	while (timersReadyToResume != nullptr)
+	{
+		auto* timer = timersReadyToResume;
+		timersReadyToResume = timer->m_next;
+
+		if (timer->m_refCount.fetch_sub(1, std::memory_order_release) == 1)
+		{
+			if (timerToResume != nullptr)
+			{
+				m_service.schedule_impl(&timerToResume->m_scheduleOperation);
+			}
+
+			timerToResume = timer;
+		}
+	}
+
+	if (timerToResume != nullptr)
+	{
+		// Synchronise with the 'release' in await_suspend(), if it was the
+		// last to decrement the ref-count, before touching the awaiter.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		timerToResume->m_scheduleOperation.m_awaiter.resume();
+	}
+}
+
+void io_service::event_loop_timer_state::update_timer_fd() noexcept
+{
+	const auto dueTime = m_timerQueue.earliest_due_time();
+	if (dueTime != m_armedTime)
+	{
+		itimerspec spec{};
+		if (dueTime != timer_queue::time_point::max())
+		{
+			// A zero value disarms the timer so always wait for at least 1ns.
+			const auto delay = std::max(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(
+					dueTime - std::chrono::high_resolution_clock::now()),
+				std::chrono::nanoseconds{ 1 });
+			spec.it_value.tv_sec = static_cast<time_t>(delay.count() / 1'000'000'000);
+			spec.it_value.tv_nsec = static_cast<long>(delay.count() % 1'000'000'000);
+		}
+
+		if (::timerfd_settime(m_timerFd.fd(), 0, &spec, nullptr) == 0)
+		{
+			m_armedTime = dueTime;
+		}
+	}
+
+	if (m_armedTime != timer_queue::time_point::max() && !m_isReadPending)
+	{
+		// A read of the timerfd never completes synchronously so this
+		// only fails if the read could not be started at all. The
+		// timerfd stays armed, so have the event loop retry the read.
+		std::int32_t result;
+		m_isReadPending = m_service.try_start_io(*this, result);
+	}
+
+	m_isReadRetryNeeded.store(
+		m_armedTime != timer_queue::time_point::max() && !m_isReadPending,
+		std::memory_order_relaxed);
+}
+#endif
+
 io_service::io_service()
 	: io_service(0)
 {
 }
 
 io_service::io_service(std::uint32_t concurrencyHint)
+	: io_service(concurrencyHint, io_service_backend::automatic)
+{
+}
+
+io_service::io_service(std::uint32_t concurrencyHint, io_service_backend backend)
+	: io_service(io_service_options{ concurrencyHint, backend })
+{
+}
+
+io_service::io_service(const io_service_options& options)
 	: m_threadState(0)
 	, m_workCount(0)
+	, m_busyPollDuration(options.busyPollDuration)
+	, m_busyPollCount(0)
+	, m_productiveBusyPollCount(0)
 #if CPPCORO_OS_WINNT
-	, m_iocpHandle(create_io_completion_port(concurrencyHint))
+	, m_iocpHandle(create_io_completion_port(options.concurrencyHint))
 	, m_winsockInitialised(false)
 	, m_winsockInitialisationMutex()
+#endif
+#if CPPCORO_OS_LINUX
+	// The concurrencyHint is not enforced on Linux. All threads that enter
+	// the event loop actively process events.
+	, m_ioEngine(detail::lnx::create_io_engine(options, local::submission_queue_size))
 #endif
 	, m_scheduleOperations(nullptr)
+	, m_timerResolution(options.timerResolution)
 	, m_timerState(nullptr)
 {
+	assert(m_timerResolution.count() > 0);
+
+#if CPPCORO_OS_LINUX
+	if (options.timerMode == io_service_timer_mode::event_loop)
+	{
+		m_eventLoopTimerState = std::make_unique<event_loop_timer_state>(
+			*this, m_timerResolution);
+	}
+#endif
 }
 
 io_service::~io_service()
@@ -396,13 +944,163 @@ void io_service::notify_work_finished() noexcept
 	}
 }
 
+io_service::busy_poll_stats io_service::get_busy_poll_stats() const noexcept
+{
+	busy_poll_stats stats;
+	stats.pollCount = m_busyPollCount.load(std::memory_order_relaxed);
+	stats.productivePollCount = m_productiveBusyPollCount.load(std::memory_order_relaxed);
+	return stats;
+}
+
+#if CPPCORO_OS_LINUX
+io_service_backend io_service::backend() const noexcept
+{
+	return m_ioEngine->backend();
+}
+
+bool io_service::is_submission_polling_enabled() const noexcept
+{
+	return m_ioEngine->is_submission_polling_enabled();
+}
+
+void io_service::register_file(detail::lnx::fd_t fd)
+{
+	const int errorCode = m_ioEngine->register_file(fd);
+	if (errorCode != 0)
+	{
+		throw std::system_error
+		{
+			errorCode,
+			std::system_category(),
+			"Error registering file descriptor with io_service"
+		};
+	}
+}
+
+void io_service::unregister_file(detail::lnx::fd_t fd) noexcept
+{
+	m_ioEngine->unregister_file(fd);
+}
+
+void io_service::register_buffers(std::span<const std::span<std::byte>> buffers)
+{
+	const int errorCode = m_ioEngine->register_buffers(buffers);
+	if (errorCode != 0)
+	{
+		throw std::system_error
+		{
+			errorCode,
+			std::system_category(),
+			"Error registering buffers with io_service"
+		};
+	}
+}
+
+void io_service::unregister_buffers() noexcept
+{
+	m_ioEngine->unregister_buffers();
+}
+
+void io_service::register_buffer_group(detail::lnx::io_buffer_group& group)
+{
+	const int errorCode = m_ioEngine->register_buffer_group(group);
+	if (errorCode != 0)
+	{
+		throw std::system_error
+		{
+			errorCode,
+			std::system_category(),
+			"Error registering buffer group with io_service"
+		};
+	}
+}
+
+void io_service::unregister_buffer_group(detail::lnx::io_buffer_group& group) noexcept
+{
+	m_ioEngine->unregister_buffer_group(group);
+}
+
+void io_service::recycle_buffer(
+	detail::lnx::io_buffer_group& group,
+	std::uint16_t bufferId) noexcept
+{
+	m_ioEngine->recycle_buffer(group, bufferId);
+}
+
+bool io_service::try_start_io(detail::lnx::io_state& state, std::int32_t& result) noexcept
+{
+	return m_ioEngine->try_start(state, result);
+}
+
+void io_service::cancel_io(detail::lnx::io_state& state) noexcept
+{
+	m_ioEngine->cancel(state);
+}
+#endif
 
 void io_service::schedule_impl(schedule_operation* operation) noexcept
 {
+#if CPPCORO_OS_LINUX
+	const auto userData = reinterpret_cast<std::uintptr_t>(operation->m_awaiter.address());
+	assert((userData & local::scheduled_coroutine_tag) == 0);
+
+	const bool ok = m_ioEngine->try_post(userData | local::scheduled_coroutine_tag);
+	if (!ok)
+	{
+		// Failed to post to the submission queue.
+		//
+		// This is most-likely because the queue is currently full.
+		//
+		// We'll queue up the operation to a linked-list using a lock-free
+		// push and defer the dispatch to the submission queue until some
+		// I/O thread next enters its event loop.
+		auto* head = m_scheduleOperations.load(std::memory_order_acquire);
+		do
+		{
+			operation->m_next = head;
+		} while (!m_scheduleOperations.compare_exchange_weak(
+			head,
+			operation,
+			std::memory_order_release,
+			std::memory_order_acquire));
+	}
+#endif
 }
 
 void io_service::try_reschedule_overflow_operations() noexcept
 {
+#if CPPCORO_OS_LINUX
+	auto* operation = m_scheduleOperations.exchange(nullptr, std::memory_order_acquire);
+	while (operation != nullptr)
+	{
+		auto* next = operation->m_next;
+		const auto userData = reinterpret_cast<std::uintptr_t>(operation->m_awaiter.address());
+		if (!m_ioEngine->try_post(userData | local::scheduled_coroutine_tag))
+		{
+			// Still unable to queue these operations.
+			// Put them back on the list of overflow operations.
+			auto* tail = operation;
+			while (tail->m_next != nullptr)
+			{
+				tail = tail->m_next;
+			}
+
+			schedule_operation* head = nullptr;
+			while (!m_scheduleOperations.compare_exchange_weak(
+				head,
+				operation,
+				std::memory_order_release,
+				std::memory_order_relaxed))
+			{
+				tail->m_next = head;
+			}
+
+			return;
+		}
+
+		operation = next;
+	}
+#endif
 }
 
 bool io_service::try_enter_event_loop() noexcept
@@ -429,11 +1127,143 @@ void io_service::exit_event_loop() noexcept
 
 bool io_service::try_process_one_event(bool waitForEvent)
 {
+#if CPPCORO_OS_LINUX
+	if (is_stop_requested())
+	{
+		return false;
+	}
+
+	// Spin polling for a completion for up to m_busyPollDuration before
+	// blocking so that we avoid the cost of going to sleep in the kernel and
+	// being woken up again when events arrive in quick succession.
+	auto busyPoll = [this](detail::lnx::io_engine::completion& completion)
+	{
+		if (m_busyPollDuration.count() <= 0)
+		{
+			return false;
+		}
+
+		m_busyPollCount.fetch_add(1, std::memory_order_relaxed);
+
+		const auto deadline = std::chrono::steady_clock::now() + m_busyPollDuration;
+
+		spin_wait wait;
+		do
+		{
+			// Keep spinning on this CPU rather than yielding the time-slice.
+			if (wait.next_spin_will_yield())
+			{
+				wait.reset();
+			}
+
+			wait.spin_one();
+
+			if (m_ioEngine->try_dequeue(completion, false))
+			{
+				m_productiveBusyPollCount.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+		} while (!is_stop_requested() && std::chrono::steady_clock::now() < deadline);
+
+		return false;
+	};
+
+	// Backs off retrying a read of the timerfd that keeps failing.
+	spin_wait timerReadRetryWait;
+
+	while (true)
+	{
+		// Check for any schedule_operation objects that were unable to be
+		// queued to the submission queue and try to requeue them now.
+		try_reschedule_overflow_operations();
+
+		const bool isTimerReadRetryNeeded =
+			m_eventLoopTimerState && m_eventLoopTimerState->retry_failed_read();
+
+		detail::lnx::io_engine::completion completion;
+		if (!m_ioEngine->try_dequeue(completion, false))
+		{
+			if (!waitForEvent)
+			{
+				return false;
+			}
+
+			if (isTimerReadRetryNeeded)
+			{
+				// Nothing may wake us up until the read is restarted, so
+				// poll for events until then rather than blocking.
+				timerReadRetryWait.spin_one();
+				if (is_stop_requested())
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			timerReadRetryWait.reset();
+
+			if (!busyPoll(completion) &&
+				!m_ioEngine->try_dequeue(completion, true))
+			{
+				// The wait was interrupted before a completion became available.
+				continue;
+			}
+		}
+
+		if (completion.m_userData == local::wake_up_user_data)
+		{
+			// A wake-up event is typically associated with a request to
+			// exit the event loop.
+			// However, there may be spurious such events remaining in the
+			// queue from a previous call to stop() that has since been
+			// reset() so we need to check whether stop is still required.
+			if (is_stop_requested())
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		// Any operations started while processing this event are handed
+		// to the kernel in a single call once we have finished with it.
+		detail::lnx::io_engine::submission_batch batch{ *m_ioEngine };
+
+		if ((completion.m_userData & local::scheduled_coroutine_tag) != 0)
+		{
+			// This was a coroutine scheduled via a call to io_service::schedule().
+			std::coroutine_handle<>::from_address(
+				reinterpret_cast<void*>(
+					static_cast<std::uintptr_t>(
+						completion.m_userData & ~local::scheduled_coroutine_tag))).resume();
+		}
+		else
+		{
+			// This was an I/O operation started via try_start_io().
+			auto* state = reinterpret_cast<detail::lnx::io_state*>(
+				static_cast<std::uintptr_t>(completion.m_userData));
+			state->m_callback(state, completion.m_result, completion.m_flags);
+		}
+
+		return true;
+	}
+#else
 	return false;
+#endif
 }
 
 void io_service::post_wake_up_event() noexcept
 {
+#if CPPCORO_OS_LINUX
+	// We intentionally ignore the return value here.
+	//
+	// Assume that if posting an event failed that it failed because the
+	// submission queue was full. If that's the case then threads should
+	// find other events in the queue next time they check anyway and
+	// thus wake-up.
+	(void)m_ioEngine->try_post(local::wake_up_user_data);
+#endif
 }
 
 io_service::timer_thread_state*
@@ -442,7 +1272,7 @@ io_service::ensure_timer_thread_started()
 	auto* timerState = m_timerState.load(std::memory_order_acquire);
 	if (timerState == nullptr)
 	{
-		auto newTimerState = std::make_unique<timer_thread_state>();
+		auto newTimerState = std::make_unique<timer_thread_state>(m_timerResolution);
 		if (m_timerState.compare_exchange_strong(
 			timerState,
 			newTimerState.get(),
@@ -459,12 +1289,31 @@ io_service::ensure_timer_thread_started()
 	return timerState;
 }
 
-io_service::timer_thread_state::timer_thread_state() :
-	m_newlyQueuedTimers(nullptr), 
-	m_timerCancellationRequested(false),
-	m_shutDownRequested(false),
-	m_thread([this] { this->run(); })
+io_service::timer_thread_state::timer_thread_state(
+	std::chrono::nanoseconds timerResolution)
+#if CPPCORO_OS_LINUX
+	: m_wakeUpEvent(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+	, m_timerResolution(timerResolution)
+#else
+	: m_timerResolution(timerResolution)
+#endif
+	, m_newlyQueuedTimers(nullptr)
+	, m_cancelledTimers(nullptr)
+	, m_shutDownRequested(false)
 {
+#if CPPCORO_OS_LINUX
+	if (m_wakeUpEvent == -1)
+	{
+		throw std::system_error
+		{
+			errno,
+			std::system_category(),
+			"Error creating timer thread: eventfd"
+		};
+	}
+#endif
+
+	m_thread = std::thread([this] { this->run(); });
 }
 
 io_service::timer_thread_state::~timer_thread_state()
@@ -474,11 +1323,20 @@ io_service::timer_thread_state::~timer_thread_state()
 	m_thread.join();
 }
 
-void io_service::timer_thread_state::request_timer_cancellation() noexcept
+void io_service::timer_thread_state::request_timer_cancellation(
+	io_service::timed_schedule_operation* timer) noexcept
 {
-	const bool wasTimerCancellationAlreadyRequested =
-		m_timerCancellationRequested.exchange(true, std::memory_order_release);
-	if (!wasTimerCancellationAlreadyRequested)
+	auto* prev = m_cancelledTimers.load(std::memory_order_acquire);
+	do
+	{
+		timer->m_nextCancelled = prev;
+	} while (!m_cancelledTimers.compare_exchange_weak(
+		prev,
+		timer,
+		std::memory_order_release,
+		std::memory_order_acquire));
+
+	if (prev == nullptr)
 	{
 		wake_up_timer_thread();
 	}
@@ -486,10 +1344,144 @@ void io_service::timer_thread_state::request_timer_cancellation() noexcept
 
 void io_service::timer_thread_state::run() noexcept
 {
+	using clock = std::chrono::high_resolution_clock;
+	using time_point = clock::time_point;
+
+	timer_queue timerQueue{ m_timerResolution };
+
+	time_point earliestDueTime = time_point::max();
+
+	timed_schedule_operation* timersReadyToResume = nullptr;
+
+	while (!m_shutDownRequested.load(std::memory_order_relaxed))
+	{
+		wait_for_wake_up(earliestDueTime);
+
+		// We are woken up for:
+		// - handling timer cancellation
+		// - handling newly queued timers
+		// - handling timers becoming due
+		// - shutdown
+		//
+		// The list of cancelled timers must be taken before the list of
+		// newly queued timers. A timer is only ever queued for cancellation
+		// after it has been queued to the timer thread so this guarantees
+		// that we have taken ownership of every cancelled timer we see.
+		auto* cancelledTimers = m_cancelledTimers.exchange(nullptr, std::memory_order_acquire);
+
+		// Handle newly queued timers
+		auto* newTimers = m_newlyQueuedTimers.exchange(nullptr, std::memory_order_acquire);
+		while (newTimers != nullptr)
+		{
+			auto* timer = newTimers;
+			newTimers = timer->m_next;
+			timerQueue.enqueue_timer(timer);
+		}
+
+		// Handle cancelled timers
+		while (cancelledTimers != nullptr)
+		{
+			auto* timer = cancelledTimers;
+			cancelledTimers = timer->m_nextCancelled;
+
+			// The timer may have already been taken out of the queue if it
+			// became due after cancellation was requested.
+			timerQueue.remove_timer(timer);
+
+			timer->m_next = timersReadyToResume;
+			timersReadyToResume = timer;
+		}
+
+		if (!timerQueue.is_empty())
+		{
+			timed_schedule_operation* dueTimers = nullptr;
+			timerQueue.dequeue_due_timers(clock::now(), dueTimers);
+
+			while (dueTimers != nullptr)
+			{
+				auto* timer = dueTimers;
+				dueTimers = timer->m_next;
+
+				// If cancellation has been requested then the timer is on its
+				// way to us via the list of cancelled timers and will be
+				// resumed when we process that list instead.
+				auto state = timer->m_state.load(std::memory_order_acquire);
+				using timer_state = timed_schedule_operation::timer_state;
+				while (state != timer_state::cancellation_requested &&
+					!timer->m_state.compare_exchange_weak(
+						state,
+						timer_state::fired,
+						std::memory_order_acq_rel,
+						std::memory_order_acquire))
+				{
+				}
+
+				if (state != timer_state::cancellation_requested)
+				{
+					timer->m_next = timersReadyToResume;
+					timersReadyToResume = timer;
+				}
+			}
+		}
+
+		earliestDueTime = timerQueue.earliest_due_time();
+
+		// Now schedule any ready-to-run timers.
+		while (timersReadyToResume != nullptr)
+		{
+			auto* timer = timersReadyToResume;
+			auto* nextTimer = timer->m_next;
+
+			// Use 'release' memory order to ensure that any prior writes to
+			// m_next "happen before" any potential uses of that same memory
+			// back on the thread that is executing timed_schedule_operation::await_suspend()
+			// which has the synchronising 'acquire' semantics.
+			if (timer->m_refCount.fetch_sub(1, std::memory_order_release) == 1)
+			{
+				timer->m_scheduleOperation.m_service.schedule_impl(
+					&timer->m_scheduleOperation);
+			}
+
+			timersReadyToResume = nextTimer;
+		}
+	}
+}
+
+void io_service::timer_thread_state::wait_for_wake_up(
+	timer_queue::time_point dueTime) noexcept
+{
+#if CPPCORO_OS_LINUX
+	timespec timeout;
+	timespec* timeoutPtr = nullptr;
+	if (dueTime != timer_queue::time_point::max())
+	{
+		const auto delay = std::max(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(
+				dueTime - std::chrono::high_resolution_clock::now()),
+			std::chrono::nanoseconds::zero());
+		timeout.tv_sec = static_cast<time_t>(delay.count() / 1'000'000'000);
+		timeout.tv_nsec = static_cast<long>(delay.count() % 1'000'000'000);
+		timeoutPtr = &timeout;
+	}
+
+	pollfd waitFd{ m_wakeUpEvent.fd(), POLLIN, 0 };
+
+	// We ignore failures here (eg. EINTR) and just treat them as a spurious
+	// wake-up so that we remain responsive to new timers and cancellation.
+	if (::ppoll(&waitFd, 1, timeoutPtr, nullptr) > 0)
+	{
+		std::uint64_t value;
+		(void)::read(m_wakeUpEvent.fd(), &value, sizeof(value));
+	}
+#endif
 }
 
 void io_service::timer_thread_state::wake_up_timer_thread() noexcept
 {
+#if CPPCORO_OS_LINUX
+	const std::uint64_t value = 1;
+	(void)::write(m_wakeUpEvent.fd(), &value, sizeof(value));
+#endif
 }
 
 void io_service::schedule_operation::await_suspend(
@@ -506,6 +1498,11 @@ io_service::timed_schedule_operation::timed_schedule_operation(
 	: m_scheduleOperation(service)
 	, m_resumeTime(resumeTime)
 	, m_cancellationToken(std::move(cancellationToken))
+	, m_next(nullptr)
+	, m_prev(nullptr)
+	, m_nextCancelled(nullptr)
+	, m_timerQueueSlot(timer_queue::not_queued)
+	, m_state(timer_state::queuing)
 	, m_refCount(2)
 {
 }
@@ -515,6 +1512,11 @@ io_service::timed_schedule_operation::timed_schedule_operation(
 	: m_scheduleOperation(std::move(other.m_scheduleOperation))
 	, m_resumeTime(std::move(other.m_resumeTime))
 	, m_cancellationToken(std::move(other.m_cancellationToken))
+	, m_next(nullptr)
+	, m_prev(nullptr)
+	, m_nextCancelled(nullptr)
+	, m_timerQueueSlot(timer_queue::not_queued)
+	, m_state(timer_state::queuing)
 	, m_refCount(2)
 {
 }
@@ -535,14 +1537,64 @@ void io_service::timed_schedule_operation::await_suspend(
 
 	auto& service = m_scheduleOperation.m_service;
 
+#if CPPCORO_OS_LINUX
+	if (service.m_eventLoopTimerState)
+	{
+		auto* timerState = service.m_eventLoopTimerState.get();
+
+		if (m_cancellationToken.can_be_cancelled())
+		{
+			m_cancellationRegistration.emplace(m_cancellationToken, [this, timerState]
+			{
+				timerState->request_timer_cancellation(this);
+			});
+		}
+
+		if (!timerState->try_enqueue_timer(this))
+		{
+			// Cancellation was requested before we could queue the timer.
+			service.schedule_impl(&m_scheduleOperation);
+			return;
+		}
+
+		// As with the timer thread, the timer could be resumed by an I/O
+		// thread as soon as it has been queued so we use the same
+		// ref-count dance as below.
+		if (m_refCount.fetch_sub(1, std::memory_order_acquire) == 1)
+		{
+			service.schedule_impl(&m_scheduleOperation);
+		}
+
+		return;
+	}
+#endif
+
 	// Ensure the timer state is initialised and the timer thread started.
 	auto* timerState = service.ensure_timer_thread_started();
 
 	if (m_cancellationToken.can_be_cancelled())
 	{
-		m_cancellationRegistration.emplace(m_cancellationToken, [timerState]
+		m_cancellationRegistration.emplace(m_cancellationToken, [this, timerState]
 		{
-			timerState->request_timer_cancellation();
+			// If the timer is still being queued then leave it to the queueing
+			// thread to pass on the cancellation request, otherwise pass it on
+			// to the timer thread ourselves unless the timer has already fired.
+			auto state = m_state.load(std::memory_order_acquire);
+			while (state == timer_state::queuing || state == timer_state::queued)
+			{
+				if (m_state.compare_exchange_weak(
+					state,
+					timer_state::cancellation_requested,
+					std::memory_order_acq_rel,
+					std::memory_order_acquire))
+				{
+					if (state == timer_state::queued)
+					{
+						timerState->request_timer_cancellation(this);
+					}
+					break;
+				}
+			}
 		});
 	}
 
@@ -583,6 +1635,22 @@ void io_service::timed_schedule_operation::await_suspend(
 		timerState->wake_up_timer_thread();
 	}
 
+	// Timers may only be queued for cancellation once they have been
+	// queued to the timer thread, otherwise the timer thread could see
+	// the cancellation before the timer itself. If cancellation was
+	// requested while we were queueing the timer then it is up to us to
+	// pass the request on.
+	auto state = timer_state::queuing;
+	if (!m_state.compare_exchange_strong(
+		state,
+		timer_state::queued,
+		std::memory_order_acq_rel,
+		std::memory_order_acquire) &&
+		state == timer_state::cancellation_requested)
+	{
+		timerState->request_timer_cancellation(this);
+	}
+
 	// Use 'acquire' semantics here to synchronise with the 'release'
 	// operation performed on the timer thread to ensure that we have
 	// seen all potential writes to this object. Without this, it's
@@ -0,0 +1,201 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cppcoro/io_service_group.hpp>
+
+#if CPPCORO_OS_WINNT
+# ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+# endif
+# include <Windows.h>
+#elif CPPCORO_OS_LINUX
+# include <pthread.h>
+# include <sched.h>
+#endif
+
+namespace
+{
+	namespace local
+	{
+		/// Pin the current thread to the CPU with the specified index amongst
+		/// the CPUs the process is allowed to run on.
+		///
+		/// Failing to pin the thread is not fatal, the shard will still work,
+		/// so errors are ignored.
+		void pin_current_thread(std::uint32_t cpuIndex) noexcept
+		{
+#if CPPCORO_OS_WINNT
+			DWORD_PTR processMask;
+			DWORD_PTR systemMask;
+			if (!::GetProcessAffinityMask(::GetCurrentProcess(), &processMask, &systemMask) ||
+				processMask == 0)
+			{
+				return;
+			}
+
+			std::uint32_t allowedCount = 0;
+			for (DWORD_PTR bit = 1; bit != 0; bit <<= 1)
+			{
+				if ((processMask & bit) != 0)
+				{
+					++allowedCount;
+				}
+			}
+
+			cpuIndex %= allowedCount;
+
+			for (DWORD_PTR bit = 1; bit != 0; bit <<= 1)
+			{
+				if ((processMask & bit) != 0 && cpuIndex-- == 0)
+				{
+					(void)::SetThreadAffinityMask(::GetCurrentThread(), bit);
+					return;
+				}
+			}
+#elif CPPCORO_OS_LINUX
+			cpu_set_t allowed;
+			CPU_ZERO(&allowed);
+			if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+			{
+				return;
+			}
+
+			const int allowedCount = CPU_COUNT(&allowed);
+			if (allowedCount == 0)
+			{
+				return;
+			}
+
+			cpuIndex %= static_cast<std::uint32_t>(allowedCount);
+
+			for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+			{
+				if (CPU_ISSET(cpu, &allowed) && cpuIndex-- == 0)
+				{
+					cpu_set_t pinned;
+					CPU_ZERO(&pinned);
+					CPU_SET(cpu, &pinned);
+					(void)::pthread_setaffinity_np(::pthread_self(), sizeof(pinned), &pinned);
+					return;
+				}
+			}
+#else
+			(void)cpuIndex;
+#endif
+		}
+	}
+}
+
+namespace cppcoro
+{
+	thread_local const io_service_group* io_service_group::s_currentGroup = nullptr;
+	thread_local io_service* io_service_group::s_currentShard = nullptr;
+
+	io_service_group::io_service_group()
+		: io_service_group(0)
+	{
+	}
+
+	io_service_group::io_service_group(std::uint32_t shardCount)
+		: io_service_group(shardCount, io_service_options{})
+	{
+	}
+
+	io_service_group::io_service_group(
+		std::uint32_t shardCount,
+		const io_service_options& options)
+		: m_nextShardIndex(0)
+	{
+		if (shardCount == 0)
+		{
+			shardCount = std::thread::hardware_concurrency();
+			if (shardCount == 0)
+			{
+				shardCount = 1;
+			}
+		}
+
+		auto shardOptions = options;
+		shardOptions.concurrencyHint = 1;
+
+		m_shards.reserve(shardCount);
+		for (std::uint32_t i = 0; i < shardCount; ++i)
+		{
+			m_shards.push_back(std::make_unique<io_service>(shardOptions));
+		}
+
+		m_threads.reserve(shardCount);
+		try
+		{
+			for (std::uint32_t i = 0; i < shardCount; ++i)
+			{
+				m_threads.emplace_back([this, i] { this->run_shard(i); });
+			}
+		}
+		catch (...)
+		{
+			shutdown();
+			throw;
+		}
+	}
+
+	io_service_group::~io_service_group()
+	{
+		shutdown();
+	}
+
+	io_service* io_service_group::current_shard() const noexcept
+	{
+		return s_currentGroup == this ? s_currentShard : nullptr;
+	}
+
+	io_service::schedule_operation io_service_group::schedule() noexcept
+	{
+		if (auto* shard = current_shard(); shard != nullptr)
+		{
+			return shard->schedule();
+		}
+
+		const auto index = m_nextShardIndex.fetch_add(1, std::memory_order_relaxed);
+		return m_shards[index % m_shards.size()]->schedule();
+	}
+
+	void io_service_group::stop() noexcept
+	{
+		for (auto& shard : m_shards)
+		{
+			shard->stop();
+		}
+	}
+
+	void io_service_group::run_shard(std::uint32_t shardIndex) noexcept
+	{
+		local::pin_current_thread(shardIndex);
+
+		auto& shard = *m_shards[shardIndex];
+
+		s_currentGroup = this;
+		s_currentShard = &shard;
+
+		// process_events() only throws if the event loop is unable to wait
+		// for events, at which point the shard is unusable and we terminate.
+		shard.process_events();
+
+		s_currentGroup = nullptr;
+		s_currentShard = nullptr;
+	}
+
+	void io_service_group::shutdown() noexcept
+	{
+		stop();
+
+		for (auto& thread : m_threads)
+		{
+			thread.join();
+		}
+
+		m_threads.clear();
+	}
+}
@@ -0,0 +1,1342 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "io_uring_queue.hpp"
+
+#include <cppcoro/on_scope_exit.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace
+{
+	namespace local
+	{
+		// Allow many more completions to be outstanding than there are
+		// submission slots since we keep many more operations in flight
+		// than we submit in a single batch.
+		constexpr std::uint32_t completion_queue_size_multiplier = 8;
+
+		// Number of slots in the registered file table.
+		constexpr std::uint32_t registered_file_table_size = 1024;
+
+		// The io_uring system calls are not wrapped by glibc.
+		int io_uring_register(
+			int fd,
+			std::uint32_t opcode,
+			const void* arg,
+			std::uint32_t argCount) noexcept
+		{
+			return static_cast<int>(::syscall(
+				__NR_io_uring_register, fd, opcode, arg, argCount));
+		}
+
+		int io_uring_setup(std::uint32_t entries, io_uring_params* params) noexcept
+		{
+			return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+		}
+
+		int io_uring_enter(
+			int fd,
+			std::uint32_t toSubmit,
+			std::uint32_t minComplete,
+			std::uint32_t flags) noexcept
+		{
+			return static_cast<int>(::syscall(
+				__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+		}
+
+		// The ring head/tail indices are shared with the kernel and must be
+		// accessed with the appropriate barriers.
+		std::uint32_t load_acquire(const std::uint32_t* p) noexcept
+		{
+			return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+		}
+
+		void store_release(std::uint32_t* p, std::uint32_t value) noexcept
+		{
+			__atomic_store_n(p, value, __ATOMIC_RELEASE);
+		}
+
+		void* offset_by(void* p, std::uint32_t offset) noexcept
+		{
+			return static_cast<char*>(p) + offset;
+		}
+
+		void* map_ring(int fd, std::size_t size, std::uint64_t offset, const char* what)
+		{
+			void* p = ::mmap(
+				nullptr,
+				size,
+				PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_POPULATE,
+				fd,
+				static_cast<off_t>(offset));
+			if (p == MAP_FAILED)
+			{
+				throw std::system_error
+				{
+					errno,
+					std::system_category(),
+					what
+				};
+			}
+
+			return p;
+		}
+
+		/// Create the io_uring, dropping optional features that the kernel
+		/// or the process' privileges don't allow.
+		///
+		/// \return
+		/// The io_uring file descriptor or -1 with errno set on failure.
+		int setup_ring(
+			std::uint32_t entries,
+			const cppcoro::io_service_options& options,
+			io_uring_params& params) noexcept
+		{
+			bool useCompletionQueueSize = true;
+			bool useSubmissionPolling = options.submissionPolling;
+
+			while (true)
+			{
+				std::memset(&params, 0, sizeof(params));
+
+				if (useCompletionQueueSize)
+				{
+					params.flags |= IORING_SETUP_CQSIZE;
+					params.cq_entries = entries * completion_queue_size_multiplier;
+				}
+
+				if (useSubmissionPolling)
+				{
+					params.flags |= IORING_SETUP_SQPOLL;
+					params.sq_thread_idle = static_cast<std::uint32_t>(
+						options.submissionPollIdleTimeout.count());
+					if (options.submissionPollCpu)
+					{
+						params.flags |= IORING_SETUP_SQ_AFF;
+						params.sq_thread_cpu = *options.submissionPollCpu;
+					}
+				}
+
+				const int fd = io_uring_setup(entries, &params);
+				if (fd >= 0)
+				{
+					if (useSubmissionPolling &&
+						(params.features & IORING_FEAT_SQPOLL_NONFIXED) == 0)
+					{
+						// Older kernels only allow submission polling on
+						// registered files, which we don't use.
+						::close(fd);
+						useSubmissionPolling = false;
+						continue;
+					}
+
+					return fd;
+				}
+
+				if (useSubmissionPolling && errno == EPERM)
+				{
+					// Kernels before 5.11 require CAP_SYS_ADMIN for SQPOLL.
+					useSubmissionPolling = false;
+				}
+				else if (useCompletionQueueSize && errno == EINVAL)
+				{
+					// Older kernels don't support IORING_SETUP_CQSIZE.
+					// Fall back to the default completion queue size.
+					useCompletionQueueSize = false;
+				}
+				else if (useSubmissionPolling && errno == EINVAL)
+				{
+					// Eg. the requested CPU for the polling thread is not valid.
+					useSubmissionPolling = false;
+				}
+				else
+				{
+					return -1;
+				}
+			}
+		}
+
+		// User-data for completions of entries submitted for the queue's own
+		// bookkeeping (eg. cancellation requests). These are swallowed rather
+		// than being returned from try_dequeue(). The value can't collide with
+		// the address of an io_state or with a tagged coroutine address.
+		constexpr std::uint64_t internal_user_data = 2;
+
+		// User-data of a poll or no-op entry submitted on behalf of an
+		// operation that io_uring can't perform itself, is the address of the
+		// operation's io_state tagged with this value. io_states are at least
+		// 8-byte aligned and the other user-data values never have this bit set.
+		constexpr std::uint64_t user_data_tag_mask = 7;
+		constexpr std::uint64_t polled_operation_tag = 4;
+
+		/// Query whether the user-data of a completion is that of an
+		/// operation, rather than a value passed to try_post(), which are
+		/// either zero or tagged coroutine addresses.
+		bool is_operation_user_data(std::uint64_t userData) noexcept
+		{
+			return userData != 0 && (userData & 1) == 0;
+		}
+
+		/// Query whether an operation is performed by us once a poll for its
+		/// file descriptor completes, rather than by io_uring.
+		///
+		/// copy_file_range operations are also performed by us, once a no-op
+		/// completes, so that they are performed by an I/O thread.
+		bool is_polled_operation(const cppcoro::detail::lnx::io_state& state) noexcept
+		{
+			switch (state.m_opcode)
+			{
+			case cppcoro::detail::lnx::io_opcode::copy_file_range:
+			case cppcoro::detail::lnx::io_opcode::sendmmsg:
+			case cppcoro::detail::lnx::io_opcode::recvmmsg:
+			case cppcoro::detail::lnx::io_opcode::sendfile:
+				return true;
+			case cppcoro::detail::lnx::io_opcode::recv_select_buffer:
+				// Unless the kernel picks the buffer from a buffer ring.
+				return static_cast<const cppcoro::detail::lnx::io_buffer_group*>(
+					state.m_buffer)->m_ring == nullptr;
+			default:
+				return false;
+			}
+		}
+
+		/// The user-data to submit an operation with.
+		std::uint64_t user_data_for(const cppcoro::detail::lnx::io_state& state) noexcept
+		{
+			const auto userData = reinterpret_cast<std::uintptr_t>(&state);
+			return is_polled_operation(state) ? userData | polled_operation_tag : userData;
+		}
+
+		// We don't use io_uring_buf_ring as the empty struct that it uses to
+		// declare its flexible array member has a non-zero size in C++, which
+		// moves the entries away from the start of the ring.
+
+		io_uring_buf* buffer_ring_entries(void* ring) noexcept
+		{
+			return static_cast<io_uring_buf*>(ring);
+		}
+
+		/// The tail of a buffer ring is shared with the kernel and overlays
+		/// the reserved field of the ring's first entry.
+		std::uint16_t* buffer_ring_tail(void* ring) noexcept
+		{
+			return &buffer_ring_entries(ring)->resv;
+		}
+	}
+}
+
+cppcoro::detail::lnx::io_uring_queue::io_uring_queue(
+	std::uint32_t entries,
+	const io_service_options& options)
+	: m_sqRing(nullptr)
+	, m_sqRingSize(0)
+	, m_cqRing(nullptr)
+	, m_cqRingSize(0)
+	, m_sqes(nullptr)
+	, m_sqesSize(0)
+	, m_isFileTableRegistered(false)
+	, m_nextBufferGroupId(0)
+	, m_hasDeferredCancels(false)
+{
+	io_uring_params params;
+	const int fd = local::setup_ring(entries, options, params);
+	if (fd < 0)
+	{
+		throw std::system_error
+		{
+			errno,
+			std::system_category(),
+			"Error creating io_service: io_uring_setup"
+		};
+	}
+
+	m_ringFd = safe_file_descriptor{ fd };
+	m_isSubmissionPolling = (params.flags & IORING_SETUP_SQPOLL) != 0;
+
+	m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+	m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+	const bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (singleMapping)
+	{
+		m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+	}
+
+	auto unmapOnFailure = on_scope_failure([&]
+	{
+		if (m_sqes != nullptr) ::munmap(m_sqes, m_sqesSize);
+		if (m_cqRing != nullptr && m_cqRing != m_sqRing) ::munmap(m_cqRing, m_cqRingSize);
+		if (m_sqRing != nullptr) ::munmap(m_sqRing, m_sqRingSize);
+	});
+
+	m_sqRing = local::map_ring(
+		fd, m_sqRingSize, IORING_OFF_SQ_RING,
+		"Error creating io_service: mmap(IORING_OFF_SQ_RING)");
+
+	m_cqRing = singleMapping ? m_sqRing : local::map_ring(
+		fd, m_cqRingSize, IORING_OFF_CQ_RING,
+		"Error creating io_service: mmap(IORING_OFF_CQ_RING)");
+
+	m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	m_sqes = static_cast<io_uring_sqe*>(local::map_ring(
+		fd, m_sqesSize, IORING_OFF_SQES,
+		"Error creating io_service: mmap(IORING_OFF_SQES)"));
+
+	m_sqHead = static_cast<std::uint32_t*>(local::offset_by(m_sqRing, params.sq_off.head));
+	m_sqTail = static_cast<std::uint32_t*>(local::offset_by(m_sqRing, params.sq_off.tail));
+	m_sqFlags = static_cast<std::uint32_t*>(local::offset_by(m_sqRing, params.sq_off.flags));
+	m_sqMask = *static_cast<std::uint32_t*>(local::offset_by(m_sqRing, params.sq_off.ring_mask));
+	m_sqEntries = params.sq_entries;
+
+	m_cqHead = static_cast<std::uint32_t*>(local::offset_by(m_cqRing, params.cq_off.head));
+	m_cqTail = static_cast<std::uint32_t*>(local::offset_by(m_cqRing, params.cq_off.tail));
+	m_cqMask = *static_cast<std::uint32_t*>(local::offset_by(m_cqRing, params.cq_off.ring_mask));
+	m_cqes = static_cast<io_uring_cqe*>(local::offset_by(m_cqRing, params.cq_off.cqes));
+
+	// We always fill in sqes in ring order so we can set up the indirection
+	// array once as an identity mapping rather than on every submission.
+	auto* sqArray = static_cast<std::uint32_t*>(local::offset_by(m_sqRing, params.sq_off.array));
+	for (std::uint32_t i = 0; i < m_sqEntries; ++i)
+	{
+		sqArray[i] = i;
+	}
+
+	// Cancellations are only deferred while the submission ring is full, so
+	// this is usually enough to avoid allocating while deferring one.
+	m_deferredCancels.reserve(m_sqEntries);
+}
+
+cppcoro::detail::lnx::io_uring_queue::~io_uring_queue()
+{
+	::munmap(m_sqes, m_sqesSize);
+	if (m_cqRing != m_sqRing)
+	{
+		::munmap(m_cqRing, m_cqRingSize);
+	}
+	::munmap(m_sqRing, m_sqRingSize);
+}
+
+cppcoro::io_service_backend
+cppcoro::detail::lnx::io_uring_queue::backend() const noexcept
+{
+	return io_service_backend::io_uring;
+}
+
+bool cppcoro::detail::lnx::io_uring_queue::is_submission_polling_enabled() const noexcept
+{
+	return m_isSubmissionPolling;
+}
+
+bool cppcoro::detail::lnx::io_uring_queue::try_post(std::uint64_t userData) noexcept
+{
+	{
+		std::lock_guard lock{ m_sqMutex };
+		auto* sqe = try_get_sqe();
+		if (sqe == nullptr)
+		{
+			return false;
+		}
+
+		sqe->opcode = IORING_OP_NOP;
+		sqe->user_data = userData;
+		publish_sqe();
+	}
+
+	submit_pending();
+	return true;
+}
+
+bool cppcoro::detail::lnx::io_uring_queue::try_start(
+	io_state& state, std::int32_t& result) noexcept
+{
+	if (state.m_opcode == io_opcode::sendfile ||
+		state.m_opcode == io_opcode::sendmmsg ||
+		state.m_opcode == io_opcode::recvmmsg)
+	{
+		// There is no io_uring equivalent either, but the socket may be
+		// ready. Transfer what we can now and otherwise poll for the socket
+		// to become ready and try again.
+		result = state.m_opcode == io_opcode::sendfile ?
+			perform_sendfile(state) : perform_message_batch(state);
+		if (result != -EAGAIN)
+		{
+			return false;
+		}
+	}
+
+	state.m_isCancelRequested = false;
+	state.m_isCompletionDequeued = false;
+
+	result = try_submit(state);
+	return result == 0;
+}
+
+void cppcoro::detail::lnx::io_uring_queue::cancel(io_state& state) noexcept
+{
+	if (local::is_polled_operation(state))
+	{
+		// The cancellation may arrive after the poll has completed and
+		// before it is re-submitted, in which case the request finds nothing
+		// to cancel. Have try_submit() complete the operation instead.
+		std::lock_guard lock{ m_sqMutex };
+		state.m_isCancelRequested = true;
+	}
+
+	const std::uint64_t userData = local::user_data_for(state);
+	if (try_queue_cancel(userData))
+	{
+		submit_pending();
+		return;
+	}
+
+	// The submission ring is full, eg. because the completion ring has
+	// overflowed and the kernel won't consume more entries until it has been
+	// drained. This is common under load and some operations (eg. a recv on
+	// an idle socket) never complete unless cancelled, so defer the request
+	// until a thread dequeuing completions has made room for it.
+	{
+		std::lock_guard lock{ m_deferredCancelMutex };
+		try
+		{
+			m_deferredCancels.push_back(userData);
+		}
+		catch (const std::bad_alloc&)
+		{
+			// Out of memory, with far more cancellations deferred than fit
+			// in the submission ring. The operation will have to complete
+			// by itself.
+			return;
+		}
+
+		m_hasDeferredCancels.store(true, std::memory_order_seq_cst);
+
+		// The operation's completion may have been dequeued while we were
+		// deferring the request, too early for forget_deferred_cancel() to
+		// see it. Either we see that here or it sees our request.
+		if (__atomic_load_n(&state.m_isCompletionDequeued, __ATOMIC_SEQ_CST))
+		{
+			m_deferredCancels.pop_back();
+			m_hasDeferredCancels.store(!m_deferredCancels.empty(), std::memory_order_relaxed);
+		}
+	}
+}
+
+bool cppcoro::detail::lnx::io_uring_queue::try_queue_cancel(std::uint64_t userData) noexcept
+{
+	std::lock_guard lock{ m_sqMutex };
+	auto* sqe = try_get_sqe();
+	if (sqe == nullptr)
+	{
+		return false;
+	}
+
+	sqe->opcode = IORING_OP_ASYNC_CANCEL;
+	sqe->fd = -1;
+	sqe->addr = userData;
+
+	// The completion of the cancel request itself is not interesting.
+	// The cancelled operation will complete with -ECANCELED.
+	sqe->user_data = local::internal_user_data;
+	publish_sqe();
+	return true;
+}
+
+void cppcoro::detail::lnx::io_uring_queue::submit_deferred_cancels() noexcept
+{
+	if (!m_hasDeferredCancels.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	{
+		std::lock_guard lock{ m_deferredCancelMutex };
+
+		auto it = m_deferredCancels.begin();
+		while (it != m_deferredCancels.end() && try_queue_cancel(*it))
+		{
+			++it;
+		}
+
+		m_deferredCancels.erase(m_deferredCancels.begin(), it);
+		m_hasDeferredCancels.store(!m_deferredCancels.empty(), std::memory_order_relaxed);
+	}
+
+	submit_pending();
+}
+
+void cppcoro::detail::lnx::io_uring_queue::forget_deferred_cancel(
+	std::uint64_t userData) noexcept
+{
+	auto* state = reinterpret_cast<io_state*>(
+		static_cast<std::uintptr_t>(userData & ~local::user_data_tag_mask));
+	__atomic_store_n(&state->m_isCompletionDequeued, true, __ATOMIC_SEQ_CST);
+
+	if (!m_hasDeferredCancels.load(std::memory_order_seq_cst))
+	{
+		return;
+	}
+
+	// Once the operation has completed its address may be reused by another
+	// operation, which a late cancellation request would cancel instead.
+	std::lock_guard lock{ m_deferredCancelMutex };
+	std::erase(m_deferredCancels, userData);
+	m_hasDeferredCancels.store(!m_deferredCancels.empty(), std::memory_order_relaxed);
+}
+
+int cppcoro::detail::lnx::io_uring_queue::register_file(fd_t fd) noexcept
+{
+	if (fd < 0)
+	{
+		return EBADF;
+	}
+
+	const auto index = static_cast<std::size_t>(fd);
+
+	std::lock_guard lock{ m_registrationMutex };
+
+	if (index < m_fileSlots.size() && m_fileSlots[index] != -1)
+	{
+		return EEXIST;
+	}
+
+	if (!m_isFileTableRegistered.load(std::memory_order_relaxed))
+	{
+		// Register a sparse table up front and then fill in individual slots
+		// as files are registered.
+		try
+		{
+			m_freeFileSlots.reserve(local::registered_file_table_size);
+			const std::vector<std::int32_t> emptyTable(local::registered_file_table_size, -1);
+
+			const int errorCode = register_with_kernel(
+				IORING_REGISTER_FILES, emptyTable.data(), local::registered_file_table_size);
+			if (errorCode != 0)
+			{
+				return errorCode;
+			}
+		}
+		catch (const std::bad_alloc&)
+		{
+			return ENOMEM;
+		}
+
+		// Hand out the lowest slots first.
+		for (std::uint32_t slot = local::registered_file_table_size; slot > 0; --slot)
+		{
+			m_freeFileSlots.push_back(slot - 1);
+		}
+
+		m_isFileTableRegistered.store(true, std::memory_order_relaxed);
+	}
+
+	if (m_freeFileSlots.empty())
+	{
+		return ENFILE;
+	}
+
+	// The slot map is read while preparing sqes so grow a copy of it rather
+	// than reallocating it in place.
+	std::vector<std::int32_t> newFileSlots;
+	if (index >= m_fileSlots.size())
+	{
+		try
+		{
+			newFileSlots.reserve(index + 1);
+			newFileSlots = m_fileSlots;
+			newFileSlots.resize(index + 1, -1);
+		}
+		catch (const std::bad_alloc&)
+		{
+			return ENOMEM;
+		}
+	}
+
+	const std::uint32_t slot = m_freeFileSlots.back();
+
+	io_uring_files_update update;
+	std::memset(&update, 0, sizeof(update));
+	update.offset = slot;
+	update.fds = reinterpret_cast<std::uintptr_t>(&fd);
+
+	const int errorCode = register_with_kernel(IORING_REGISTER_FILES_UPDATE, &update, 1);
+	if (errorCode != 0)
+	{
+		return errorCode;
+	}
+
+	m_freeFileSlots.pop_back();
+
+	{
+		std::lock_guard sqLock{ m_sqMutex };
+		if (!newFileSlots.empty())
+		{
+			m_fileSlots.swap(newFileSlots);
+		}
+
+		m_fileSlots[index] = static_cast<std::int32_t>(slot);
+	}
+
+	return 0;
+}
+
+void cppcoro::detail::lnx::io_uring_queue::unregister_file(fd_t fd) noexcept
+{
+	if (!m_isFileTableRegistered.load(std::memory_order_relaxed))
+	{
+		// Sockets and files unregister themselves whenever they are closed,
+		// so avoid taking the lock if no file has ever been registered.
+		return;
+	}
+
+	const auto index = static_cast<std::size_t>(fd);
+
+	std::lock_guard lock{ m_registrationMutex };
+
+	if (fd < 0 || index >= m_fileSlots.size() || m_fileSlots[index] == -1)
+	{
+		return;
+	}
+
+	const auto slot = static_cast<std::uint32_t>(m_fileSlots[index]);
+
+	{
+		std::lock_guard sqLock{ m_sqMutex };
+		m_fileSlots[index] = -1;
+	}
+
+	// Entries that already refer to the slot must reach the kernel before
+	// the slot can be cleared and reused.
+	flush_submissions();
+
+	const fd_t noFile = -1;
+
+	io_uring_files_update update;
+	std::memset(&update, 0, sizeof(update));
+	update.offset = slot;
+	update.fds = reinterpret_cast<std::uintptr_t>(&noFile);
+	(void)register_with_kernel(IORING_REGISTER_FILES_UPDATE, &update, 1);
+
+	// Can't throw as we reserved capacity for every slot up front.
+	m_freeFileSlots.push_back(slot);
+}
+
+int cppcoro::detail::lnx::io_uring_queue::register_buffers(
+	std::span<const std::span<std::byte>> buffers) noexcept
+{
+	if (buffers.empty() || buffers.size() > std::numeric_limits<std::uint16_t>::max())
+	{
+		return EINVAL;
+	}
+
+	std::lock_guard lock{ m_registrationMutex };
+
+	if (!m_buffers.empty())
+	{
+		return EBUSY;
+	}
+
+	std::vector<registered_buffer> newBuffers;
+
+	try
+	{
+		std::vector<iovec> iovecs;
+		iovecs.reserve(buffers.size());
+		newBuffers.reserve(buffers.size());
+
+		for (std::size_t i = 0; i < buffers.size(); ++i)
+		{
+			iovecs.push_back(iovec{ buffers[i].data(), buffers[i].size() });
+			newBuffers.push_back(registered_buffer{
+				buffers[i].data(),
+				buffers[i].data() + buffers[i].size(),
+				static_cast<std::uint16_t>(i) });
+		}
+
+		const int errorCode = register_with_kernel(
+			IORING_REGISTER_BUFFERS, iovecs.data(), static_cast<std::uint32_t>(iovecs.size()));
+		if (errorCode != 0)
+		{
+			return errorCode;
+		}
+	}
+	catch (const std::bad_alloc&)
+	{
+		return ENOMEM;
+	}
+
+	std::sort(newBuffers.begin(), newBuffers.end(), [](const auto& a, const auto& b)
+	{
+		return a.m_begin < b.m_begin;
+	});
+
+	std::lock_guard sqLock{ m_sqMutex };
+	m_buffers.swap(newBuffers);
+
+	return 0;
+}
+
+void cppcoro::detail::lnx::io_uring_queue::unregister_buffers() noexcept
+{
+	std::lock_guard lock{ m_registrationMutex };
+
+	if (m_buffers.empty())
+	{
+		return;
+	}
+
+	std::vector<registered_buffer> oldBuffers;
+
+	{
+		std::lock_guard sqLock{ m_sqMutex };
+		m_buffers.swap(oldBuffers);
+	}
+
+	flush_submissions();
+
+	(void)register_with_kernel(IORING_UNREGISTER_BUFFERS, nullptr, 0);
+}
+
+int cppcoro::detail::lnx::io_uring_queue::register_buffer_group(
+	io_buffer_group& group) noexcept
+{
+	const std::uint16_t count = group.buffer_count();
+	if (count == 0 || (count & (count - 1)) != 0 || count > 32768)
+	{
+		return EINVAL;
+	}
+
+	std::lock_guard lock{ m_registrationMutex };
+
+	if (m_nextBufferGroupId > std::numeric_limits<std::uint16_t>::max())
+	{
+		return ENOSPC;
+	}
+
+	const std::size_t ringSize = count * sizeof(io_uring_buf);
+	void* ring = ::mmap(
+		nullptr,
+		ringSize,
+		PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS,
+		-1,
+		0);
+	if (ring == MAP_FAILED)
+	{
+		return errno;
+	}
+
+	// Hand every buffer to the kernel up front.
+	auto* bufs = local::buffer_ring_entries(ring);
+	for (std::uint16_t i = 0; i < count; ++i)
+	{
+		bufs[i].addr = reinterpret_cast<std::uintptr_t>(group.buffer(i));
+		bufs[i].len = group.buffer_size();
+		bufs[i].bid = i;
+	}
+
+	__atomic_store_n(local::buffer_ring_tail(ring), count, __ATOMIC_RELEASE);
+
+	io_uring_buf_reg reg;
+	std::memset(&reg, 0, sizeof(reg));
+	reg.ring_addr = reinterpret_cast<std::uintptr_t>(ring);
+	reg.ring_entries = count;
+	reg.bgid = static_cast<std::uint16_t>(m_nextBufferGroupId);
+
+	const int errorCode = register_with_kernel(IORING_REGISTER_PBUF_RING, &reg, 1);
+	if (errorCode != 0)
+	{
+		::munmap(ring, ringSize);
+
+		if (errorCode != EINVAL)
+		{
+			return errorCode;
+		}
+
+		// Kernels before 5.19 don't support buffer rings. Poll for the socket
+		// to become readable and pick a buffer from the free list ourselves.
+		group.m_ring = nullptr;
+		return 0;
+	}
+
+	group.m_groupId = static_cast<std::uint16_t>(m_nextBufferGroupId++);
+	group.m_ring = ring;
+	group.m_ringSize = ringSize;
+	group.m_ringTail = count;
+
+	return 0;
+}
+
+void cppcoro::detail::lnx::io_uring_queue::unregister_buffer_group(
+	io_buffer_group& group) noexcept
+{
+	if (group.m_ring == nullptr)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard lock{ m_registrationMutex };
+
+		io_uring_buf_reg reg;
+		std::memset(&reg, 0, sizeof(reg));
+		reg.bgid = group.m_groupId;
+		(void)register_with_kernel(IORING_UNREGISTER_PBUF_RING, &reg, 1);
+	}
+
+	::munmap(group.m_ring, group.m_ringSize);
+	group.m_ring = nullptr;
+}
+
+void cppcoro::detail::lnx::io_uring_queue::recycle_buffer(
+	io_buffer_group& group, std::uint16_t bufferId) noexcept
+{
+	if (group.m_ring == nullptr)
+	{
+		group.release(bufferId);
+		return;
+	}
+
+	std::lock_guard lock{ group.m_mutex };
+
+	// The ring has an entry for every buffer so it can't overflow.
+	const std::uint16_t mask = group.buffer_count() - 1;
+	auto& buf = local::buffer_ring_entries(group.m_ring)[group.m_ringTail & mask];
+	buf.addr = reinterpret_cast<std::uintptr_t>(group.buffer(bufferId));
+	buf.len = group.buffer_size();
+	buf.bid = bufferId;
+
+	// Publish the entry only after it has been filled in.
+	__atomic_store_n(
+		local::buffer_ring_tail(group.m_ring), ++group.m_ringTail, __ATOMIC_RELEASE);
+}
+
+bool cppcoro::detail::lnx::io_uring_queue::try_dequeue(
+	completion& result, bool waitForCompletion)
+{
+	submit_deferred_cancels();
+
+	if (try_dequeue_ready(result))
+	{
+		return true;
+	}
+
+	if (waitForCompletion)
+	{
+		wait_for_completion();
+	}
+	else
+	{
+		// Entries may have been queued to the submission ring by threads
+		// that are currently batching their submissions. Hand them to the
+		// kernel so that any that complete immediately (eg. NOPs) can be
+		// dequeued now.
+		submit_pending();
+	}
+
+	return try_dequeue_ready(result);
+}
+
+bool cppcoro::detail::lnx::io_uring_queue::try_dequeue_ready(completion& result) noexcept
+{
+	while (try_pop_completion(result))
+	{
+		const std::uint64_t userData = result.m_userData;
+		if ((userData & local::user_data_tag_mask) != local::polled_operation_tag ||
+			try_complete_polled_operation(result))
+		{
+			if ((result.m_flags & IORING_CQE_F_MORE) == 0 &&
+				local::is_operation_user_data(userData))
+			{
+				forget_deferred_cancel(userData);
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool cppcoro::detail::lnx::io_uring_queue::try_pop_completion(completion& result) noexcept
+{
+	std::lock_guard lock{ m_cqMutex };
+
+	// Only ever written by us (under the lock), so no barrier needed.
+	std::uint32_t head = *m_cqHead;
+	const std::uint32_t tail = local::load_acquire(m_cqTail);
+	while (head != tail)
+	{
+		const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+		result.m_userData = cqe.user_data;
+		result.m_result = cqe.res;
+		result.m_flags = cqe.flags;
+
+		// Release the slot back to the kernel only after we have finished
+		// reading its contents.
+		local::store_release(m_cqHead, ++head);
+
+		if ((result.m_flags & IORING_CQE_F_MORE) != 0)
+		{
+			// Account for this completion of a multishot operation while we
+			// still hold the lock, before the operation's next completion
+			// can be dequeued. See io_state::m_pendingCallbacks.
+			auto* state = reinterpret_cast<io_state*>(
+				static_cast<std::uintptr_t>(result.m_userData));
+			__atomic_add_fetch(&state->m_pendingCallbacks, 1, __ATOMIC_RELAXED);
+		}
+
+		if (result.m_userData != local::internal_user_data)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool cppcoro::detail::lnx::io_uring_queue::try_complete_polled_operation(
+	completion& result) noexcept
+{
+	auto& state = *reinterpret_cast<io_state*>(
+		static_cast<std::uintptr_t>(result.m_userData & ~local::user_data_tag_mask));
+
+	result.m_userData = reinterpret_cast<std::uintptr_t>(&state);
+	result.m_flags = 0;
+
+	if (result.m_result < 0)
+	{
+		// The poll failed or was cancelled.
+		return true;
+	}
+
+	switch (state.m_opcode)
+	{
+	case io_opcode::copy_file_range:
+		// Doesn't wait for its file descriptors so it is never retried.
+		result.m_result = perform_copy_file_range(state);
+		return true;
+	case io_opcode::recv_select_buffer:
+		result.m_result = perform_recv_select_buffer(state, result.m_flags);
+		break;
+	case io_opcode::sendmmsg:
+	case io_opcode::recvmmsg:
+		result.m_result = perform_message_batch(state);
+		break;
+	default:
+		assert(state.m_opcode == io_opcode::sendfile);
+		result.m_result = perform_sendfile(state);
+		break;
+	}
+
+	if (result.m_result != -EAGAIN)
+	{
+		return true;
+	}
+
+	// Someone else got to the socket first. Keep waiting, unless the
+	// operation has been cancelled in the meantime.
+	result.m_result = try_submit(state);
+	return result.m_result != 0;
+}
+
+std::int32_t cppcoro::detail::lnx::io_uring_queue::try_submit(io_state& state) noexcept
+{
+	{
+		std::lock_guard lock{ m_sqMutex };
+
+		// Checked under the lock so that a cancellation request is either
+		// seen here or is queued after this entry.
+		if (state.m_isCancelRequested)
+		{
+			return -ECANCELED;
+		}
+
+		auto* sqe = try_get_sqe();
+		if (sqe == nullptr)
+		{
+			return -EBUSY;
+		}
+
+		switch (state.m_opcode)
+		{
+		case io_opcode::nop:
+			sqe->opcode = IORING_OP_NOP;
+			break;
+		case io_opcode::read:
+			sqe->opcode = IORING_OP_READ;
+			break;
+		case io_opcode::write:
+			sqe->opcode = IORING_OP_WRITE;
+			break;
+		case io_opcode::readv:
+			sqe->opcode = IORING_OP_READV;
+			break;
+		case io_opcode::writev:
+			sqe->opcode = IORING_OP_WRITEV;
+			break;
+		case io_opcode::fsync:
+			sqe->opcode = IORING_OP_FSYNC;
+			break;
+		case io_opcode::fallocate:
+			sqe->opcode = IORING_OP_FALLOCATE;
+			break;
+		case io_opcode::sync_file_range:
+			sqe->opcode = IORING_OP_SYNC_FILE_RANGE;
+			break;
+		case io_opcode::copy_file_range:
+			// There is no io_uring equivalent. Rather than blocking the
+			// awaiting thread, perform it on the I/O thread that dequeues
+			// this no-op. See try_complete_polled_operation().
+			sqe->opcode = IORING_OP_NOP;
+			break;
+		case io_opcode::send:
+			sqe->opcode = IORING_OP_SEND;
+			break;
+		case io_opcode::recv:
+			sqe->opcode = IORING_OP_RECV;
+			break;
+		case io_opcode::sendmsg:
+			sqe->opcode = IORING_OP_SENDMSG;
+			break;
+		case io_opcode::recvmsg:
+			sqe->opcode = IORING_OP_RECVMSG;
+			break;
+		case io_opcode::sendmmsg:
+		case io_opcode::recvmmsg:
+			// Wait for the socket to become ready.
+			// See try_complete_polled_operation().
+			sqe->opcode = IORING_OP_POLL_ADD;
+			break;
+		case io_opcode::accept:
+		case io_opcode::accept_multishot:
+			sqe->opcode = IORING_OP_ACCEPT;
+			break;
+		case io_opcode::connect:
+			sqe->opcode = IORING_OP_CONNECT;
+			break;
+		case io_opcode::sendfile:
+			// Wait for the socket to become writable.
+			// See try_complete_polled_operation().
+			sqe->opcode = IORING_OP_POLL_ADD;
+			break;
+		case io_opcode::recv_select_buffer:
+			// Without a buffer ring, wait for the socket to become readable.
+			// See try_complete_polled_operation().
+			sqe->opcode = local::is_polled_operation(state) ?
+				IORING_OP_POLL_ADD : IORING_OP_RECV;
+			break;
+		case io_opcode::send_zerocopy:
+			sqe->opcode = IORING_OP_SEND_ZC;
+			break;
+		}
+
+		prepare_sqe(*sqe, state);
+		sqe->user_data = local::user_data_for(state);
+		publish_sqe();
+	}
+
+	submit_pending();
+	return 0;
+}
+
+void cppcoro::detail::lnx::io_uring_queue::submit_pending() noexcept
+{
+	if (is_batching_submissions())
+	{
+		// The submission will be made when the current batch completes.
+		return;
+	}
+
+	if (m_isSubmissionPolling)
+	{
+		// The kernel thread picks up new entries by itself.
+		wake_up_submission_poller();
+	}
+
+	// If completions have overflowed the completion ring then the kernel
+	// only moves them back into the ring when asked to get events.
+	const std::uint32_t flags =
+		(local::load_acquire(m_sqFlags) & IORING_SQ_CQ_OVERFLOW) != 0 ?
+		IORING_ENTER_GETEVENTS : 0;
+
+	const std::uint32_t toSubmit = m_isSubmissionPolling ? 0 : pending_submission_count();
+	if (toSubmit > 0 || flags != 0)
+	{
+		// If this fails (eg. with EBUSY because the completion queue has
+		// overflowed) then the entries remain in the submission ring and
+		// will be submitted by the next thread that enters the kernel.
+		(void)enter(toSubmit, 0, flags);
+	}
+}
+
+void cppcoro::detail::lnx::io_uring_queue::wait_for_completion()
+{
+	if (m_isSubmissionPolling)
+	{
+		wake_up_submission_poller();
+	}
+
+	const std::uint32_t toSubmit = m_isSubmissionPolling ? 0 : pending_submission_count();
+	const int result = enter(toSubmit, 1, IORING_ENTER_GETEVENTS);
+	if (result < 0)
+	{
+		const int errorCode = -result;
+		if (errorCode == EINTR || errorCode == EBUSY || errorCode == EAGAIN)
+		{
+			// Transient failures.
+			// - EINTR: Interrupted by a signal.
+			// - EBUSY/EAGAIN: The completion ring is full (or the kernel is
+			//   out of resources) and needs to be drained before more entries
+			//   can be submitted.
+			// In all cases the caller should just try to dequeue again.
+			return;
+		}
+
+		throw std::system_error
+		{
+			errorCode,
+			std::system_category(),
+			"Error processing events: io_uring_enter"
+		};
+	}
+}
+
+void cppcoro::detail::lnx::io_uring_queue::flush_submissions() noexcept
+{
+	const std::uint32_t tail = local::load_acquire(m_sqTail);
+
+	// Until the kernel has consumed every entry up to the current tail.
+	while (static_cast<std::int32_t>(tail - local::load_acquire(m_sqHead)) > 0)
+	{
+		int result;
+		if (m_isSubmissionPolling)
+		{
+			wake_up_submission_poller();
+			result = enter(0, 0, IORING_ENTER_SQ_WAIT);
+		}
+		else
+		{
+			result = enter(pending_submission_count(), 0, 0);
+		}
+
+		if (result < 0)
+		{
+			// Eg. the completion ring is full. Give the I/O threads a chance
+			// to drain it.
+			std::this_thread::yield();
+		}
+	}
+}
+
+void cppcoro::detail::lnx::io_uring_queue::prepare_sqe(
+	io_uring_sqe& sqe, const io_state& state) noexcept
+{
+	if (sqe.opcode == IORING_OP_NOP)
+	{
+		// Eg. for a copy_file_range, which has no operands to fill in.
+		return;
+	}
+
+	sqe.fd = state.m_fd;
+	sqe.off = state.m_offset;
+
+	switch (state.m_opcode)
+	{
+	case io_opcode::fsync:
+		sqe.fsync_flags = state.m_flags;
+		break;
+	case io_opcode::fallocate:
+		// The 64-bit length is passed in addr and the mode in len.
+		sqe.addr = state.m_length;
+		sqe.len = state.m_flags;
+		break;
+	case io_opcode::sync_file_range:
+		sqe.len = static_cast<std::uint32_t>(state.m_length);
+		sqe.sync_range_flags = state.m_flags;
+		break;
+	case io_opcode::send:
+	case io_opcode::recv:
+	case io_opcode::send_zerocopy:
+		sqe.addr = reinterpret_cast<std::uintptr_t>(state.m_buffer);
+		sqe.len = static_cast<std::uint32_t>(state.m_length);
+		sqe.msg_flags = state.m_flags;
+		break;
+	case io_opcode::sendmsg:
+	case io_opcode::recvmsg:
+		sqe.addr = reinterpret_cast<std::uintptr_t>(state.m_buffer);
+		sqe.len = 1;
+		sqe.msg_flags = state.m_flags;
+		break;
+	case io_opcode::accept:
+		sqe.accept_flags = state.m_flags;
+		break;
+	case io_opcode::accept_multishot:
+		sqe.accept_flags = state.m_flags;
+		sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+		break;
+	case io_opcode::connect:
+		// The address length is passed in off.
+		sqe.addr = reinterpret_cast<std::uintptr_t>(state.m_buffer);
+		sqe.off = state.m_length;
+		break;
+	case io_opcode::sendmmsg:
+	case io_opcode::sendfile:
+		sqe.poll_events = POLLOUT;
+		break;
+	case io_opcode::recvmmsg:
+		sqe.poll_events = POLLIN;
+		break;
+	case io_opcode::recv_select_buffer:
+		if (sqe.opcode == IORING_OP_POLL_ADD)
+		{
+			sqe.poll_events = POLLIN;
+		}
+		else
+		{
+			const auto& group = *static_cast<const io_buffer_group*>(state.m_buffer);
+			sqe.flags |= IOSQE_BUFFER_SELECT;
+			sqe.buf_group = group.m_groupId;
+			sqe.len = group.buffer_size();
+			sqe.msg_flags = state.m_flags;
+		}
+		break;
+	default:
+		sqe.addr = reinterpret_cast<std::uintptr_t>(state.m_buffer);
+		sqe.len = static_cast<std::uint32_t>(state.m_length);
+		break;
+	}
+
+	const auto index = static_cast<std::size_t>(state.m_fd);
+	if (state.m_fd >= 0 && index < m_fileSlots.size() && m_fileSlots[index] != -1)
+	{
+		sqe.fd = m_fileSlots[index];
+		sqe.flags |= IOSQE_FIXED_FILE;
+	}
+
+	// Only reads, writes and zero-copy sends can use registered buffers.
+	// io_uring has no fixed-buffer variant of a plain send or recv.
+	const bool canUseRegisteredBuffer =
+		sqe.opcode == IORING_OP_READ ||
+		sqe.opcode == IORING_OP_WRITE ||
+		sqe.opcode == IORING_OP_SEND_ZC;
+	if (!m_buffers.empty() && canUseRegisteredBuffer)
+	{
+		// Find the last registered buffer that starts at or before the
+		// operation's buffer and check whether it contains all of it.
+		const auto* begin = static_cast<const std::byte*>(state.m_buffer);
+		auto it = std::upper_bound(
+			m_buffers.begin(),
+			m_buffers.end(),
+			begin,
+			[](const std::byte* p, const registered_buffer& buffer) { return p < buffer.m_begin; });
+		if (it != m_buffers.begin())
+		{
+			--it;
+			if (begin < it->m_end &&
+				static_cast<std::size_t>(it->m_end - begin) >= state.m_length)
+			{
+				if (sqe.opcode == IORING_OP_SEND_ZC)
+				{
+					sqe.ioprio |= IORING_RECVSEND_FIXED_BUF;
+				}
+				else
+				{
+					sqe.opcode = sqe.opcode == IORING_OP_READ ?
+						IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+				}
+
+				sqe.buf_index = it->m_index;
+			}
+		}
+	}
+}
+
+int cppcoro::detail::lnx::io_uring_queue::register_with_kernel(
+	std::uint32_t opcode,
+	const void* arg,
+	std::uint32_t argCount) noexcept
+{
+	const int result = local::io_uring_register(m_ringFd.fd(), opcode, arg, argCount);
+	return result < 0 ? errno : 0;
+}
+
+io_uring_sqe* cppcoro::detail::lnx::io_uring_queue::try_get_sqe() noexcept
+{
+	const std::uint32_t tail = *m_sqTail;
+	if (tail - local::load_acquire(m_sqHead) >= m_sqEntries)
+	{
+		// The submission ring is full. Try to make some room by handing the
+		// queued entries to the kernel, which consumes them immediately.
+		// If the kernel is polling then wait for it to consume some instead.
+		if (m_isSubmissionPolling)
+		{
+			wake_up_submission_poller();
+			(void)enter(0, 0, IORING_ENTER_SQ_WAIT);
+		}
+		else
+		{
+			(void)enter(tail - local::load_acquire(m_sqHead), 0, 0);
+		}
+
+		if (tail - local::load_acquire(m_sqHead) >= m_sqEntries)
+		{
+			return nullptr;
+		}
+	}
+
+	io_uring_sqe* sqe = &m_sqes[tail & m_sqMask];
+	std::memset(sqe, 0, sizeof(io_uring_sqe));
+	return sqe;
+}
+
+void cppcoro::detail::lnx::io_uring_queue::publish_sqe() noexcept
+{
+	local::store_release(m_sqTail, *m_sqTail + 1);
+}
+
+std::uint32_t cppcoro::detail::lnx::io_uring_queue::pending_submission_count() const noexcept
+{
+	return local::load_acquire(m_sqTail) - local::load_acquire(m_sqHead);
+}
+
+void cppcoro::detail::lnx::io_uring_queue::wake_up_submission_poller() noexcept
+{
+	// The store to the submission ring tail must be visible to the kernel
+	// thread before we check whether it has gone to sleep, otherwise it
+	// could go to sleep without seeing the new entries.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if ((local::load_acquire(m_sqFlags) & IORING_SQ_NEED_WAKEUP) != 0)
+	{
+		(void)enter(0, 0, IORING_ENTER_SQ_WAKEUP);
+	}
+}
+
+int cppcoro::detail::lnx::io_uring_queue::enter(
+	std::uint32_t toSubmit,
+	std::uint32_t minComplete,
+	std::uint32_t flags) noexcept
+{
+	const int result = local::io_uring_enter(m_ringFd.fd(), toSubmit, minComplete, flags);
+	return result < 0 ? -errno : result;
+}
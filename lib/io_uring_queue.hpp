@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_PRIVATE_IO_URING_QUEUE_HPP_INCLUDED
+#define CPPCORO_PRIVATE_IO_URING_QUEUE_HPP_INCLUDED
+
+#include <cppcoro/config.hpp>
+#include <cppcoro/io_service_options.hpp>
+#include <cppcoro/detail/linux.hpp>
+
+#include "io_engine.hpp"
+#include "spin_mutex.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace cppcoro
+{
+	namespace detail
+	{
+		namespace lnx
+		{
+			/// \brief
+			/// An io_engine that owns an io_uring instance and provides thread-safe
+			/// access to its submission and completion rings.
+			///
+			/// Any number of threads may submit entries concurrently. Submission
+			/// queue entries are filled in under a spin-lock and then handed to the
+			/// kernel with io_uring_enter() outside of the lock.
+			///
+			/// Any number of threads may concurrently dequeue completions or block
+			/// waiting for completions to become available.
+			class io_uring_queue final : public io_engine
+			{
+			public:
+
+				/// Create a new io_uring with the specified submission queue size.
+				///
+				/// Submission polling is enabled if requested by \p options and
+				/// available to this process.
+				///
+				/// \throw std::system_error
+				/// If the kernel does not support io_uring or the io_uring could
+				/// not be created.
+				io_uring_queue(std::uint32_t entries, const io_service_options& options);
+
+				~io_uring_queue();
+
+				io_uring_queue(const io_uring_queue&) = delete;
+				io_uring_queue& operator=(const io_uring_queue&) = delete;
+
+				io_service_backend backend() const noexcept override;
+
+				bool is_submission_polling_enabled() const noexcept override;
+
+				/// Queue a no-op entry that will produce a completion with the
+				/// specified user-data.
+				bool try_post(std::uint64_t userData) noexcept override;
+
+				bool try_start(io_state& state, std::int32_t& result) noexcept override;
+
+				void cancel(io_state& state) noexcept override;
+
+				int register_file(fd_t fd) noexcept override;
+
+				void unregister_file(fd_t fd) noexcept override;
+
+				int register_buffers(std::span<const std::span<std::byte>> buffers) noexcept override;
+
+				void unregister_buffers() noexcept override;
+
+				int register_buffer_group(io_buffer_group& group) noexcept override;
+
+				void unregister_buffer_group(io_buffer_group& group) noexcept override;
+
+				void recycle_buffer(io_buffer_group& group, std::uint16_t bufferId) noexcept override;
+
+				bool try_dequeue(completion& result, bool waitForCompletion) override;
+
+			private:
+
+				void submit_pending() noexcept override;
+
+				/// Queue a request to cancel the operation submitted with the
+				/// specified user-data.
+				///
+				/// Does not hand the request to the kernel.
+				///
+				/// \return
+				/// false if the submission ring is full.
+				bool try_queue_cancel(std::uint64_t userData) noexcept;
+
+				/// Retry queueing the cancellation requests that could not be
+				/// queued when they were made.
+				void submit_deferred_cancels() noexcept;
+
+				/// Discard any cancellation request for an operation that was
+				/// deferred, as the final completion of the operation has been
+				/// dequeued.
+				void forget_deferred_cancel(std::uint64_t userData) noexcept;
+
+				/// Dequeue a single completion if one is available.
+				bool try_dequeue_ready(completion& result) noexcept;
+
+				/// Pop a single entry from the completion ring, skipping any
+				/// that are for the queue's own bookkeeping.
+				bool try_pop_completion(completion& result) noexcept;
+
+				/// Called when the poll for an operation that io_uring can't
+				/// perform itself (eg. sendfile, or recv_select_buffer on older
+				/// kernels) completes, to perform the operation now that its file
+				/// descriptor is ready. Also performs copy_file_range operations
+				/// once the no-op submitted for them completes.
+				///
+				/// \return
+				/// true if the operation completed, in which case \p result has
+				/// been updated with its completion. false if the operation is
+				/// waiting for its file descriptor to become ready again.
+				bool try_complete_polled_operation(completion& result) noexcept;
+
+				/// Fill in and submit an sqe for the operation.
+				///
+				/// \return
+				/// Zero on success, -EBUSY if the submission ring is full or
+				/// -ECANCELED if cancellation of the operation was requested
+				/// while it was waiting for its file descriptor.
+				std::int32_t try_submit(io_state& state) noexcept;
+
+				/// Hand any pending submissions to the kernel and block until there
+				/// is at least one completion available to be dequeued.
+				///
+				/// May return early without a completion being available, eg. if
+				/// interrupted by a signal.
+				void wait_for_completion();
+
+				/// Wait until the kernel has consumed all entries currently in the
+				/// submission ring.
+				///
+				/// Used before a registered file slot is reused so that entries that
+				/// refer to the slot by index can't be applied to the wrong file.
+				void flush_submissions() noexcept;
+
+				/// Fill in the operands of an sqe, using the registered file and
+				/// buffer tables where possible.
+				///
+				/// Must be called with m_sqMutex held.
+				void prepare_sqe(io_uring_sqe& sqe, const io_state& state) noexcept;
+
+				int register_with_kernel(
+					std::uint32_t opcode,
+					const void* arg,
+					std::uint32_t argCount) noexcept;
+
+				io_uring_sqe* try_get_sqe() noexcept;
+
+				void publish_sqe() noexcept;
+
+				std::uint32_t pending_submission_count() const noexcept;
+
+				/// Wake up the kernel's submission polling thread if it has gone
+				/// to sleep.
+				void wake_up_submission_poller() noexcept;
+
+				int enter(
+					std::uint32_t toSubmit,
+					std::uint32_t minComplete,
+					std::uint32_t flags) noexcept;
+
+				safe_file_descriptor m_ringFd;
+
+				void* m_sqRing;
+				std::size_t m_sqRingSize;
+				void* m_cqRing;
+				std::size_t m_cqRingSize;
+				io_uring_sqe* m_sqes;
+				std::size_t m_sqesSize;
+
+				std::uint32_t* m_sqHead;
+				std::uint32_t* m_sqTail;
+				std::uint32_t* m_sqFlags;
+				std::uint32_t m_sqMask;
+				std::uint32_t m_sqEntries;
+
+				// If set then a kernel thread consumes the submission ring and
+				// we only need to enter the kernel to wake it up.
+				bool m_isSubmissionPolling;
+
+				std::uint32_t* m_cqHead;
+				std::uint32_t* m_cqTail;
+				std::uint32_t m_cqMask;
+				io_uring_cqe* m_cqes;
+
+				// Protects the submission ring tail and the sqe being filled in.
+				spin_mutex m_sqMutex;
+
+				// Protects the completion ring head.
+				spin_mutex m_cqMutex;
+
+				struct registered_buffer
+				{
+					const std::byte* m_begin;
+					const std::byte* m_end;
+					std::uint16_t m_index;
+				};
+
+				// Serialises changes to the registered file and buffer tables.
+				std::mutex m_registrationMutex;
+
+				// Slots in the kernel's registered file table that are not in use.
+				// The table is registered when the first file is registered.
+				std::vector<std::uint32_t> m_freeFileSlots;
+
+				// Never reset once set. Read without the lock so that sockets
+				// and files can skip unregistering when nothing is registered.
+				std::atomic<bool> m_isFileTableRegistered;
+
+				// The following are read when preparing sqes and so are only
+				// modified while holding both m_registrationMutex and m_sqMutex.
+
+				// Registered file table slot for each file descriptor, or -1 if the
+				// file descriptor is not registered.
+				std::vector<std::int32_t> m_fileSlots;
+
+				// The registered buffers, sorted by address.
+				std::vector<registered_buffer> m_buffers;
+
+				// The id to register the next buffer group under. Protected by
+				// m_registrationMutex.
+				std::uint32_t m_nextBufferGroupId;
+
+				// The user-data of operations whose cancellation could not be
+				// queued because the submission ring was full. These are retried
+				// by the next thread to dequeue a completion.
+				spin_mutex m_deferredCancelMutex;
+				std::vector<std::uint64_t> m_deferredCancels;
+				std::atomic<bool> m_hasDeferredCancels;
+
+			};
+		}
+	}
+}
+
+#endif
@@ -7,7 +7,50 @@
 
 #include <system_error>
 
+#if CPPCORO_OS_LINUX
+# include "futex.hpp"
+
+# include <climits>
+#endif
+
 namespace cppcoro::detail {
+#if CPPCORO_OS_LINUX
+
+lightweight_manual_reset_event::lightweight_manual_reset_event()
+	: m_value(0)
+{}
+
+void lightweight_manual_reset_event::set() noexcept {
+	// Only make the system call if a thread may be waiting.
+	// The waiting thread may destroy the event as soon as it sees the
+	// new value, which is fine as futex_wake() only uses its address.
+	if (m_value.exchange(1, std::memory_order_release) == 2) {
+		(void)lnx::futex_wake(m_value, INT_MAX);
+	}
+}
+
+void lightweight_manual_reset_event::reset() noexcept {
+	// Leave the event alone if it is not set so that threads that are
+	// waiting will still be woken by the next call to set().
+	int oldValue = 1;
+	(void)m_value.compare_exchange_strong(
+		oldValue, 0, std::memory_order_relaxed, std::memory_order_relaxed);
+}
+
+void lightweight_manual_reset_event::wait() noexcept {
+	int oldValue = m_value.load(std::memory_order_acquire);
+	while (oldValue != 1) {
+		if (oldValue == 2 || m_value.compare_exchange_weak(
+			oldValue, 2, std::memory_order_acquire, std::memory_order_acquire)) {
+			// Returns immediately if the event was set in the meantime.
+			(void)lnx::futex_wait(m_value, 2);
+			oldValue = m_value.load(std::memory_order_acquire);
+		}
+	}
+}
+
+#else
+
 lightweight_manual_reset_event::lightweight_manual_reset_event()
 	: m_isSet(false)
 {}
@@ -27,4 +70,6 @@ void lightweight_manual_reset_event::wait() noexcept {
 	std::unique_lock<std::mutex> lock(m_mutex);
 	m_cv.wait(lock, [this] { return m_isSet; });
 }
+
+#endif
 } // namespace cppcoro::detail
@@ -0,0 +1,165 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cppcoro/mapped_file.hpp>
+
+#include <system_error>
+
+#if CPPCORO_OS_LINUX
+# include <sys/mman.h>
+# include <sys/uio.h>
+# include <unistd.h>
+# include <cerrno>
+
+namespace
+{
+	namespace local
+	{
+		std::size_t page_size() noexcept
+		{
+			static const std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+			return pageSize;
+		}
+	}
+}
+
+cppcoro::mapped_file::~mapped_file()
+{
+	if (m_mapping != nullptr)
+	{
+		::munmap(m_mapping, m_mappingSize);
+	}
+}
+
+cppcoro::mapped_file cppcoro::mapped_file::map(
+	detail::lnx::fd_t fd,
+	std::uint64_t offset,
+	std::size_t length)
+{
+	if (length == 0)
+	{
+		// mmap() rejects empty mappings.
+		return mapped_file{};
+	}
+
+	// The mapping itself has to start on a page boundary.
+	const std::size_t pageOffset = static_cast<std::size_t>(offset % local::page_size());
+	const std::size_t mappingSize = length + pageOffset;
+
+	void* mapping = ::mmap(
+		nullptr,
+		mappingSize,
+		PROT_READ,
+		MAP_SHARED,
+		fd,
+		static_cast<off_t>(offset - pageOffset));
+	if (mapping == MAP_FAILED)
+	{
+		throw std::system_error
+		{
+			errno,
+			std::system_category(),
+			"error mapping file: mmap"
+		};
+	}
+
+	return mapped_file{
+		mapping,
+		mappingSize,
+		static_cast<const std::byte*>(mapping) + pageOffset,
+		length
+	};
+}
+
+void cppcoro::mapped_file::populate(std::size_t offset, std::size_t length) const
+{
+	if (offset >= m_size)
+	{
+		return;
+	}
+
+	if (length > m_size - offset)
+	{
+		length = m_size - offset;
+	}
+
+	// madvise() requires a page-aligned address.
+	const auto* begin = m_data + offset;
+	const auto* end = begin + length;
+	const auto* alignedBegin = static_cast<const std::byte*>(m_mapping) +
+		((begin - static_cast<const std::byte*>(m_mapping)) / local::page_size()) * local::page_size();
+
+#ifdef MADV_POPULATE_READ
+	// Faults in all of the pages, waiting for any reads from disk, without
+	// having to touch each page.
+	if (::madvise(
+		const_cast<std::byte*>(alignedBegin),
+		static_cast<std::size_t>(end - alignedBegin),
+		MADV_POPULATE_READ) == 0)
+	{
+		return;
+	}
+
+	if (errno != EINVAL)
+	{
+		throw std::system_error
+		{
+			errno,
+			std::system_category(),
+			"error prefetching mapped file: madvise"
+		};
+	}
+#endif
+
+	// Older kernels: start readahead of the whole range and then read a byte
+	// of each page so that we wait for it to be read in. The bytes are read
+	// with process_vm_readv() rather than by touching the pages, as a page
+	// past the end of a file that has since been truncated then fails with
+	// EFAULT, as it does for MADV_POPULATE_READ, instead of raising SIGBUS.
+	(void)::madvise(
+		const_cast<std::byte*>(alignedBegin),
+		static_cast<std::size_t>(end - alignedBegin),
+		MADV_WILLNEED);
+
+	constexpr std::size_t maxPagesPerRead = 64;
+	std::byte sink[maxPagesPerRead];
+	::iovec pages[maxPagesPerRead];
+	const ::iovec sinkIov{ sink, sizeof(sink) };
+
+	const auto* page = alignedBegin;
+	while (page < end)
+	{
+		std::size_t pageCount = 0;
+		for (; pageCount < maxPagesPerRead && page < end; ++pageCount)
+		{
+			pages[pageCount] = ::iovec{ const_cast<std::byte*>(page), 1 };
+			page += local::page_size();
+		}
+
+		const ::ssize_t result = ::process_vm_readv(
+			::getpid(), &sinkIov, 1, pages, pageCount, 0);
+		if (result == static_cast<::ssize_t>(pageCount))
+		{
+			continue;
+		}
+
+		if (result < 0 && (errno == ENOSYS || errno == EPERM))
+		{
+			// Not available here (eg. blocked by a seccomp filter), so the
+			// readahead started above is the best we can do.
+			return;
+		}
+
+		// A short read means the next page couldn't be read in.
+		throw std::system_error
+		{
+			result < 0 ? errno : EFAULT,
+			std::system_category(),
+			"error prefetching mapped file: process_vm_readv"
+		};
+	}
+}
+
+#endif
@@ -3,7 +3,7 @@
 // Licenced under MIT license. See LICENSE.txt for details.
 ///////////////////////////////////////////////////////////////////////////////
 
-#include <cppcoro\read_only_file.hpp>
+#include <cppcoro/read_only_file.hpp>
 
 #if CPPCORO_OS_WINNT
 # ifndef WIN32_LEAN_AND_MEAN
@@ -13,7 +13,7 @@
 
 cppcoro::read_only_file cppcoro::read_only_file::open(
 	io_service& ioService,
-	const std::experimental::filesystem::path& path,
+	const std::filesystem::path& path,
 	file_share_mode shareMode,
 	file_buffering_mode bufferingMode)
 {
@@ -33,4 +33,43 @@ cppcoro::read_only_file::read_only_file(
 {
 }
 
+#elif CPPCORO_OS_LINUX
+# include <fcntl.h>
+
+cppcoro::read_only_file cppcoro::read_only_file::open(
+	io_service& ioService,
+	const std::filesystem::path& path,
+	file_share_mode shareMode,
+	file_buffering_mode bufferingMode)
+{
+	return read_only_file(file::open(
+		O_RDONLY,
+		ioService,
+		path,
+		file_open_mode::open_existing,
+		shareMode,
+		bufferingMode),
+		ioService);
+}
+
+cppcoro::read_only_file::read_only_file(
+	detail::lnx::safe_file_descriptor&& fileHandle,
+	io_service& ioService) noexcept
+	: file(std::move(fileHandle), &ioService)
+	, readable_file(detail::lnx::safe_file_descriptor{}, &ioService)
+{
+}
+
+cppcoro::mapped_file cppcoro::read_only_file::map() const
+{
+	return map(0, static_cast<std::size_t>(size()));
+}
+
+cppcoro::mapped_file cppcoro::read_only_file::map(
+	std::uint64_t offset,
+	std::size_t length) const
+{
+	return mapped_file::map(m_fileHandle.fd(), offset, length);
+}
+
 #endif
@@ -3,7 +3,7 @@
 // Licenced under MIT license. See LICENSE.txt for details.
 ///////////////////////////////////////////////////////////////////////////////
 
-#include <cppcoro\read_write_file.hpp>
+#include <cppcoro/read_write_file.hpp>
 
 #if CPPCORO_OS_WINNT
 # ifndef WIN32_LEAN_AND_MEAN
@@ -13,7 +13,7 @@
 
 cppcoro::read_write_file cppcoro::read_write_file::open(
 	io_service& ioService,
-	const std::experimental::filesystem::path& path,
+	const std::filesystem::path& path,
 	file_open_mode openMode,
 	file_share_mode shareMode,
 	file_buffering_mode bufferingMode)
@@ -35,4 +35,33 @@ cppcoro::read_write_file::read_write_file(
 {
 }
 
+#elif CPPCORO_OS_LINUX
+# include <fcntl.h>
+
+cppcoro::read_write_file cppcoro::read_write_file::open(
+	io_service& ioService,
+	const std::filesystem::path& path,
+	file_open_mode openMode,
+	file_share_mode shareMode,
+	file_buffering_mode bufferingMode)
+{
+	return read_write_file(file::open(
+		O_RDWR,
+		ioService,
+		path,
+		openMode,
+		shareMode,
+		bufferingMode),
+		ioService);
+}
+
+cppcoro::read_write_file::read_write_file(
+	detail::lnx::safe_file_descriptor&& fileHandle,
+	io_service& ioService) noexcept
+	: file(std::move(fileHandle), &ioService)
+	, readable_file(detail::lnx::safe_file_descriptor{}, &ioService)
+	, writable_file(detail::lnx::safe_file_descriptor{}, &ioService)
+{
+}
+
 #endif
@@ -4,6 +4,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <cppcoro/readable_file.hpp>
+#include <cppcoro/writable_file.hpp>
 
 #if CPPCORO_OS_WINNT
 
@@ -33,4 +34,90 @@ cppcoro::file_read_operation_cancellable cppcoro::readable_file::read(
 		std::move(ct));
 }
 
+#elif CPPCORO_OS_LINUX
+
+cppcoro::file_read_operation cppcoro::readable_file::read(
+	std::uint64_t offset,
+	void* buffer,
+	std::size_t byteCount) const noexcept
+{
+	return file_read_operation(
+		*m_ioService,
+		m_fileHandle.fd(),
+		offset,
+		buffer,
+		byteCount);
+}
+
+cppcoro::file_read_operation_cancellable cppcoro::readable_file::read(
+	std::uint64_t offset,
+	void* buffer,
+	std::size_t byteCount,
+	cancellation_token ct) const noexcept
+{
+	return file_read_operation_cancellable(
+		*m_ioService,
+		m_fileHandle.fd(),
+		offset,
+		buffer,
+		byteCount,
+		std::move(ct));
+}
+
+cppcoro::file_readv_operation cppcoro::readable_file::read(
+	std::uint64_t offset,
+	std::span<iovec> buffers) const noexcept
+{
+	return file_readv_operation(
+		*m_ioService,
+		m_fileHandle.fd(),
+		offset,
+		buffers);
+}
+
+cppcoro::file_readv_operation_cancellable cppcoro::readable_file::read(
+	std::uint64_t offset,
+	std::span<iovec> buffers,
+	cancellation_token ct) const noexcept
+{
+	return file_readv_operation_cancellable(
+		*m_ioService,
+		m_fileHandle.fd(),
+		offset,
+		buffers,
+		std::move(ct));
+}
+
+cppcoro::file_copy_operation cppcoro::readable_file::copy_to(
+	std::uint64_t offset,
+	writable_file& destination,
+	std::uint64_t destinationOffset,
+	std::size_t byteCount) const noexcept
+{
+	return file_copy_operation(
+		*m_ioService,
+		m_fileHandle.fd(),
+		offset,
+		destination.native_handle(),
+		destinationOffset,
+		byteCount);
+}
+
+cppcoro::file_copy_operation_cancellable cppcoro::readable_file::copy_to(
+	std::uint64_t offset,
+	writable_file& destination,
+	std::uint64_t destinationOffset,
+	std::size_t byteCount,
+	cancellation_token ct) const noexcept
+{
+	return file_copy_operation_cancellable(
+		*m_ioService,
+		m_fileHandle.fd(),
+		offset,
+		destination.native_handle(),
+		destinationOffset,
+		byteCount,
+		std::move(ct));
+}
+
 #endif
@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cppcoro/net/recv_buffer_pool.hpp>
+
+#if CPPCORO_OS_LINUX
+# include <cppcoro/io_service.hpp>
+
+# include "io_buffer_group.hpp"
+
+# include <cerrno>
+# include <limits>
+# include <system_error>
+
+cppcoro::net::recv_buffer_pool::recv_buffer_pool(
+	io_service& ioService,
+	std::size_t bufferSize,
+	std::uint16_t bufferCount)
+	: m_ioService(ioService)
+	, m_bufferSize(bufferSize)
+	, m_bufferCount(bufferCount)
+{
+	if (bufferSize == 0 ||
+		bufferSize > std::numeric_limits<std::uint32_t>::max() ||
+		bufferCount == 0 ||
+		(bufferCount & (bufferCount - 1)) != 0 ||
+		bufferCount > 32768)
+	{
+		throw std::system_error
+		{
+			EINVAL,
+			std::system_category(),
+			"Error creating recv_buffer_pool: invalid buffer size or count"
+		};
+	}
+
+	m_buffers = std::make_unique<std::byte[]>(bufferSize * bufferCount);
+	m_group = std::make_unique<cppcoro::detail::lnx::io_buffer_group>(
+		m_buffers.get(),
+		static_cast<std::uint32_t>(bufferSize),
+		bufferCount);
+
+	m_ioService.register_buffer_group(*m_group);
+}
+
+cppcoro::net::recv_buffer_pool::~recv_buffer_pool()
+{
+	m_ioService.unregister_buffer_group(*m_group);
+}
+
+void cppcoro::net::recv_buffer_pool::recycle(std::uint16_t bufferId) noexcept
+{
+	m_ioService.recycle_buffer(*m_group, bufferId);
+}
+
+#endif
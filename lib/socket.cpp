@@ -10,8 +10,10 @@
 #include <cppcoro/net/socket_disconnect_operation.hpp>
 #include <cppcoro/net/socket_recv_operation.hpp>
 #include <cppcoro/net/socket_send_operation.hpp>
+#include <cppcoro/net/socket_send_file_operation.hpp>
 
 #include <cppcoro/io_service.hpp>
+#include <cppcoro/readable_file.hpp>
 #include <cppcoro/on_scope_exit.hpp>
 
 #include "socket_helpers.hpp"
@@ -279,6 +281,17 @@ cppcoro::net::socket::operator=(socket&& other) noexcept
 	return *this;
 }
 
+void cppcoro::net::socket::set_reuse_port(bool enable)
+{
+	// Winsock has no equivalent of SO_REUSEPORT. SO_REUSEADDR allows several
+	// sockets to bind to the same port but does not distribute connections
+	// between them.
+	(void)enable;
+	throw std::system_error(
+		std::make_error_code(std::errc::operation_not_supported),
+		"Error setting socket option: SO_REUSEPORT");
+}
+
 void cppcoro::net::socket::bind(const ip_endpoint& localEndPoint)
 {
 	SOCKADDR_STORAGE sockaddrStorage = { 0 };
@@ -384,6 +397,25 @@ cppcoro::net::socket::accept(socket& acceptingSocket, cancellation_token ct) noe
 	return socket_accept_operation_cancellable{ *this, acceptingSocket, std::move(ct) };
 }
 
+cppcoro::async_generator<cppcoro::net::socket>
+cppcoro::net::socket::accept_many(io_service& ioService)
+{
+	return accept_many(ioService, cancellation_token{});
+}
+
+cppcoro::async_generator<cppcoro::net::socket>
+cppcoro::net::socket::accept_many(io_service& ioService, cancellation_token ct)
+{
+	while (true)
+	{
+		auto acceptingSocket = m_localEndPoint.is_ipv4() ?
+			socket::create_tcpv4(ioService) :
+			socket::create_tcpv6(ioService);
+		co_await accept(acceptingSocket, ct);
+		co_yield acceptingSocket;
+	}
+}
+
 cppcoro::net::socket_connect_operation
 cppcoro::net::socket::connect(const ip_endpoint& remoteEndPoint) noexcept
 {
@@ -420,6 +452,49 @@ cppcoro::net::socket::send(const void* buffer, std::size_t byteCount, cancellati
 	return socket_send_operation_cancellable{ *this, buffer, byteCount, std::move(ct) };
 }
 
+cppcoro::net::socket_send_buffers_operation
+cppcoro::net::socket::send(std::span<const const_buffer> buffers) noexcept
+{
+	return socket_send_buffers_operation{ *this, buffers };
+}
+
+cppcoro::net::socket_send_buffers_operation_cancellable
+cppcoro::net::socket::send(std::span<const const_buffer> buffers, cancellation_token ct) noexcept
+{
+	return socket_send_buffers_operation_cancellable{ *this, buffers, std::move(ct) };
+}
+
+cppcoro::net::socket_send_buffers_operation
+cppcoro::net::socket::send_all(std::span<const const_buffer> buffers) noexcept
+{
+	return socket_send_buffers_operation{ *this, buffers, true };
+}
+
+cppcoro::net::socket_send_buffers_operation_cancellable
+cppcoro::net::socket::send_all(std::span<const const_buffer> buffers, cancellation_token ct) noexcept
+{
+	return socket_send_buffers_operation_cancellable{ *this, buffers, std::move(ct), true };
+}
+
+cppcoro::net::socket_send_file_operation
+cppcoro::net::socket::send_file(
+	const readable_file& file,
+	std::uint64_t offset,
+	std::size_t byteCount) noexcept
+{
+	return socket_send_file_operation{ *this, file.native_handle(), offset, byteCount };
+}
+
+cppcoro::net::socket_send_file_operation_cancellable
+cppcoro::net::socket::send_file(
+	const readable_file& file,
+	std::uint64_t offset,
+	std::size_t byteCount,
+	cancellation_token ct) noexcept
+{
+	return socket_send_file_operation_cancellable{ *this, file.native_handle(), offset, byteCount, std::move(ct) };
+}
+
 cppcoro::net::socket_recv_operation
 cppcoro::net::socket::recv(void* buffer, std::size_t byteCount) noexcept
 {
@@ -432,6 +507,18 @@ cppcoro::net::socket::recv(void* buffer, std::size_t byteCount, cancellation_tok
 	return socket_recv_operation_cancellable{ *this, buffer, byteCount, std::move(ct) };
 }
 
+cppcoro::net::socket_recv_buffers_operation
+cppcoro::net::socket::recv(std::span<const mutable_buffer> buffers) noexcept
+{
+	return socket_recv_buffers_operation{ *this, buffers };
+}
+
+cppcoro::net::socket_recv_buffers_operation_cancellable
+cppcoro::net::socket::recv(std::span<const mutable_buffer> buffers, cancellation_token ct) noexcept
+{
+	return socket_recv_buffers_operation_cancellable{ *this, buffers, std::move(ct) };
+}
+
 cppcoro::net::socket_recv_from_operation
 cppcoro::net::socket::recv_from(void* buffer, std::size_t byteCount) noexcept
 {
@@ -490,4 +577,516 @@ cppcoro::net::socket::socket(
 {
 }
 
+#elif CPPCORO_OS_LINUX
+# include "socket_accept_many_operation.hpp"
+
+# include <cppcoro/cancellation_registration.hpp>
+
+# include <cerrno>
+# include <cstring>
+# include <system_error>
+
+# include <netinet/in.h>
+# include <netinet/udp.h>
+# include <sys/socket.h>
+# include <unistd.h>
+
+namespace
+{
+	namespace local
+	{
+		int create_socket(int addressFamily, int socketType, int protocol)
+		{
+			// Sockets are always non-blocking. This is needed by the epoll
+			// reactor, and by both engines for send_file().
+			const int socketHandle = ::socket(
+				addressFamily,
+				socketType | SOCK_NONBLOCK | SOCK_CLOEXEC,
+				protocol);
+			if (socketHandle == -1)
+			{
+				throw std::system_error(
+					errno,
+					std::system_category(),
+					"Error creating socket: socket");
+			}
+
+			return socketHandle;
+		}
+	}
+}
+
+cppcoro::net::socket cppcoro::net::socket::create_tcpv4(io_service& ioSvc)
+{
+	socket result(local::create_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP), ioSvc);
+	result.m_localEndPoint = ipv4_endpoint();
+	result.m_remoteEndPoint = ipv4_endpoint();
+	return result;
+}
+
+cppcoro::net::socket cppcoro::net::socket::create_tcpv6(io_service& ioSvc)
+{
+	socket result(local::create_socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP), ioSvc);
+	result.m_localEndPoint = ipv6_endpoint();
+	result.m_remoteEndPoint = ipv6_endpoint();
+	return result;
+}
+
+cppcoro::net::socket cppcoro::net::socket::create_udpv4(io_service& ioSvc)
+{
+	socket result(local::create_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP), ioSvc);
+	result.m_localEndPoint = ipv4_endpoint();
+	result.m_remoteEndPoint = ipv4_endpoint();
+	return result;
+}
+
+cppcoro::net::socket cppcoro::net::socket::create_udpv6(io_service& ioSvc)
+{
+	socket result(local::create_socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP), ioSvc);
+	result.m_localEndPoint = ipv6_endpoint();
+	result.m_remoteEndPoint = ipv6_endpoint();
+	return result;
+}
+
+cppcoro::net::socket::socket(socket&& other) noexcept
+	: m_handle(std::exchange(other.m_handle, -1))
+	, m_ioService(other.m_ioService)
+	, m_localEndPoint(std::move(other.m_localEndPoint))
+	, m_remoteEndPoint(std::move(other.m_remoteEndPoint))
+{}
+
+cppcoro::net::socket::~socket()
+{
+	if (m_handle != -1)
+	{
+		// Drop any registration before closing so that it can't be applied
+		// to a new descriptor that reuses the same number.
+		m_ioService->unregister_file(m_handle);
+		::close(m_handle);
+	}
+}
+
+cppcoro::net::socket&
+cppcoro::net::socket::operator=(socket&& other) noexcept
+{
+	auto handle = std::exchange(other.m_handle, -1);
+	if (m_handle != -1)
+	{
+		m_ioService->unregister_file(m_handle);
+		::close(m_handle);
+	}
+
+	m_handle = handle;
+	m_ioService = other.m_ioService;
+	m_localEndPoint = other.m_localEndPoint;
+	m_remoteEndPoint = other.m_remoteEndPoint;
+
+	return *this;
+}
+
+void cppcoro::net::socket::set_reuse_port(bool enable)
+{
+	const int value = enable ? 1 : 0;
+	const int result = ::setsockopt(
+		m_handle,
+		SOL_SOCKET,
+		SO_REUSEPORT,
+		&value,
+		sizeof(value));
+	if (result != 0)
+	{
+		throw std::system_error(
+			errno,
+			std::system_category(),
+			"Error setting socket option: SO_REUSEPORT");
+	}
+}
+
+void cppcoro::net::socket::set_udp_segment_size(std::uint16_t segmentSize)
+{
+	const int value = segmentSize;
+	const int result = ::setsockopt(
+		m_handle,
+		IPPROTO_UDP,
+		UDP_SEGMENT,
+		&value,
+		sizeof(value));
+	if (result != 0)
+	{
+		throw std::system_error(
+			errno,
+			std::system_category(),
+			"Error setting socket option: UDP_SEGMENT");
+	}
+}
+
+void cppcoro::net::socket::set_udp_gro(bool enable)
+{
+	const int value = enable ? 1 : 0;
+	const int result = ::setsockopt(
+		m_handle,
+		IPPROTO_UDP,
+		UDP_GRO,
+		&value,
+		sizeof(value));
+	if (result != 0)
+	{
+		throw std::system_error(
+			errno,
+			std::system_category(),
+			"Error setting socket option: UDP_GRO");
+	}
+}
+
+void cppcoro::net::socket::bind(const ip_endpoint& localEndPoint)
+{
+	sockaddr_storage sockaddrStorage;
+	const int sockaddrLength = detail::ip_endpoint_to_sockaddr(
+		localEndPoint, std::ref(sockaddrStorage));
+
+	sockaddr* sockaddr = reinterpret_cast<struct sockaddr*>(&sockaddrStorage);
+
+	int result = ::bind(m_handle, sockaddr, static_cast<socklen_t>(sockaddrLength));
+	if (result != 0)
+	{
+		throw std::system_error(
+			errno,
+			std::system_category(),
+			"Error binding to endpoint: bind()");
+	}
+
+	socklen_t nameLength = sizeof(sockaddrStorage);
+	result = ::getsockname(m_handle, sockaddr, &nameLength);
+	if (result == 0)
+	{
+		m_localEndPoint = cppcoro::net::detail::sockaddr_to_ip_endpoint(*sockaddr);
+	}
+	else
+	{
+		m_localEndPoint = localEndPoint;
+	}
+}
+
+void cppcoro::net::socket::listen()
+{
+	int result = ::listen(m_handle, SOMAXCONN);
+	if (result != 0)
+	{
+		throw std::system_error(
+			errno,
+			std::system_category(),
+			"Failed to start listening on bound endpoint: listen");
+	}
+}
+
+void cppcoro::net::socket::listen(std::uint32_t backlog)
+{
+	if (backlog > 0x7FFFFFFF)
+	{
+		backlog = 0x7FFFFFFF;
+	}
+
+	int result = ::listen(m_handle, (int)backlog);
+	if (result != 0)
+	{
+		throw std::system_error(
+			errno,
+			std::system_category(),
+			"Failed to start listening on bound endpoint: listen");
+	}
+}
+
+cppcoro::net::socket_accept_operation
+cppcoro::net::socket::accept(socket& acceptingSocket) noexcept
+{
+	return socket_accept_operation{ *m_ioService, *this, acceptingSocket };
+}
+
+cppcoro::net::socket_accept_operation_cancellable
+cppcoro::net::socket::accept(socket& acceptingSocket, cancellation_token ct) noexcept
+{
+	return socket_accept_operation_cancellable{ *m_ioService, *this, acceptingSocket, std::move(ct) };
+}
+
+cppcoro::async_generator<cppcoro::net::socket>
+cppcoro::net::socket::accept_many(io_service& ioService)
+{
+	return accept_many(ioService, cancellation_token{});
+}
+
+cppcoro::async_generator<cppcoro::net::socket>
+cppcoro::net::socket::accept_many(io_service& ioService, cancellation_token ct)
+{
+	auto operation = socket_accept_many_operation::create(*m_ioService, m_handle);
+
+	cancellation_registration cancellationCallback{
+		std::move(ct),
+		[&operation] { operation->request_cancellation(); }
+	};
+
+	while (true)
+	{
+		socket acceptedSocket{ co_await operation->next(), ioService };
+
+		sockaddr_storage sockaddrStorage;
+		auto* sockaddr = reinterpret_cast<struct sockaddr*>(&sockaddrStorage);
+
+		socklen_t nameLength = sizeof(sockaddrStorage);
+		if (::getsockname(acceptedSocket.m_handle, sockaddr, &nameLength) == 0)
+		{
+			acceptedSocket.m_localEndPoint = detail::sockaddr_to_ip_endpoint(*sockaddr);
+		}
+
+		nameLength = sizeof(sockaddrStorage);
+		if (::getpeername(acceptedSocket.m_handle, sockaddr, &nameLength) == 0)
+		{
+			acceptedSocket.m_remoteEndPoint = detail::sockaddr_to_ip_endpoint(*sockaddr);
+		}
+
+		co_yield acceptedSocket;
+	}
+}
+
+cppcoro::net::socket_connect_operation
+cppcoro::net::socket::connect(const ip_endpoint& remoteEndPoint) noexcept
+{
+	return socket_connect_operation{ *m_ioService, *this, remoteEndPoint };
+}
+
+cppcoro::net::socket_connect_operation_cancellable
+cppcoro::net::socket::connect(const ip_endpoint& remoteEndPoint, cancellation_token ct) noexcept
+{
+	return socket_connect_operation_cancellable{ *m_ioService, *this, remoteEndPoint, std::move(ct) };
+}
+
+cppcoro::net::socket_disconnect_operation
+cppcoro::net::socket::disconnect() noexcept
+{
+	return socket_disconnect_operation(*m_ioService, *this);
+}
+
+cppcoro::net::socket_disconnect_operation_cancellable
+cppcoro::net::socket::disconnect(cancellation_token ct) noexcept
+{
+	return socket_disconnect_operation_cancellable{ *m_ioService, *this, std::move(ct) };
+}
+
+cppcoro::net::socket_send_operation
+cppcoro::net::socket::send(const void* buffer, std::size_t byteCount) noexcept
+{
+	return socket_send_operation{ *m_ioService, *this, buffer, byteCount };
+}
+
+cppcoro::net::socket_send_operation_cancellable
+cppcoro::net::socket::send(const void* buffer, std::size_t byteCount, cancellation_token ct) noexcept
+{
+	return socket_send_operation_cancellable{ *m_ioService, *this, buffer, byteCount, std::move(ct) };
+}
+
+cppcoro::net::socket_send_buffers_operation
+cppcoro::net::socket::send(std::span<const const_buffer> buffers) noexcept
+{
+	return socket_send_buffers_operation{ *m_ioService, *this, buffers };
+}
+
+cppcoro::net::socket_send_buffers_operation_cancellable
+cppcoro::net::socket::send(std::span<const const_buffer> buffers, cancellation_token ct) noexcept
+{
+	return socket_send_buffers_operation_cancellable{ *m_ioService, *this, buffers, std::move(ct) };
+}
+
+cppcoro::net::socket_send_buffers_operation
+cppcoro::net::socket::send_all(std::span<const const_buffer> buffers) noexcept
+{
+	return socket_send_buffers_operation{ *m_ioService, *this, buffers, true };
+}
+
+cppcoro::net::socket_send_buffers_operation_cancellable
+cppcoro::net::socket::send_all(std::span<const const_buffer> buffers, cancellation_token ct) noexcept
+{
+	return socket_send_buffers_operation_cancellable{ *m_ioService, *this, buffers, std::move(ct), true };
+}
+
+cppcoro::net::socket_send_zerocopy_operation
+cppcoro::net::socket::send_zerocopy(const void* buffer, std::size_t byteCount) noexcept
+{
+	return socket_send_zerocopy_operation{ *m_ioService, *this, buffer, byteCount };
+}
+
+cppcoro::net::socket_send_zerocopy_operation_cancellable
+cppcoro::net::socket::send_zerocopy(const void* buffer, std::size_t byteCount, cancellation_token ct) noexcept
+{
+	return socket_send_zerocopy_operation_cancellable{ *m_ioService, *this, buffer, byteCount, std::move(ct) };
+}
+
+cppcoro::net::socket_send_file_operation
+cppcoro::net::socket::send_file(
+	const readable_file& file,
+	std::uint64_t offset,
+	std::size_t byteCount) noexcept
+{
+	return socket_send_file_operation{ *m_ioService, *this, file.native_handle(), offset, byteCount };
+}
+
+cppcoro::net::socket_send_file_operation_cancellable
+cppcoro::net::socket::send_file(
+	const readable_file& file,
+	std::uint64_t offset,
+	std::size_t byteCount,
+	cancellation_token ct) noexcept
+{
+	return socket_send_file_operation_cancellable{
+		*m_ioService, *this, file.native_handle(), offset, byteCount, std::move(ct) };
+}
+
+cppcoro::net::socket_recv_operation
+cppcoro::net::socket::recv(void* buffer, std::size_t byteCount) noexcept
+{
+	return socket_recv_operation{ *m_ioService, *this, buffer, byteCount };
+}
+
+cppcoro::net::socket_recv_operation_cancellable
+cppcoro::net::socket::recv(void* buffer, std::size_t byteCount, cancellation_token ct) noexcept
+{
+	return socket_recv_operation_cancellable{ *m_ioService, *this, buffer, byteCount, std::move(ct) };
+}
+
+cppcoro::net::socket_recv_buffers_operation
+cppcoro::net::socket::recv(std::span<const mutable_buffer> buffers) noexcept
+{
+	return socket_recv_buffers_operation{ *m_ioService, *this, buffers };
+}
+
+cppcoro::net::socket_recv_buffers_operation_cancellable
+cppcoro::net::socket::recv(std::span<const mutable_buffer> buffers, cancellation_token ct) noexcept
+{
+	return socket_recv_buffers_operation_cancellable{ *m_ioService, *this, buffers, std::move(ct) };
+}
+
+cppcoro::net::socket_recv_pooled_operation
+cppcoro::net::socket::recv(recv_buffer_pool& pool) noexcept
+{
+	return socket_recv_pooled_operation{ *m_ioService, *this, pool };
+}
+
+cppcoro::net::socket_recv_pooled_operation_cancellable
+cppcoro::net::socket::recv(recv_buffer_pool& pool, cancellation_token ct) noexcept
+{
+	return socket_recv_pooled_operation_cancellable{ *m_ioService, *this, pool, std::move(ct) };
+}
+
+cppcoro::net::socket_recv_from_operation
+cppcoro::net::socket::recv_from(void* buffer, std::size_t byteCount) noexcept
+{
+	return socket_recv_from_operation{ *m_ioService, *this, buffer, byteCount };
+}
+
+cppcoro::net::socket_recv_from_operation_cancellable
+cppcoro::net::socket::recv_from(void* buffer, std::size_t byteCount, cancellation_token ct) noexcept
+{
+	return socket_recv_from_operation_cancellable{ *m_ioService, *this, buffer, byteCount, std::move(ct) };
+}
+
+cppcoro::net::socket_send_to_operation
+cppcoro::net::socket::send_to(const ip_endpoint& destination, const void* buffer, std::size_t byteCount) noexcept
+{
+	return socket_send_to_operation{ *m_ioService, *this, destination, buffer, byteCount };
+}
+
+cppcoro::net::socket_send_to_operation_cancellable
+cppcoro::net::socket::send_to(const ip_endpoint& destination, const void* buffer, std::size_t byteCount, cancellation_token ct) noexcept
+{
+	return socket_send_to_operation_cancellable{ *m_ioService, *this, destination, buffer, byteCount, std::move(ct) };
+}
+
+cppcoro::net::socket_send_to_operation
+cppcoro::net::socket::send_to_segmented(
+	const ip_endpoint& destination,
+	const void* buffer,
+	std::size_t byteCount,
+	std::uint16_t segmentSize) noexcept
+{
+	return socket_send_to_operation{ *m_ioService, *this, destination, buffer, byteCount, segmentSize };
+}
+
+cppcoro::net::socket_send_to_operation_cancellable
+cppcoro::net::socket::send_to_segmented(
+	const ip_endpoint& destination,
+	const void* buffer,
+	std::size_t byteCount,
+	std::uint16_t segmentSize,
+	cancellation_token ct) noexcept
+{
+	return socket_send_to_operation_cancellable{
+		*m_ioService, *this, destination, buffer, byteCount, std::move(ct), segmentSize };
+}
+
+cppcoro::net::socket_recv_from_coalesced_operation
+cppcoro::net::socket::recv_from_coalesced(void* buffer, std::size_t byteCount) noexcept
+{
+	return socket_recv_from_coalesced_operation{ *m_ioService, *this, buffer, byteCount };
+}
+
+cppcoro::net::socket_recv_from_coalesced_operation_cancellable
+cppcoro::net::socket::recv_from_coalesced(void* buffer, std::size_t byteCount, cancellation_token ct) noexcept
+{
+	return socket_recv_from_coalesced_operation_cancellable{ *m_ioService, *this, buffer, byteCount, std::move(ct) };
+}
+
+cppcoro::net::socket_recv_from_batch_operation
+cppcoro::net::socket::recv_from_batch(std::span<datagram_buffer> datagrams) noexcept
+{
+	return socket_recv_from_batch_operation{ *m_ioService, *this, datagrams };
+}
+
+cppcoro::net::socket_recv_from_batch_operation_cancellable
+cppcoro::net::socket::recv_from_batch(std::span<datagram_buffer> datagrams, cancellation_token ct) noexcept
+{
+	return socket_recv_from_batch_operation_cancellable{ *m_ioService, *this, datagrams, std::move(ct) };
+}
+
+cppcoro::net::socket_send_to_batch_operation
+cppcoro::net::socket::send_to_batch(std::span<const datagram_buffer> datagrams) noexcept
+{
+	return socket_send_to_batch_operation{ *m_ioService, *this, datagrams };
+}
+
+cppcoro::net::socket_send_to_batch_operation_cancellable
+cppcoro::net::socket::send_to_batch(std::span<const datagram_buffer> datagrams, cancellation_token ct) noexcept
+{
+	return socket_send_to_batch_operation_cancellable{ *m_ioService, *this, datagrams, std::move(ct) };
+}
+
+void cppcoro::net::socket::close_send()
+{
+	int result = ::shutdown(m_handle, SHUT_WR);
+	if (result != 0)
+	{
+		throw std::system_error(
+			errno,
+			std::system_category(),
+			"failed to close socket send stream: shutdown(SHUT_WR)");
+	}
+}
+
+void cppcoro::net::socket::close_recv()
+{
+	int result = ::shutdown(m_handle, SHUT_RD);
+	if (result != 0)
+	{
+		throw std::system_error(
+			errno,
+			std::system_category(),
+			"failed to close socket receive stream: shutdown(SHUT_RD)");
+	}
+}
+
+cppcoro::net::socket::socket(
+	cppcoro::detail::lnx::fd_t handle,
+	io_service& ioService) noexcept
+	: m_handle(handle)
+	, m_ioService(&ioService)
+{
+}
+
 #endif
@@ -0,0 +1,307 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "socket_accept_many_operation.hpp"
+
+#if CPPCORO_OS_LINUX
+# include <cppcoro/operation_cancelled.hpp>
+
+# include <cerrno>
+# include <mutex>
+# include <new>
+# include <system_error>
+
+# include <linux/io_uring.h>
+# include <sys/socket.h>
+# include <unistd.h>
+
+cppcoro::net::socket_accept_many_operation::handle
+cppcoro::net::socket_accept_many_operation::create(
+	io_service& ioService,
+	cppcoro::detail::lnx::fd_t listeningHandle)
+{
+	return handle{ new socket_accept_many_operation(ioService, listeningHandle) };
+}
+
+cppcoro::net::socket_accept_many_operation::socket_accept_many_operation(
+	io_service& ioService,
+	cppcoro::detail::lnx::fd_t listeningHandle) noexcept
+	: cppcoro::detail::lnx::io_state(&socket_accept_many_operation::on_operation_completed)
+	, m_ioService(ioService)
+	, m_refCount(1)
+	, m_errorCode(0)
+	, m_isArmed(false)
+	, m_isCancelRequested(false)
+	, m_isMultishotSupported(true)
+	, m_isClosed(false)
+{
+	m_fd = listeningHandle;
+	m_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+}
+
+cppcoro::net::socket_accept_many_operation::~socket_accept_many_operation()
+{
+	// Connections that were accepted but never taken by the consumer.
+	for (auto fd : m_connections)
+	{
+		::close(fd);
+	}
+}
+
+cppcoro::net::socket_accept_many_operation::next_operation
+cppcoro::net::socket_accept_many_operation::next() noexcept
+{
+	return next_operation{ *this };
+}
+
+void cppcoro::net::socket_accept_many_operation::request_cancellation() noexcept
+{
+	std::lock_guard lock{ m_mutex };
+
+	if (m_errorCode == 0)
+	{
+		m_errorCode = ECANCELED;
+	}
+
+	// The final completion of the accept resumes any awaiting coroutine.
+	if (m_isArmed && !m_isCancelRequested)
+	{
+		m_isCancelRequested = true;
+		m_ioService.cancel_io(*this);
+	}
+}
+
+void cppcoro::net::socket_accept_many_operation::close() noexcept
+{
+	{
+		std::lock_guard lock{ m_mutex };
+
+		m_isClosed = true;
+
+		if (m_isArmed && !m_isCancelRequested)
+		{
+			m_isCancelRequested = true;
+			m_ioService.cancel_io(*this);
+		}
+	}
+
+	release_ref();
+}
+
+void cppcoro::net::socket_accept_many_operation::release_ref() noexcept
+{
+	if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		delete this;
+	}
+}
+
+bool cppcoro::net::socket_accept_many_operation::try_arm() noexcept
+{
+	// After pausing, wait for the consumer to take half of the buffered
+	// connections so that we don't pause again after every connection.
+	if (m_isArmed ||
+		m_isClosed ||
+		m_errorCode != 0 ||
+		m_connections.size() > max_buffered_connections / 2)
+	{
+		return false;
+	}
+
+	m_isArmed = true;
+	m_isCancelRequested = false;
+	m_opcode = m_isMultishotSupported ?
+		cppcoro::detail::lnx::io_opcode::accept_multishot :
+		cppcoro::detail::lnx::io_opcode::accept;
+
+	// Account for the final completion now, while the consumer's reference
+	// is known to be held, so that we stay alive until it has been handled.
+	if (__atomic_fetch_add(&m_pendingCallbacks, 1, __ATOMIC_RELAXED) == 0)
+	{
+		m_refCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	return true;
+}
+
+void cppcoro::net::socket_accept_many_operation::start() noexcept
+{
+	std::int32_t result;
+	if (!m_ioService.try_start_io(*this, result))
+	{
+		on_operation_completed(this, result, 0);
+		return;
+	}
+
+	// A cancellation requested between arming and submitting the accept
+	// found nothing to cancel, so send it again now that it is in flight.
+	// The pending final completion keeps us alive until we return.
+	std::lock_guard lock{ m_mutex };
+	if (m_isArmed && m_isCancelRequested)
+	{
+		m_ioService.cancel_io(*this);
+	}
+}
+
+void cppcoro::net::socket_accept_many_operation::on_operation_completed(
+	cppcoro::detail::lnx::io_state* ioState,
+	std::int32_t result,
+	std::uint32_t flags) noexcept
+{
+	auto* operation = static_cast<socket_accept_many_operation*>(ioState);
+
+	const bool isFinal = (flags & IORING_CQE_F_MORE) == 0;
+
+	bool rearm = false;
+	std::coroutine_handle<> awaitingCoroutine;
+
+	{
+		std::lock_guard lock{ operation->m_mutex };
+
+		if (result >= 0)
+		{
+			bool isBuffered = false;
+			if (!operation->m_isClosed)
+			{
+				try
+				{
+					operation->m_connections.push_back(result);
+					isBuffered = true;
+				}
+				catch (const std::bad_alloc&)
+				{
+				}
+			}
+
+			if (!isBuffered)
+			{
+				::close(result);
+			}
+		}
+		else if (
+			result == -EINVAL &&
+			operation->m_opcode == cppcoro::detail::lnx::io_opcode::accept_multishot)
+		{
+			// Kernels before 5.19 don't support multishot accept.
+			operation->m_isMultishotSupported = false;
+		}
+		else if (result == -ECANCELED && operation->m_isCancelRequested)
+		{
+			// We cancelled the accept ourselves to pause or stop accepting.
+		}
+		else if (result == -ECONNABORTED)
+		{
+			// The connection was reset before we got to it. Keep accepting.
+		}
+		else if (operation->m_errorCode == 0)
+		{
+			operation->m_errorCode = -result;
+		}
+
+		if (isFinal)
+		{
+			operation->m_isArmed = false;
+			rearm = operation->try_arm();
+		}
+		else if (operation->m_isCancelRequested)
+		{
+			// The accept is still running, so the cancellation may have been
+			// lost in a race with its submission. Send it again.
+			operation->m_ioService.cancel_io(*operation);
+		}
+		else if (operation->m_connections.size() >= max_buffered_connections)
+		{
+			// The consumer is falling behind. Leave further connections in
+			// the listening socket's backlog until it catches up.
+			operation->m_isCancelRequested = true;
+			operation->m_ioService.cancel_io(*operation);
+		}
+
+		if (operation->m_awaitingCoroutine &&
+			(!operation->m_connections.empty() || operation->m_errorCode != 0))
+		{
+			awaitingCoroutine = std::exchange(operation->m_awaitingCoroutine, nullptr);
+		}
+	}
+
+	if (rearm)
+	{
+		operation->start();
+	}
+
+	if (awaitingCoroutine)
+	{
+		awaitingCoroutine.resume();
+	}
+
+	if (__atomic_sub_fetch(&operation->m_pendingCallbacks, 1, __ATOMIC_ACQ_REL) == 0)
+	{
+		operation->release_ref();
+	}
+}
+
+bool cppcoro::net::socket_accept_many_operation::next_operation::await_suspend(
+	std::coroutine_handle<> awaitingCoroutine) noexcept
+{
+	bool rearm;
+
+	{
+		std::lock_guard lock{ m_operation.m_mutex };
+
+		if (!m_operation.m_connections.empty() || m_operation.m_errorCode != 0)
+		{
+			return false;
+		}
+
+		m_operation.m_awaitingCoroutine = awaitingCoroutine;
+		rearm = m_operation.try_arm();
+	}
+
+	if (rearm)
+	{
+		m_operation.start();
+	}
+
+	return true;
+}
+
+cppcoro::detail::lnx::fd_t
+cppcoro::net::socket_accept_many_operation::next_operation::await_resume()
+{
+	cppcoro::detail::lnx::fd_t fd;
+	bool rearm;
+
+	{
+		std::lock_guard lock{ m_operation.m_mutex };
+
+		const int errorCode = m_operation.m_errorCode;
+		if (errorCode == ECANCELED)
+		{
+			throw operation_cancelled{};
+		}
+
+		if (m_operation.m_connections.empty())
+		{
+			throw std::system_error{
+				errorCode,
+				std::system_category(),
+				"Accepting a connection failed: accept"
+			};
+		}
+
+		fd = m_operation.m_connections.front();
+		m_operation.m_connections.pop_front();
+		rearm = m_operation.try_arm();
+	}
+
+	if (rearm)
+	{
+		m_operation.start();
+	}
+
+	return fd;
+}
+
+#endif
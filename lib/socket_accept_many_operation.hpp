@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CPPCORO_PRIVATE_SOCKET_ACCEPT_MANY_OPERATION_HPP_INCLUDED
+#define CPPCORO_PRIVATE_SOCKET_ACCEPT_MANY_OPERATION_HPP_INCLUDED
+
+#include <cppcoro/config.hpp>
+
+#if CPPCORO_OS_LINUX
+# include <cppcoro/io_service.hpp>
+# include <cppcoro/detail/linux.hpp>
+
+# include "spin_mutex.hpp"
+
+# include <atomic>
+# include <coroutine>
+# include <cstddef>
+# include <cstdint>
+# include <deque>
+# include <memory>
+
+namespace cppcoro
+{
+	namespace net
+	{
+		/// \brief
+		/// Accepts connections on a listening socket with a single multishot
+		/// accept that stays armed between connections.
+		///
+		/// Accepted connections are buffered until they are taken with next().
+		/// Once max_buffered_connections are buffered the multishot accept is
+		/// cancelled, leaving further connections in the listening socket's
+		/// backlog, and is re-armed once the consumer has taken half of them.
+		///
+		/// Kernels without multishot accept support fall back to starting a
+		/// new single-shot accept after each connection.
+		///
+		/// The operation is reference counted so that it stays alive until
+		/// its final completion, which may be some time after the consumer
+		/// has released it.
+		class socket_accept_many_operation final
+			: private cppcoro::detail::lnx::io_state
+		{
+			struct deleter
+			{
+				void operator()(socket_accept_many_operation* operation) const noexcept
+				{
+					operation->close();
+				}
+			};
+
+		public:
+
+			class next_operation;
+
+			/// Holds the consumer's reference to the operation.
+			using handle = std::unique_ptr<socket_accept_many_operation, deleter>;
+
+			/// The number of accepted connections to buffer before pausing.
+			static constexpr std::size_t max_buffered_connections = 64;
+
+			/// Create an operation that accepts connections on \p listeningHandle
+			/// using \p ioService.
+			///
+			/// Accepting starts on the first call to next().
+			///
+			/// \throw std::bad_alloc
+			static handle create(
+				io_service& ioService,
+				cppcoro::detail::lnx::fd_t listeningHandle);
+
+			/// Returns an awaitable that produces the file descriptor of the next
+			/// accepted connection, which the caller then owns.
+			///
+			/// co_await throws operation_cancelled once request_cancellation()
+			/// has been called, or std::system_error if accepting failed.
+			///
+			/// Only one next() operation may be outstanding at a time.
+			next_operation next() noexcept;
+
+			/// Stop accepting connections.
+			///
+			/// May be called from any thread.
+			void request_cancellation() noexcept;
+
+		private:
+
+			socket_accept_many_operation(
+				io_service& ioService,
+				cppcoro::detail::lnx::fd_t listeningHandle) noexcept;
+
+			~socket_accept_many_operation();
+
+			/// Release the consumer's reference, cancelling the accept.
+			void close() noexcept;
+
+			void release_ref() noexcept;
+
+			/// Start accepting once the operation has been marked as armed.
+			///
+			/// Must be called without m_mutex held.
+			void start() noexcept;
+
+			/// Query whether the operation should be re-armed and if so, mark
+			/// it as armed.
+			///
+			/// Must be called with m_mutex held.
+			bool try_arm() noexcept;
+
+			static void on_operation_completed(
+				cppcoro::detail::lnx::io_state* ioState,
+				std::int32_t result,
+				std::uint32_t flags) noexcept;
+
+			io_service& m_ioService;
+
+			// The consumer's reference plus one while any callbacks are pending.
+			std::atomic<std::uint32_t> m_refCount;
+
+			// Protects the remaining members.
+			spin_mutex m_mutex;
+
+			std::deque<cppcoro::detail::lnx::fd_t> m_connections;
+
+			// The errno value that ended the sequence, if any.
+			int m_errorCode;
+
+			// Whether an accept has been started and has not had its final
+			// completion yet.
+			bool m_isArmed;
+
+			// Whether the accept that is currently armed has been cancelled.
+			bool m_isCancelRequested;
+
+			bool m_isMultishotSupported;
+
+			// Whether the consumer has released its reference.
+			bool m_isClosed;
+
+			std::coroutine_handle<> m_awaitingCoroutine;
+
+		};
+
+		class socket_accept_many_operation::next_operation
+		{
+		public:
+
+			explicit next_operation(socket_accept_many_operation& operation) noexcept
+				: m_operation(operation)
+			{}
+
+			bool await_ready() const noexcept { return false; }
+
+			bool await_suspend(std::coroutine_handle<> awaitingCoroutine) noexcept;
+
+			cppcoro::detail::lnx::fd_t await_resume();
+
+		private:
+
+			socket_accept_many_operation& m_operation;
+
+		};
+	}
+}
+
+#endif
+
+#endif
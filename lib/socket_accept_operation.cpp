@@ -127,3 +127,67 @@ void cppcoro::net::socket_accept_operation_impl::get_result(
 }
 
 #endif
+
+#if CPPCORO_OS_LINUX
+# include <sys/socket.h>
+# include <unistd.h>
+
+bool cppcoro::net::socket_accept_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	auto& state = operation.get_io_state();
+	state.m_opcode = cppcoro::detail::lnx::io_opcode::accept;
+	state.m_fd = m_listeningSocket.native_handle();
+	state.m_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+	return operation.try_start_io();
+}
+
+void cppcoro::net::socket_accept_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+void cppcoro::net::socket_accept_operation_impl::get_result(
+	cppcoro::detail::linux_async_operation_base& operation)
+{
+	if (operation.m_result < 0)
+	{
+		throw std::system_error{
+			-operation.m_result,
+			std::system_category(),
+			"Accepting a connection failed: accept"
+		};
+	}
+
+	// Unlike AcceptEx(), accept() creates a new socket for the connection
+	// rather than using the accepting socket. Replace the accepting socket's
+	// file descriptor with the new one.
+	const cppcoro::detail::lnx::fd_t acceptedHandle = operation.m_result;
+	::close(m_acceptingSocket.m_handle);
+	m_acceptingSocket.m_handle = acceptedHandle;
+
+	sockaddr_storage localSockaddr;
+	socklen_t localSockaddrLength = sizeof(localSockaddr);
+	if (::getsockname(
+		acceptedHandle,
+		reinterpret_cast<sockaddr*>(&localSockaddr),
+		&localSockaddrLength) == 0)
+	{
+		m_acceptingSocket.m_localEndPoint =
+			detail::sockaddr_to_ip_endpoint(*reinterpret_cast<const sockaddr*>(&localSockaddr));
+	}
+
+	sockaddr_storage remoteSockaddr;
+	socklen_t remoteSockaddrLength = sizeof(remoteSockaddr);
+	if (::getpeername(
+		acceptedHandle,
+		reinterpret_cast<sockaddr*>(&remoteSockaddr),
+		&remoteSockaddrLength) == 0)
+	{
+		m_acceptingSocket.m_remoteEndPoint =
+			detail::sockaddr_to_ip_endpoint(*reinterpret_cast<const sockaddr*>(&remoteSockaddr));
+	}
+}
+
+#endif
@@ -176,3 +176,90 @@ void cppcoro::net::socket_connect_operation_impl::get_result(
 }
 
 #endif
+
+#if CPPCORO_OS_LINUX
+# include <cstring>
+
+# include <netinet/in.h>
+# include <sys/socket.h>
+
+bool cppcoro::net::socket_connect_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	static_assert(
+		sizeof(m_remoteSockaddrStorage) >= sizeof(sockaddr_in) &&
+		sizeof(m_remoteSockaddrStorage) >= sizeof(sockaddr_in6));
+
+	sockaddr_storage remoteSockaddrStorage;
+	const int sockaddrNameLength = cppcoro::net::detail::ip_endpoint_to_sockaddr(
+		m_remoteEndPoint,
+		std::ref(remoteSockaddrStorage));
+	std::memcpy(&m_remoteSockaddrStorage, &remoteSockaddrStorage, sockaddrNameLength);
+
+	auto& state = operation.get_io_state();
+	state.m_opcode = cppcoro::detail::lnx::io_opcode::connect;
+	state.m_fd = m_socket.native_handle();
+	state.m_buffer = &m_remoteSockaddrStorage;
+	state.m_length = static_cast<std::uint64_t>(sockaddrNameLength);
+	return operation.try_start_io();
+}
+
+void cppcoro::net::socket_connect_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+void cppcoro::net::socket_connect_operation_impl::get_result(
+	cppcoro::detail::linux_async_operation_base& operation)
+{
+	if (operation.m_result < 0)
+	{
+		throw std::system_error{
+			-operation.m_result,
+			std::system_category(),
+			"Connect operation failed: connect"
+		};
+	}
+
+	{
+		sockaddr_storage localSockaddr;
+		socklen_t nameLength = sizeof(localSockaddr);
+		const int result = ::getsockname(
+			m_socket.native_handle(),
+			reinterpret_cast<sockaddr*>(&localSockaddr),
+			&nameLength);
+		if (result == 0)
+		{
+			m_socket.m_localEndPoint = cppcoro::net::detail::sockaddr_to_ip_endpoint(
+				*reinterpret_cast<const sockaddr*>(&localSockaddr));
+		}
+		else
+		{
+			// Failed to get the updated local-end-point
+			// Just leave m_localEndPoint set to whatever bind() left it as.
+		}
+	}
+
+	{
+		sockaddr_storage remoteSockaddr;
+		socklen_t nameLength = sizeof(remoteSockaddr);
+		const int result = ::getpeername(
+			m_socket.native_handle(),
+			reinterpret_cast<sockaddr*>(&remoteSockaddr),
+			&nameLength);
+		if (result == 0)
+		{
+			m_socket.m_remoteEndPoint = cppcoro::net::detail::sockaddr_to_ip_endpoint(
+				*reinterpret_cast<const sockaddr*>(&remoteSockaddr));
+		}
+		else
+		{
+			// Failed to get the actual remote end-point so just fall back to
+			// remembering the actual end-point that was passed to connect().
+			m_socket.m_remoteEndPoint = m_remoteEndPoint;
+		}
+	}
+}
+
+#endif
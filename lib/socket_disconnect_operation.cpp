@@ -105,3 +105,47 @@ void cppcoro::net::socket_disconnect_operation_impl::get_result(
 }
 
 #endif
+
+#if CPPCORO_OS_LINUX
+# include <cerrno>
+# include <sys/socket.h>
+
+bool cppcoro::net::socket_disconnect_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	// Unlike DisconnectEx(), shutdown() never waits, so the operation
+	// always completes synchronously.
+	if (::shutdown(m_socket.native_handle(), SHUT_RDWR) == 0)
+	{
+		operation.m_result = 0;
+	}
+	else
+	{
+		// ENOTCONN means that the connection has already been closed.
+		operation.m_result = errno == ENOTCONN ? 0 : -errno;
+	}
+
+	return false;
+}
+
+void cppcoro::net::socket_disconnect_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	// Never started asynchronously so there is nothing to cancel.
+	(void)operation;
+}
+
+void cppcoro::net::socket_disconnect_operation_impl::get_result(
+	cppcoro::detail::linux_async_operation_base& operation)
+{
+	if (operation.m_result < 0)
+	{
+		throw std::system_error{
+			-operation.m_result,
+			std::system_category(),
+			"Disconnect operation failed: shutdown"
+		};
+	}
+}
+
+#endif
@@ -11,8 +11,12 @@
 # include <cppcoro/detail/win32.hpp>
 struct sockaddr;
 struct sockaddr_storage;
+#elif CPPCORO_OS_LINUX
+# include <sys/socket.h>
 #endif
 
+#include <functional>
+
 namespace cppcoro
 {
 	namespace net
@@ -21,7 +25,7 @@ namespace cppcoro
 
 		namespace detail
 		{
-#if CPPCORO_OS_WINNT
+#if CPPCORO_OS_WINNT || CPPCORO_OS_LINUX
 			/// Convert a sockaddr to an IP endpoint.
 			ip_endpoint sockaddr_to_ip_endpoint(const sockaddr& address) noexcept;
 
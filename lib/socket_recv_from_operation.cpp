@@ -94,3 +94,187 @@ cppcoro::net::socket_recv_from_operation_impl::get_result(
 }
 
 #endif
+
+#if CPPCORO_OS_LINUX
+# include "socket_helpers.hpp"
+
+# include <cstring>
+# include <new>
+# include <system_error>
+
+# include <netinet/in.h>
+# include <netinet/udp.h>
+# include <sys/socket.h>
+
+namespace
+{
+	namespace local
+	{
+		// Linux transfers at most this many bytes in a single call.
+		constexpr std::size_t max_transfer_size = 0x7FFFF000;
+	}
+}
+
+bool cppcoro::net::socket_recv_from_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	if (m_buffer.iov_len > local::max_transfer_size)
+	{
+		m_buffer.iov_len = local::max_transfer_size;
+	}
+
+	static_assert(
+		sizeof(m_sourceSockaddrStorage) >= sizeof(sockaddr_in) &&
+		sizeof(m_sourceSockaddrStorage) >= sizeof(sockaddr_in6));
+	static_assert(sizeof(m_messageStorage) >= sizeof(msghdr));
+
+	auto* message = new (&m_messageStorage) msghdr{};
+	message->msg_name = &m_sourceSockaddrStorage;
+	message->msg_namelen = sizeof(m_sourceSockaddrStorage);
+	message->msg_iov = &m_buffer;
+	message->msg_iovlen = 1;
+
+	if (m_reportSegmentSize)
+	{
+		static_assert(sizeof(m_controlStorage) >= CMSG_SPACE(sizeof(int)));
+		message->msg_control = &m_controlStorage;
+		message->msg_controllen = sizeof(m_controlStorage);
+	}
+
+	auto& state = operation.get_io_state();
+	state.m_opcode = cppcoro::detail::lnx::io_opcode::recvmsg;
+	state.m_fd = m_socket.native_handle();
+
+	// Report the full size of a datagram that doesn't fit in the buffer
+	// so that get_result() can tell that it was truncated.
+	state.m_flags = MSG_TRUNC;
+	state.m_buffer = message;
+	return operation.try_start_io();
+}
+
+void cppcoro::net::socket_recv_from_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+std::tuple<std::size_t, cppcoro::net::ip_endpoint>
+cppcoro::net::socket_recv_from_operation_impl::get_result(
+	cppcoro::detail::linux_async_operation_base& operation)
+{
+	if (operation.m_result < 0)
+	{
+		throw std::system_error(
+			-operation.m_result,
+			std::system_category(),
+			"Error receiving message on socket: recvmsg");
+	}
+
+	if (static_cast<std::size_t>(operation.m_result) > m_buffer.iov_len)
+	{
+		throw std::system_error(
+			EMSGSIZE,
+			std::system_category(),
+			"Error receiving message on socket: recvmsg");
+	}
+
+	return std::make_tuple(
+		static_cast<std::size_t>(operation.m_result),
+		detail::sockaddr_to_ip_endpoint(
+			*reinterpret_cast<const sockaddr*>(&m_sourceSockaddrStorage)));
+}
+
+std::tuple<std::size_t, cppcoro::net::ip_endpoint, std::size_t>
+cppcoro::net::socket_recv_from_operation_impl::get_coalesced_result(
+	cppcoro::detail::linux_async_operation_base& operation)
+{
+	auto [bytesReceived, source] = get_result(operation);
+
+	// Without a UDP_GRO control message we received a single datagram.
+	std::size_t segmentSize = bytesReceived;
+
+	auto* message = reinterpret_cast<msghdr*>(&m_messageStorage);
+	for (auto* control = CMSG_FIRSTHDR(message);
+		control != nullptr;
+		control = CMSG_NXTHDR(message, control))
+	{
+		if (control->cmsg_level == IPPROTO_UDP && control->cmsg_type == UDP_GRO)
+		{
+			int value;
+			std::memcpy(&value, CMSG_DATA(control), sizeof(value));
+			segmentSize = static_cast<std::size_t>(value);
+		}
+	}
+
+	return std::make_tuple(bytesReceived, std::move(source), segmentSize);
+}
+
+bool cppcoro::net::socket_recv_from_batch_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	static_assert(
+		sizeof(m_sourceSockaddrStorage[0]) >= sizeof(sockaddr_in) &&
+		sizeof(m_sourceSockaddrStorage[0]) >= sizeof(sockaddr_in6));
+	static_assert(sizeof(m_messageStorage[0]) == sizeof(mmsghdr));
+
+	if (m_datagrams.empty())
+	{
+		operation.m_result = 0;
+		return false;
+	}
+
+	auto* messages = reinterpret_cast<mmsghdr*>(&m_messageStorage);
+	for (std::size_t i = 0; i < m_datagrams.size(); ++i)
+	{
+		m_buffers[i].iov_base = m_datagrams[i].buffer;
+		m_buffers[i].iov_len = m_datagrams[i].size <= local::max_transfer_size ?
+			m_datagrams[i].size : local::max_transfer_size;
+
+		auto* message = new (&m_messageStorage[i]) mmsghdr{};
+		message->msg_hdr.msg_name = &m_sourceSockaddrStorage[i];
+		message->msg_hdr.msg_namelen = sizeof(m_sourceSockaddrStorage[i]);
+		message->msg_hdr.msg_iov = &m_buffers[i];
+		message->msg_hdr.msg_iovlen = 1;
+	}
+
+	auto& state = operation.get_io_state();
+	state.m_opcode = cppcoro::detail::lnx::io_opcode::recvmmsg;
+	state.m_fd = m_socket.native_handle();
+
+	// Report the full size of datagrams that don't fit in their buffer.
+	state.m_flags = MSG_TRUNC;
+	state.m_buffer = messages;
+	state.m_length = m_datagrams.size();
+	return operation.try_start_io();
+}
+
+void cppcoro::net::socket_recv_from_batch_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+std::size_t cppcoro::net::socket_recv_from_batch_operation_impl::get_result(
+	cppcoro::detail::linux_async_operation_base& operation)
+{
+	if (operation.m_result < 0)
+	{
+		throw std::system_error(
+			-operation.m_result,
+			std::system_category(),
+			"Error receiving messages on socket: recvmmsg");
+	}
+
+	const auto* messages = reinterpret_cast<const mmsghdr*>(&m_messageStorage);
+	const auto count = static_cast<std::size_t>(operation.m_result);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		m_datagrams[i].bytesTransferred = messages[i].msg_len;
+		m_datagrams[i].endpoint = detail::sockaddr_to_ip_endpoint(
+			*reinterpret_cast<const sockaddr*>(&m_sourceSockaddrStorage[i]));
+	}
+
+	return count;
+}
+
+#endif
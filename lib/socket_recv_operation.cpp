@@ -63,4 +63,132 @@ void cppcoro::net::socket_recv_operation_impl::cancel(
 		operation.get_overlapped());
 }
 
+bool cppcoro::net::socket_recv_buffers_operation_impl::try_start(
+	cppcoro::detail::win32_overlapped_operation_base& operation) noexcept
+{
+	for (std::size_t i = 0; i < m_buffers.size(); ++i)
+	{
+		m_wsaBuffers[i] = cppcoro::detail::win32::wsabuf{
+			m_buffers[i].data(), m_buffers[i].size() };
+	}
+
+	// See socket_recv_operation_impl::try_start().
+	const bool skipCompletionOnSuccess = m_socket.skip_completion_on_success();
+
+	DWORD numberOfBytesReceived = 0;
+	DWORD flags = 0;
+	int result = ::WSARecv(
+		m_socket.native_handle(),
+		reinterpret_cast<WSABUF*>(m_wsaBuffers),
+		static_cast<DWORD>(m_buffers.size()),
+		&numberOfBytesReceived,
+		&flags,
+		operation.get_overlapped(),
+		nullptr);
+	if (result == SOCKET_ERROR)
+	{
+		int errorCode = ::WSAGetLastError();
+		if (errorCode != WSA_IO_PENDING)
+		{
+			// Failed synchronously.
+			operation.m_errorCode = static_cast<DWORD>(errorCode);
+			operation.m_numberOfBytesTransferred = numberOfBytesReceived;
+			return false;
+		}
+	}
+	else if (skipCompletionOnSuccess)
+	{
+		// Completed synchronously, no completion event will be posted to the IOCP.
+		operation.m_errorCode = ERROR_SUCCESS;
+		operation.m_numberOfBytesTransferred = numberOfBytesReceived;
+		return false;
+	}
+
+	// Operation will complete asynchronously.
+	return true;
+}
+
+void cppcoro::net::socket_recv_buffers_operation_impl::cancel(
+	cppcoro::detail::win32_overlapped_operation_base& operation) noexcept
+{
+	(void)::CancelIoEx(
+		reinterpret_cast<HANDLE>(m_socket.native_handle()),
+		operation.get_overlapped());
+}
+
+#endif
+
+#if CPPCORO_OS_LINUX
+# include <new>
+
+# include <sys/socket.h>
+
+namespace
+{
+	namespace local
+	{
+		// Linux transfers at most this many bytes in a single call.
+		constexpr std::size_t max_transfer_size = 0x7FFFF000;
+	}
+}
+
+bool cppcoro::net::socket_recv_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	auto& state = operation.get_io_state();
+	state.m_opcode = cppcoro::detail::lnx::io_opcode::recv;
+	state.m_fd = m_socket.native_handle();
+	state.m_flags = 0;
+	state.m_buffer = m_buffer;
+	state.m_length = m_byteCount <= local::max_transfer_size ?
+		m_byteCount : local::max_transfer_size;
+	return operation.try_start_io();
+}
+
+void cppcoro::net::socket_recv_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+bool cppcoro::net::socket_recv_buffers_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	static_assert(sizeof(m_messageStorage) >= sizeof(msghdr));
+
+	// Limit the total so that the number of bytes received fits in the result.
+	std::size_t remaining = local::max_transfer_size;
+	std::size_t bufferCount = 0;
+	for (const auto& buffer : m_buffers)
+	{
+		const std::size_t size = buffer.size() <= remaining ? buffer.size() : remaining;
+		m_iovecs[bufferCount].iov_base = buffer.data();
+		m_iovecs[bufferCount].iov_len = size;
+		++bufferCount;
+
+		remaining -= size;
+		if (remaining == 0)
+		{
+			break;
+		}
+	}
+
+	auto* message = new (&m_messageStorage) msghdr{};
+	message->msg_iov = m_iovecs;
+	message->msg_iovlen = bufferCount;
+
+	auto& state = operation.get_io_state();
+	state.m_opcode = cppcoro::detail::lnx::io_opcode::recvmsg;
+	state.m_fd = m_socket.native_handle();
+	state.m_flags = 0;
+	state.m_buffer = message;
+	return operation.try_start_io();
+}
+
+void cppcoro::net::socket_recv_buffers_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
 #endif
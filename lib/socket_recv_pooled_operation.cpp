@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cppcoro/net/socket_recv_pooled_operation.hpp>
+#include <cppcoro/net/socket.hpp>
+
+#if CPPCORO_OS_LINUX
+# include "io_buffer_group.hpp"
+
+# include <system_error>
+
+# include <linux/io_uring.h>
+
+bool cppcoro::net::socket_recv_pooled_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	auto& state = operation.get_io_state();
+	state.m_opcode = cppcoro::detail::lnx::io_opcode::recv_select_buffer;
+	state.m_fd = m_socket.native_handle();
+	state.m_flags = 0;
+	state.m_buffer = &m_pool.group();
+	state.m_length = 0;
+	return operation.try_start_io();
+}
+
+void cppcoro::net::socket_recv_pooled_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+cppcoro::net::recv_buffer_lease
+cppcoro::net::socket_recv_pooled_operation_impl::get_result(
+	cppcoro::detail::linux_async_operation_base& operation)
+{
+	const bool hasBuffer = (operation.m_resultFlags & IORING_CQE_F_BUFFER) != 0;
+	const auto bufferId = static_cast<std::uint16_t>(
+		operation.m_resultFlags >> IORING_CQE_BUFFER_SHIFT);
+
+	if (operation.m_result <= 0)
+	{
+		if (hasBuffer)
+		{
+			// Nothing was received into the buffer.
+			m_pool.recycle(bufferId);
+		}
+
+		if (operation.m_result < 0)
+		{
+			throw std::system_error{
+				-operation.m_result,
+				std::system_category()
+			};
+		}
+
+		// The peer closed the connection.
+		return recv_buffer_lease{};
+	}
+
+	return recv_buffer_lease{
+		m_pool,
+		m_pool.group().buffer(bufferId),
+		static_cast<std::size_t>(operation.m_result),
+		bufferId
+	};
+}
+
+#endif
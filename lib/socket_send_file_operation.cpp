@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cppcoro/net/socket_send_file_operation.hpp>
+#include <cppcoro/net/socket.hpp>
+
+#if CPPCORO_OS_WINNT
+# include <WinSock2.h>
+# include <WS2tcpip.h>
+# include <MSWSock.h>
+# include <Windows.h>
+
+bool cppcoro::net::socket_send_file_operation_impl::try_start(
+	cppcoro::detail::win32_overlapped_operation_base& operation) noexcept
+{
+	if (m_byteCount == 0)
+	{
+		// TransmitFile() interprets a byte count of zero as 'send the
+		// rest of the file'.
+		operation.m_errorCode = ERROR_SUCCESS;
+		operation.m_numberOfBytesTransferred = 0;
+		return false;
+	}
+
+	// Need to read this flag before starting the operation, otherwise
+	// it may be possible that the operation will complete immediately
+	// on another thread and then destroy the socket before we get a
+	// chance to read it.
+	const bool skipCompletionOnSuccess = m_socket.skip_completion_on_success();
+
+	// TransmitFile() can send at most 2^31 - 2 bytes at a time.
+	const DWORD numberOfBytesToWrite =
+		m_byteCount <= 0x7FFFFFFE ?
+		static_cast<DWORD>(m_byteCount) : DWORD(0x7FFFFFFE);
+
+	// The file offset to send from is taken from the OVERLAPPED structure.
+	BOOL ok = ::TransmitFile(
+		m_socket.native_handle(),
+		m_fileHandle,
+		numberOfBytesToWrite,
+		0, // default send size
+		operation.get_overlapped(),
+		nullptr,
+		0);
+	if (!ok)
+	{
+		int errorCode = ::WSAGetLastError();
+		if (errorCode != WSA_IO_PENDING && errorCode != ERROR_IO_PENDING)
+		{
+			// Failed synchronously.
+			operation.m_errorCode = static_cast<DWORD>(errorCode);
+			operation.m_numberOfBytesTransferred = 0;
+			return false;
+		}
+	}
+	else if (skipCompletionOnSuccess)
+	{
+		// Completed synchronously, no completion event will be posted to the IOCP.
+		DWORD numberOfBytesSent = 0;
+		DWORD flags = 0;
+		ok = ::WSAGetOverlappedResult(
+			m_socket.native_handle(),
+			operation.get_overlapped(),
+			&numberOfBytesSent,
+			FALSE,
+			&flags);
+		operation.m_errorCode = ok ? ERROR_SUCCESS : static_cast<DWORD>(::WSAGetLastError());
+		operation.m_numberOfBytesTransferred = numberOfBytesSent;
+		return false;
+	}
+
+	// Operation will complete asynchronously.
+	return true;
+}
+
+void cppcoro::net::socket_send_file_operation_impl::cancel(
+	cppcoro::detail::win32_overlapped_operation_base& operation) noexcept
+{
+	(void)::CancelIoEx(
+		reinterpret_cast<HANDLE>(m_socket.native_handle()),
+		operation.get_overlapped());
+}
+
+#endif
+
+#if CPPCORO_OS_LINUX
+
+namespace
+{
+	namespace local
+	{
+		// Linux transfers at most this many bytes in a single call.
+		constexpr std::size_t max_transfer_size = 0x7FFFF000;
+	}
+}
+
+bool cppcoro::net::socket_send_file_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	auto& state = operation.get_io_state();
+	state.m_opcode = cppcoro::detail::lnx::io_opcode::sendfile;
+	state.m_fd = m_socket.native_handle();
+	state.m_buffer = &m_source;
+	state.m_length = m_byteCount <= local::max_transfer_size ?
+		m_byteCount : local::max_transfer_size;
+	return operation.try_start_io();
+}
+
+void cppcoro::net::socket_send_file_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+#endif
@@ -12,6 +12,8 @@
 # include <MSWSock.h>
 # include <Windows.h>
 
+# include <new>
+
 bool cppcoro::net::socket_send_operation_impl::try_start(
 	cppcoro::detail::win32_overlapped_operation_base& operation) noexcept
 {
@@ -61,4 +63,312 @@ void cppcoro::net::socket_send_operation_impl::cancel(
 		operation.get_overlapped());
 }
 
+bool cppcoro::net::socket_send_buffers_operation_impl::try_start(
+	cppcoro::detail::win32_overlapped_operation_base& operation) noexcept
+{
+	auto* wsaBuffers = m_wsaBuffers;
+	if (m_buffers.size() > max_buffer_count)
+	{
+		m_allWsaBuffers.reset(
+			new (std::nothrow) cppcoro::detail::win32::wsabuf[m_buffers.size()]);
+		if (!m_allWsaBuffers)
+		{
+			operation.m_errorCode = WSAENOBUFS;
+			operation.m_numberOfBytesTransferred = 0;
+			return false;
+		}
+
+		wsaBuffers = m_allWsaBuffers.get();
+	}
+
+	for (std::size_t i = 0; i < m_buffers.size(); ++i)
+	{
+		wsaBuffers[i] = cppcoro::detail::win32::wsabuf{
+			const_cast<void*>(m_buffers[i].data()), m_buffers[i].size() };
+	}
+
+	// See socket_send_operation_impl::try_start().
+	const bool skipCompletionOnSuccess = m_socket.skip_completion_on_success();
+
+	DWORD numberOfBytesSent = 0;
+	int result = ::WSASend(
+		m_socket.native_handle(),
+		reinterpret_cast<WSABUF*>(wsaBuffers),
+		static_cast<DWORD>(m_buffers.size()),
+		&numberOfBytesSent,
+		0, // flags
+		operation.get_overlapped(),
+		nullptr);
+	if (result == SOCKET_ERROR)
+	{
+		int errorCode = ::WSAGetLastError();
+		if (errorCode != WSA_IO_PENDING)
+		{
+			// Failed synchronously.
+			operation.m_errorCode = static_cast<DWORD>(errorCode);
+			operation.m_numberOfBytesTransferred = numberOfBytesSent;
+			return false;
+		}
+	}
+	else if (skipCompletionOnSuccess)
+	{
+		// Completed synchronously, no completion event will be posted to the IOCP.
+		operation.m_errorCode = ERROR_SUCCESS;
+		operation.m_numberOfBytesTransferred = numberOfBytesSent;
+		return false;
+	}
+
+	// Operation will complete asynchronously.
+	return true;
+}
+
+void cppcoro::net::socket_send_buffers_operation_impl::cancel(
+	cppcoro::detail::win32_overlapped_operation_base& operation) noexcept
+{
+	(void)::CancelIoEx(
+		reinterpret_cast<HANDLE>(m_socket.native_handle()),
+		operation.get_overlapped());
+}
+
+#endif
+
+#if CPPCORO_OS_LINUX
+# include "spin_wait.hpp"
+
+# include <cerrno>
+# include <new>
+
+# include <sys/socket.h>
+
+namespace
+{
+	namespace local
+	{
+		// Linux transfers at most this many bytes in a single call.
+		constexpr std::size_t max_transfer_size = 0x7FFFF000;
+	}
+}
+
+bool cppcoro::net::socket_send_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	auto& state = operation.get_io_state();
+	state.m_opcode = cppcoro::detail::lnx::io_opcode::send;
+	state.m_fd = m_socket.native_handle();
+	// Fail with EPIPE rather than raising SIGPIPE if the connection is closed.
+	state.m_flags = MSG_NOSIGNAL;
+	state.m_buffer = const_cast<void*>(m_buffer);
+	state.m_length = m_byteCount <= local::max_transfer_size ?
+		m_byteCount : local::max_transfer_size;
+	return operation.try_start_io();
+}
+
+void cppcoro::net::socket_send_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+bool cppcoro::net::socket_send_buffers_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	if (m_sendAll)
+	{
+		// The number of bytes sent must fit in the result, so rather than
+		// sending only some of the data, refuse to send any of it.
+		std::size_t totalSize = 0;
+		for (const auto& buffer : m_buffers)
+		{
+			if (buffer.size() > local::max_transfer_size - totalSize)
+			{
+				operation.m_result = -EMSGSIZE;
+				return false;
+			}
+
+			totalSize += buffer.size();
+		}
+	}
+
+	prepare_message();
+	auto* message = reinterpret_cast<msghdr*>(&m_messageStorage);
+
+	if (!m_sendAll)
+	{
+		auto& state = operation.get_io_state();
+		state.m_opcode = cppcoro::detail::lnx::io_opcode::sendmsg;
+		state.m_fd = m_socket.native_handle();
+		// Fail with EPIPE rather than raising SIGPIPE if the connection is closed.
+		state.m_flags = MSG_NOSIGNAL;
+		state.m_buffer = message;
+		return operation.try_start_io();
+	}
+
+	m_operation = &operation;
+	m_sendAllState.m_impl = this;
+	m_sendAllState.m_callback = &socket_send_buffers_operation_impl::on_send_all_completed;
+	m_sendAllState.m_opcode = cppcoro::detail::lnx::io_opcode::sendmsg;
+	m_sendAllState.m_fd = m_socket.native_handle();
+	// MSG_WAITALL has io_uring retry partial sends itself (Linux 5.18+).
+	// Other partial sends are continued by on_send_all_completed().
+	m_sendAllState.m_flags = MSG_NOSIGNAL | MSG_WAITALL;
+	m_sendAllState.m_buffer = message;
+
+	// The completion may be delivered on another thread as soon as the send
+	// has been started, so hold the lock to stop it from being forwarded to
+	// the operation before we have returned.
+	lock();
+
+	std::int32_t& result = operation.m_result;
+	do
+	{
+		if (operation.m_ioService.try_start_io(m_sendAllState, result))
+		{
+			unlock();
+			return true;
+		}
+	} while (try_advance(result));
+
+	unlock();
+	return false;
+}
+
+void cppcoro::net::socket_send_buffers_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	if (!m_sendAll)
+	{
+		operation.cancel_io();
+		return;
+	}
+
+	lock();
+	m_isCancellationRequested = true;
+	operation.m_ioService.cancel_io(m_sendAllState);
+	unlock();
+}
+
+void cppcoro::net::socket_send_buffers_operation_impl::on_send_all_completed(
+	cppcoro::detail::lnx::io_state* ioState,
+	std::int32_t result,
+	std::uint32_t flags) noexcept
+{
+	auto& impl = *static_cast<send_all_state*>(ioState)->m_impl;
+
+	impl.lock();
+
+	while (impl.try_advance(result))
+	{
+		if (impl.m_isCancellationRequested)
+		{
+			result = -ECANCELED;
+			break;
+		}
+
+		if (impl.m_operation->m_ioService.try_start_io(impl.m_sendAllState, result))
+		{
+			impl.unlock();
+			return;
+		}
+	}
+
+	auto& operationState = impl.m_operation->get_io_state();
+
+	impl.unlock();
+
+	operationState.m_callback(&operationState, result, flags);
+}
+
+bool cppcoro::net::socket_send_buffers_operation_impl::try_advance(
+	std::int32_t& result) noexcept
+{
+	if (result <= 0)
+	{
+		// Report the failure, even if some of the data has been sent, as
+		// the stream is no longer usable. A stream socket only sends zero
+		// bytes if it was asked to.
+		if (result == 0)
+		{
+			result = static_cast<std::int32_t>(m_bytesSent);
+		}
+		return false;
+	}
+
+	m_bytesSent += static_cast<std::size_t>(result);
+
+	auto* message = reinterpret_cast<msghdr*>(&m_messageStorage);
+	std::size_t bytesSent = static_cast<std::size_t>(result);
+	while (message->msg_iovlen > 0 && bytesSent >= message->msg_iov->iov_len)
+	{
+		bytesSent -= message->msg_iov->iov_len;
+		++message->msg_iov;
+		--message->msg_iovlen;
+	}
+
+	if (message->msg_iovlen == 0)
+	{
+		if (m_nextBuffer == m_buffers.size())
+		{
+			result = static_cast<std::int32_t>(m_bytesSent);
+			return false;
+		}
+
+		prepare_message();
+		return true;
+	}
+
+	message->msg_iov->iov_base = static_cast<std::uint8_t*>(message->msg_iov->iov_base) + bytesSent;
+	message->msg_iov->iov_len -= bytesSent;
+	return true;
+}
+
+void cppcoro::net::socket_send_buffers_operation_impl::prepare_message() noexcept
+{
+	static_assert(sizeof(m_messageStorage) >= sizeof(msghdr));
+
+	// Limit the total so that the number of bytes sent fits in the result.
+	std::size_t remaining = local::max_transfer_size;
+	std::size_t bufferCount = 0;
+	while (m_nextBuffer < m_buffers.size() &&
+		bufferCount < max_buffer_count &&
+		remaining > 0)
+	{
+		const auto& buffer = m_buffers[m_nextBuffer++];
+
+		// Skip empty buffers, so that a send_all() doesn't make a sendmsg of
+		// zero bytes, which would look like the end of the data to send.
+		if (buffer.size() == 0)
+		{
+			continue;
+		}
+
+		const std::size_t size = buffer.size() <= remaining ? buffer.size() : remaining;
+		m_iovecs[bufferCount].iov_base = const_cast<void*>(buffer.data());
+		m_iovecs[bufferCount].iov_len = size;
+		++bufferCount;
+
+		remaining -= size;
+	}
+
+	auto* message = new (&m_messageStorage) msghdr{};
+	message->msg_iov = m_iovecs;
+	message->msg_iovlen = bufferCount;
+}
+
+void cppcoro::net::socket_send_buffers_operation_impl::lock() noexcept
+{
+	spin_wait wait;
+	while (m_isLocked.exchange(true, std::memory_order_acquire))
+	{
+		while (m_isLocked.load(std::memory_order_relaxed))
+		{
+			wait.spin_one();
+		}
+	}
+}
+
+void cppcoro::net::socket_send_buffers_operation_impl::unlock() noexcept
+{
+	m_isLocked.store(false, std::memory_order_release);
+}
+
 #endif
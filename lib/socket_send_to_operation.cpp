@@ -70,3 +70,125 @@ void cppcoro::net::socket_send_to_operation_impl::cancel(
 }
 
 #endif
+
+#if CPPCORO_OS_LINUX
+# include "socket_helpers.hpp"
+
+# include <cstring>
+# include <new>
+
+# include <netinet/in.h>
+# include <netinet/udp.h>
+# include <sys/socket.h>
+
+namespace
+{
+	namespace local
+	{
+		// Linux transfers at most this many bytes in a single call.
+		constexpr std::size_t max_transfer_size = 0x7FFFF000;
+	}
+}
+
+bool cppcoro::net::socket_send_to_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	if (m_buffer.iov_len > local::max_transfer_size)
+	{
+		m_buffer.iov_len = local::max_transfer_size;
+	}
+
+	static_assert(
+		sizeof(m_destinationSockaddrStorage) >= sizeof(sockaddr_in) &&
+		sizeof(m_destinationSockaddrStorage) >= sizeof(sockaddr_in6));
+	static_assert(sizeof(m_messageStorage) >= sizeof(msghdr));
+
+	sockaddr_storage destinationAddress;
+	const int destinationLength = detail::ip_endpoint_to_sockaddr(
+		m_destination, std::ref(destinationAddress));
+	std::memcpy(&m_destinationSockaddrStorage, &destinationAddress, destinationLength);
+
+	auto* message = new (&m_messageStorage) msghdr{};
+	message->msg_name = &m_destinationSockaddrStorage;
+	message->msg_namelen = static_cast<socklen_t>(destinationLength);
+	message->msg_iov = &m_buffer;
+	message->msg_iovlen = 1;
+
+	if (m_segmentSize != 0)
+	{
+		static_assert(sizeof(m_controlStorage) >= CMSG_SPACE(sizeof(std::uint16_t)));
+
+		std::memset(&m_controlStorage, 0, sizeof(m_controlStorage));
+		message->msg_control = &m_controlStorage;
+		message->msg_controllen = CMSG_SPACE(sizeof(std::uint16_t));
+
+		auto* control = CMSG_FIRSTHDR(message);
+		control->cmsg_level = IPPROTO_UDP;
+		control->cmsg_type = UDP_SEGMENT;
+		control->cmsg_len = CMSG_LEN(sizeof(std::uint16_t));
+		std::memcpy(CMSG_DATA(control), &m_segmentSize, sizeof(std::uint16_t));
+	}
+
+	auto& state = operation.get_io_state();
+	state.m_opcode = cppcoro::detail::lnx::io_opcode::sendmsg;
+	state.m_fd = m_socket.native_handle();
+	state.m_flags = MSG_NOSIGNAL;
+	state.m_buffer = message;
+	return operation.try_start_io();
+}
+
+void cppcoro::net::socket_send_to_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+bool cppcoro::net::socket_send_to_batch_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	static_assert(
+		sizeof(m_destinationSockaddrStorage[0]) >= sizeof(sockaddr_in) &&
+		sizeof(m_destinationSockaddrStorage[0]) >= sizeof(sockaddr_in6));
+	static_assert(sizeof(m_messageStorage[0]) == sizeof(mmsghdr));
+
+	if (m_datagrams.empty())
+	{
+		operation.m_result = 0;
+		return false;
+	}
+
+	auto* messages = reinterpret_cast<mmsghdr*>(&m_messageStorage);
+	for (std::size_t i = 0; i < m_datagrams.size(); ++i)
+	{
+		m_buffers[i].iov_base = m_datagrams[i].buffer;
+		m_buffers[i].iov_len = m_datagrams[i].size <= local::max_transfer_size ?
+			m_datagrams[i].size : local::max_transfer_size;
+
+		sockaddr_storage destinationAddress;
+		const int destinationLength = detail::ip_endpoint_to_sockaddr(
+			m_datagrams[i].endpoint, std::ref(destinationAddress));
+		std::memcpy(&m_destinationSockaddrStorage[i], &destinationAddress, destinationLength);
+
+		auto* message = new (&m_messageStorage[i]) mmsghdr{};
+		message->msg_hdr.msg_name = &m_destinationSockaddrStorage[i];
+		message->msg_hdr.msg_namelen = static_cast<socklen_t>(destinationLength);
+		message->msg_hdr.msg_iov = &m_buffers[i];
+		message->msg_hdr.msg_iovlen = 1;
+	}
+
+	auto& state = operation.get_io_state();
+	state.m_opcode = cppcoro::detail::lnx::io_opcode::sendmmsg;
+	state.m_fd = m_socket.native_handle();
+	state.m_flags = MSG_NOSIGNAL;
+	state.m_buffer = messages;
+	state.m_length = m_datagrams.size();
+	return operation.try_start_io();
+}
+
+void cppcoro::net::socket_send_to_batch_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	operation.cancel_io();
+}
+
+#endif
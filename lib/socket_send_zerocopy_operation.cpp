@@ -0,0 +1,306 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cppcoro/net/socket_send_zerocopy_operation.hpp>
+#include <cppcoro/net/socket.hpp>
+
+#if CPPCORO_OS_LINUX
+# include "spin_mutex.hpp"
+
+# include <atomic>
+# include <cerrno>
+# include <mutex>
+# include <new>
+# include <system_error>
+
+# include <linux/io_uring.h>
+# include <sys/socket.h>
+
+namespace
+{
+	namespace local
+	{
+		// Linux transfers at most this many bytes in a single call.
+		constexpr std::size_t max_transfer_size = 0x7FFFF000;
+	}
+}
+
+namespace cppcoro::net
+{
+	/// \brief
+	/// The io_state of a zero-copy send.
+	///
+	/// The kernel may hold on to the buffer for some time after the send
+	/// operation has completed, so this is allocated separately from the
+	/// operation and reference counted so that it stays alive until the
+	/// kernel has finished with the buffer.
+	///
+	/// The send operation's completion is forwarded to the operation.
+	class zerocopy_send_state final
+		: private cppcoro::detail::lnx::io_state
+	{
+	public:
+
+		zerocopy_send_state(
+			io_service& ioService,
+			cppcoro::detail::lnx::io_state& operation) noexcept
+			: cppcoro::detail::lnx::io_state(&zerocopy_send_state::on_operation_completed)
+			, m_ioService(ioService)
+			, m_operation(&operation)
+			, m_refCount(1)
+			, m_isBufferReleased(false)
+		{}
+
+		/// Start sending \p byteCount bytes from \p buffer on the socket.
+		///
+		/// \return
+		/// false if the send completed synchronously, in which case \p result
+		/// holds its result and the buffer has been released.
+		bool try_start(
+			cppcoro::detail::lnx::fd_t fd,
+			const void* buffer,
+			std::size_t byteCount,
+			std::int32_t& result) noexcept;
+
+		void cancel() noexcept
+		{
+			m_ioService.cancel_io(*this);
+		}
+
+		void release_ref() noexcept
+		{
+			if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				delete this;
+			}
+		}
+
+		bool is_buffer_released() noexcept
+		{
+			std::lock_guard lock{ m_mutex };
+			return m_isBufferReleased;
+		}
+
+		/// Arrange for \p awaitingCoroutine to be resumed once the buffer has
+		/// been released.
+		///
+		/// \return
+		/// false if the buffer has already been released.
+		bool try_await_buffer_released(std::coroutine_handle<> awaitingCoroutine) noexcept
+		{
+			std::lock_guard lock{ m_mutex };
+			if (m_isBufferReleased)
+			{
+				return false;
+			}
+
+			m_awaitingCoroutine = awaitingCoroutine;
+			return true;
+		}
+
+	private:
+
+		void set_buffer_released() noexcept;
+
+		static void on_operation_completed(
+			cppcoro::detail::lnx::io_state* ioState,
+			std::int32_t result,
+			std::uint32_t flags) noexcept;
+
+		io_service& m_ioService;
+
+		// The send operation, until it has completed.
+		cppcoro::detail::lnx::io_state* m_operation;
+
+		// The reference held by the operation, and then by its result, plus
+		// one while any callbacks are pending.
+		std::atomic<std::uint32_t> m_refCount;
+
+		// Protects the remaining members.
+		spin_mutex m_mutex;
+
+		bool m_isBufferReleased;
+
+		std::coroutine_handle<> m_awaitingCoroutine;
+
+	};
+}
+
+bool cppcoro::net::zerocopy_send_state::try_start(
+	cppcoro::detail::lnx::fd_t fd,
+	const void* buffer,
+	std::size_t byteCount,
+	std::int32_t& result) noexcept
+{
+	m_opcode = cppcoro::detail::lnx::io_opcode::send_zerocopy;
+	m_fd = fd;
+	// Fail with EPIPE rather than raising SIGPIPE if the connection is closed.
+	m_flags = MSG_NOSIGNAL;
+	m_buffer = const_cast<void*>(buffer);
+	m_length = byteCount <= local::max_transfer_size ?
+		byteCount : local::max_transfer_size;
+
+	// Account for the final completion while the operation's reference is
+	// known to be held. See io_state::m_pendingCallbacks.
+	m_pendingCallbacks = 1;
+	m_refCount.fetch_add(1, std::memory_order_relaxed);
+
+	if (!m_ioService.try_start_io(*this, result))
+	{
+		m_pendingCallbacks = 0;
+		m_refCount.fetch_sub(1, std::memory_order_relaxed);
+		m_operation = nullptr;
+		m_isBufferReleased = true;
+		return false;
+	}
+
+	return true;
+}
+
+void cppcoro::net::zerocopy_send_state::set_buffer_released() noexcept
+{
+	std::coroutine_handle<> awaitingCoroutine;
+
+	{
+		std::lock_guard lock{ m_mutex };
+		m_isBufferReleased = true;
+		awaitingCoroutine = std::exchange(m_awaitingCoroutine, nullptr);
+	}
+
+	if (awaitingCoroutine)
+	{
+		awaitingCoroutine.resume();
+	}
+}
+
+void cppcoro::net::zerocopy_send_state::on_operation_completed(
+	cppcoro::detail::lnx::io_state* ioState,
+	std::int32_t result,
+	std::uint32_t flags) noexcept
+{
+	auto* state = static_cast<zerocopy_send_state*>(ioState);
+
+	if ((flags & IORING_CQE_F_NOTIF) != 0)
+	{
+		state->set_buffer_released();
+	}
+	else
+	{
+		if ((result == -EINVAL || result == -EOPNOTSUPP) &&
+			(flags & IORING_CQE_F_MORE) == 0 &&
+			state->m_opcode == cppcoro::detail::lnx::io_opcode::send_zerocopy)
+		{
+			// Kernels before 6.0 don't support zero-copy sends with io_uring
+			// and not all sockets support them. Fall back to a copying send.
+			state->m_opcode = cppcoro::detail::lnx::io_opcode::send;
+			if (state->m_ioService.try_start_io(*state, result))
+			{
+				// Its completion is still to come.
+				return;
+			}
+		}
+
+		if ((flags & IORING_CQE_F_MORE) == 0)
+		{
+			// The data was copied, or not sent at all.
+			state->set_buffer_released();
+		}
+
+		auto* operation = std::exchange(state->m_operation, nullptr);
+		operation->m_callback(operation, result, flags);
+	}
+
+	if (__atomic_sub_fetch(&state->m_pendingCallbacks, 1, __ATOMIC_ACQ_REL) == 0)
+	{
+		state->release_ref();
+	}
+}
+
+cppcoro::net::zerocopy_send&
+cppcoro::net::zerocopy_send::operator=(zerocopy_send&& other) noexcept
+{
+	if (this != &other)
+	{
+		if (m_state != nullptr)
+		{
+			m_state->release_ref();
+		}
+
+		m_state = std::exchange(other.m_state, nullptr);
+		m_bytesSent = other.m_bytesSent;
+	}
+
+	return *this;
+}
+
+cppcoro::net::zerocopy_send::~zerocopy_send()
+{
+	if (m_state != nullptr)
+	{
+		m_state->release_ref();
+	}
+}
+
+bool cppcoro::net::zerocopy_send::is_buffer_released() const noexcept
+{
+	return m_state == nullptr || m_state->is_buffer_released();
+}
+
+cppcoro::net::zerocopy_send::buffer_released_operation
+cppcoro::net::zerocopy_send::buffer_released() noexcept
+{
+	return buffer_released_operation{ m_state };
+}
+
+bool cppcoro::net::zerocopy_send::buffer_released_operation::await_ready() const noexcept
+{
+	return m_state == nullptr || m_state->is_buffer_released();
+}
+
+bool cppcoro::net::zerocopy_send::buffer_released_operation::await_suspend(
+	std::coroutine_handle<> awaitingCoroutine) noexcept
+{
+	return m_state->try_await_buffer_released(awaitingCoroutine);
+}
+
+cppcoro::net::socket_send_zerocopy_operation_impl::~socket_send_zerocopy_operation_impl()
+{
+	if (m_state != nullptr)
+	{
+		m_state->release_ref();
+	}
+}
+
+bool cppcoro::net::socket_send_zerocopy_operation_impl::try_start(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	m_state = new (std::nothrow) zerocopy_send_state(
+		operation.m_ioService, operation.get_io_state());
+	if (m_state == nullptr)
+	{
+		operation.m_result = -ENOMEM;
+		return false;
+	}
+
+	return m_state->try_start(
+		m_socket.native_handle(), m_buffer, m_byteCount, operation.m_result);
+}
+
+void cppcoro::net::socket_send_zerocopy_operation_impl::cancel(
+	cppcoro::detail::linux_async_operation_base& operation) noexcept
+{
+	(void)operation;
+	m_state->cancel();
+}
+
+cppcoro::net::zerocopy_send
+cppcoro::net::socket_send_zerocopy_operation_impl::get_result(
+	cppcoro::detail::linux_async_operation_base& operation)
+{
+	const std::size_t bytesSent = operation.get_result();
+	return zerocopy_send{ std::exchange(m_state, nullptr), bytesSent };
+}
+
+#endif
@@ -18,6 +18,19 @@ namespace
 	namespace local
 	{
 		constexpr std::uint32_t yield_threshold = 10;
+
+#if !CPPCORO_OS_WINNT
+		/// Hint to the CPU that we are busy-waiting so that it can let other
+		/// hyper-threads run and save power.
+		inline void cpu_pause() noexcept
+		{
+# if defined(__i386__) || defined(__x86_64__)
+			__builtin_ia32_pause();
+# elif defined(__aarch64__) || defined(__arm__)
+			asm volatile("yield");
+# endif
+		}
+#endif
 	}
 }
 
@@ -83,7 +96,17 @@ namespace cppcoro
 			}
 		}
 #else
-		if (next_spin_will_yield())
+		if (!next_spin_will_yield())
+		{
+			// Same strategy as above. Make each busy-spin exponentially longer.
+			const std::uint32_t loopCount = 2u << m_count;
+			for (std::uint32_t i = 0; i < loopCount; ++i)
+			{
+				local::cpu_pause();
+				local::cpu_pause();
+			}
+		}
+		else
 		{
 			std::this_thread::yield();
 		}
@@ -4,6 +4,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <cppcoro/static_thread_pool.hpp>
+#include <cppcoro/config.hpp>
 
 #include "auto_reset_event.hpp"
 #include "spin_mutex.hpp"
@@ -12,6 +13,9 @@
 #include <cassert>
 #include <mutex>
 #include <chrono>
+#include <limits>
+#include <new>
+#include <utility>
 
 namespace
 {
@@ -20,6 +24,23 @@ namespace
 		// Keep each thread's local queue under 1MB
 		constexpr std::size_t max_local_queue_size = 1024 * 1024 / sizeof(void*);
 		constexpr std::size_t initial_local_queue_size = 256;
+
+		// The most operations stolen from another thread's local queue at once.
+		constexpr std::size_t max_steal_count = 64;
+
+		// The most operations run in a row from a thread's run-next slot
+		// before the thread yields to the rest of its queued work.
+		constexpr std::uint32_t max_run_next_count = 16;
+
+		// Spreads threads that schedule work onto the pool from outside
+		// across the pool's global queues.
+		std::uint32_t producer_index() noexcept
+		{
+			static std::atomic<std::uint32_t> nextIndex{ 0 };
+			thread_local const std::uint32_t index =
+				nextIndex.fetch_add(1, std::memory_order_relaxed);
+			return index;
+		}
 	}
 }
 
@@ -28,6 +49,79 @@ namespace cppcoro
 	thread_local static_thread_pool::thread_state* static_thread_pool::s_currentState = nullptr;
 	thread_local static_thread_pool* static_thread_pool::s_currentThreadPool = nullptr;
 
+	/// A lock-free, unbounded queue of operations, used for the global queues
+	/// and for each thread's overflow queue.
+	///
+	/// Any number of threads may push operations concurrently. Consumers
+	/// take all of the queued operations with a single exchange, so they
+	/// never contend with each other on a lock and there is no ABA hazard.
+	class static_thread_pool::lock_free_queue
+	{
+	public:
+
+		lock_free_queue() noexcept
+			: m_top(nullptr)
+		{}
+
+		void push(schedule_operation* operation) noexcept
+		{
+			auto* top = m_top.load(std::memory_order_relaxed);
+			do
+			{
+				operation->m_next = top;
+			} while (!m_top.compare_exchange_weak(
+				top,
+				operation,
+				std::memory_order_seq_cst,
+				std::memory_order_relaxed));
+		}
+
+		/// Take all of the queued operations.
+		///
+		/// \return
+		/// The queued operations linked by m_next, most recently pushed first,
+		/// or nullptr if the queue was empty.
+		schedule_operation* try_pop_all() noexcept
+		{
+			// Use seq-cst memory order so that when we check for an item in the
+			// queue after signalling an intent to sleep that either we will see
+			// their enqueue or they will see our signal to sleep and wake us up.
+			if (m_top.load(std::memory_order_seq_cst) == nullptr)
+			{
+				return nullptr;
+			}
+
+			return m_top.exchange(nullptr, std::memory_order_acquire);
+		}
+
+		bool approx_has_any_queued_work() const noexcept
+		{
+			return m_top.load(std::memory_order_relaxed) != nullptr;
+		}
+
+		bool has_any_queued_work() const noexcept
+		{
+			return m_top.load(std::memory_order_seq_cst) != nullptr;
+		}
+
+	private:
+
+#if CPPCORO_COMPILER_MSVC
+# pragma warning(push)
+# pragma warning(disable : 4324)
+#endif
+
+		// Keep each queue on its own cache-line as they are written by
+		// different threads.
+		alignas(CPPCORO_CPU_CACHE_LINE)
+		std::atomic<schedule_operation*> m_top;
+
+#if CPPCORO_COMPILER_MSVC
+# pragma warning(pop)
+#endif
+
+	};
+
 	class static_thread_pool::thread_state
 	{
 	public:
@@ -40,6 +134,11 @@ namespace cppcoro
 			, m_head(0)
 			, m_tail(0)
 			, m_isSleeping(false)
+			, m_runNext(nullptr)
+			, m_runNextCount(0)
+			, m_dispatchCount(0)
+			, m_runNextSeenDispatchCount(std::numeric_limits<std::uint64_t>::max())
+			, m_randomState(static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(this) >> 4) | 1)
 		{
 		}
 
@@ -84,13 +183,22 @@ namespace cppcoro
 
 		bool approx_has_any_queued_work() const noexcept
 		{
+			// The run-next slot is deliberately ignored here so that spinning
+			// threads don't steal an operation that this thread is about to run.
 			return difference(
 				m_head.load(std::memory_order_relaxed),
-				m_tail.load(std::memory_order_relaxed)) > 0;
+				m_tail.load(std::memory_order_relaxed)) > 0 ||
+				m_overflowQueue.approx_has_any_queued_work();
 		}
 
 		bool has_any_queued_work() noexcept
 		{
+			if (m_runNext.load(std::memory_order_seq_cst) != nullptr ||
+				m_overflowQueue.has_any_queued_work())
+			{
+				return true;
+			}
+
 			std::scoped_lock lock{ m_remoteMutex };
 			auto tail = m_tail.load(std::memory_order_relaxed);
 			auto head = m_head.load(std::memory_order_seq_cst);
@@ -127,7 +235,7 @@ namespace cppcoro
 				return true;
 			}
 
-			if (m_mask == local::max_local_queue_size)
+			if (m_mask + 1 >= local::max_local_queue_size)
 			{
 				// No space in the buffer and we don't want to grow
 				// it any further.
@@ -150,8 +258,7 @@ namespace cppcoro
 			if (!m_remoteMutex.try_lock())
 			{
 				// Don't wait to acquire the lock if we can't get it immediately.
-				// Fail and let it be enqueued to the global queue.
-				// TODO: Should we have a per-thread overflow queue instead?
+				// Fail and let it be enqueued to the overflow queue.
 				return false;
 			}
 
@@ -178,6 +285,147 @@ namespace cppcoro
 			return true;
 		}
 
+		/// Enqueue an operation to this thread's local queue, or to its
+		/// overflow queue if the local queue is full.
+		///
+		/// Must only be called by the thread that owns this state.
+		void local_enqueue(schedule_operation* operation) noexcept
+		{
+			if (!try_local_enqueue(operation))
+			{
+				m_overflowQueue.push(operation);
+			}
+		}
+
+		/// Make \p operation the next one to be run by this thread, ahead of
+		/// its local queue. Any operation already in the run-next slot is
+		/// moved to the local queue.
+		///
+		/// Must only be called by the thread that owns this state.
+		///
+		/// \return
+		/// true if an operation was moved to the local queue, where another
+		/// thread should be woken up to steal it.
+		bool set_run_next(schedule_operation* operation) noexcept
+		{
+			auto* previous = m_runNext.exchange(operation, std::memory_order_seq_cst);
+			if (previous == nullptr)
+			{
+				return false;
+			}
+
+			local_enqueue(previous);
+			return true;
+		}
+
+		/// Take the operation in the run-next slot.
+		///
+		/// Must only be called by the thread that owns this state.
+		///
+		/// \param yieldQueue
+		/// Once max_run_next_count operations in a row have been run from the
+		/// slot, the operation in it is pushed to this queue instead, so that
+		/// operations that keep scheduling each other can't starve the rest
+		/// of the thread's queued work.
+		///
+		/// \return
+		/// The operation to run, or nullptr if the slot was empty or the
+		/// operation was yielded.
+		schedule_operation* try_run_next_pop(lock_free_queue& yieldQueue) noexcept
+		{
+			// This is called each time we go back to looking for an operation
+			// to run. See try_steal_run_next().
+			m_dispatchCount.store(
+				m_dispatchCount.load(std::memory_order_relaxed) + 1,
+				std::memory_order_relaxed);
+
+			schedule_operation* op = nullptr;
+			if (m_runNext.load(std::memory_order_relaxed) != nullptr)
+			{
+				// Use exchange as another thread may be stealing it.
+				op = m_runNext.exchange(nullptr, std::memory_order_acquire);
+			}
+
+			if (op == nullptr)
+			{
+				m_runNextCount = 0;
+				return nullptr;
+			}
+
+			if (++m_runNextCount > local::max_run_next_count)
+			{
+				m_runNextCount = 0;
+				yieldQueue.push(op);
+				return nullptr;
+			}
+
+			return op;
+		}
+
+		/// Steal the operation in this thread's run-next slot.
+		///
+		/// This is a last resort for when this thread is busy running
+		/// something else for a long time, eg. the operation that scheduled
+		/// it did not suspend straight away. So the operation is only stolen
+		/// if a previous attempt already saw it, and this thread has not gone
+		/// back to look for an operation to run since. Otherwise this thread
+		/// is likely to be about to run it itself.
+		schedule_operation* try_steal_run_next() noexcept
+		{
+			if (m_runNext.load(std::memory_order_relaxed) == nullptr)
+			{
+				return nullptr;
+			}
+
+			const auto dispatchCount = m_dispatchCount.load(std::memory_order_relaxed);
+			if (m_runNextSeenDispatchCount.exchange(
+					dispatchCount, std::memory_order_relaxed) != dispatchCount)
+			{
+				return nullptr;
+			}
+
+			return m_runNext.exchange(nullptr, std::memory_order_acquire);
+		}
+
+		/// Take all of the operations from \p queue.
+		///
+		/// Must only be called by the thread that owns this state.
+		///
+		/// \return
+		/// The oldest operation, to be run next, or nullptr if \p queue was
+		/// empty. The others are enqueued to this thread's local queue, in
+		/// the order they were queued, where other threads can steal them.
+		schedule_operation* try_dequeue_all_from(lock_free_queue& queue) noexcept
+		{
+			auto* op = queue.try_pop_all();
+			if (op != nullptr)
+			{
+				// The operations are listed most recently queued first, and
+				// the local queue is popped most recently enqueued first.
+				while (op->m_next != nullptr)
+				{
+					local_enqueue(std::exchange(op, op->m_next));
+				}
+			}
+
+			return op;
+		}
+
+		/// Take the operations that overflowed the local queue.
+		///
+		/// Must only be called by the thread that owns this state.
+		schedule_operation* try_overflow_dequeue() noexcept
+		{
+			return try_dequeue_all_from(m_overflowQueue);
+		}
+
+		/// Steal all of the operations that overflowed this thread's local
+		/// queue, enqueueing them to \p thief's local queue.
+		schedule_operation* try_steal_overflow(thread_state& thief) noexcept
+		{
+			return thief.try_dequeue_all_from(m_overflowQueue);
+		}
+
 		schedule_operation* try_local_pop() noexcept
 		{
 			// Cheap, approximate, no memory-barrier check for emptiness
@@ -233,54 +481,117 @@ namespace cppcoro
 			return m_localQueue[newHead & m_mask].load(std::memory_order_relaxed);
 		}
 
-		schedule_operation* try_steal(bool* lockUnavailable = nullptr) noexcept
+		/// Steal up to half of the operations in this thread's local queue.
+		///
+		/// \param thief
+		/// The state of the calling thread. All but one of the stolen
+		/// operations are enqueued to its local queue.
+		///
+		/// \param lockUnavailable
+		/// If non-null then don't wait for the lock if it can't be acquired
+		/// immediately, instead setting *lockUnavailable to true.
+		///
+		/// \return
+		/// The oldest of the stolen operations, to be run next, or nullptr if
+		/// there were none to steal.
+		schedule_operation* try_steal(
+			thread_state& thief,
+			bool* lockUnavailable = nullptr) noexcept
 		{
-			if (lockUnavailable == nullptr)
+			schedule_operation* stolen[local::max_steal_count];
+			std::size_t stolenCount = 0;
+
 			{
-				m_remoteMutex.lock();
+				if (lockUnavailable == nullptr)
+				{
+					m_remoteMutex.lock();
+				}
+				else if (!m_remoteMutex.try_lock())
+				{
+					*lockUnavailable = true;
+					return nullptr;
+				}
+
+				std::scoped_lock lock{ std::adopt_lock, m_remoteMutex };
+
+				auto tail = m_tail.load(std::memory_order_relaxed);
+				auto head = m_head.load(std::memory_order_seq_cst);
+				const offset_t available = difference(head, tail);
+				if (available <= 0)
+				{
+					return nullptr;
+				}
+
+				// Round up so that a single item can still be stolen.
+				std::size_t stealCount = (static_cast<std::size_t>(available) + 1) / 2;
+				if (stealCount > local::max_steal_count)
+				{
+					stealCount = local::max_steal_count;
+				}
+
+				while (stolenCount < stealCount)
+				{
+					// It looks like there are items in the queue.
+					// We'll speculatively try to steal one by incrementing
+					// the tail cursor. As this may be running concurrently
+					// with try_local_pop() which is also speculatively trying
+					// to remove an item from the other end of the queue we
+					// need to re-read  the 'head' cursor afterwards to see
+					// if there was a potential race to dequeue the last item.
+					// Use seq_cst memory order both here and in try_local_pop()
+					// to ensure that either we will see their write to head or
+					// they will see our write to tail or we will both see each
+					// other's writes.
+					//
+					// Items are stolen one at a time, rather than by advancing
+					// the tail cursor by the whole batch at once, as the owning
+					// thread may otherwise reuse the slots of the batch before
+					// we have read them.
+					m_tail.store(tail + 1, std::memory_order_seq_cst);
+					head = m_head.load(std::memory_order_seq_cst);
+
+					if (difference(head, tail) <= 0)
+					{
+						// We failed to steal the last item.
+						// Restore the old tail position.
+						m_tail.store(tail, std::memory_order_seq_cst);
+						break;
+					}
+
+					// There was still an item in the queue after incrementing tail.
+					// We managed to steal an item from the bottom of the stack.
+					stolen[stolenCount++] = m_localQueue[tail & m_mask].load(std::memory_order_relaxed);
+					++tail;
+				}
 			}
-			else if (!m_remoteMutex.try_lock())
+
+			if (stolenCount == 0)
 			{
-				*lockUnavailable = true;
 				return nullptr;
 			}
 
-			std::scoped_lock lock{ std::adopt_lock, m_remoteMutex };
-
-			auto tail = m_tail.load(std::memory_order_relaxed);
-			auto head = m_head.load(std::memory_order_seq_cst);
-			if (difference(head, tail) <= 0)
+			// Enqueue the newest first so that the thief runs them in the
+			// order that they were queued.
+			for (std::size_t i = stolenCount - 1; i > 0; --i)
 			{
-				return nullptr;
+				thief.local_enqueue(stolen[i]);
 			}
 
-			// It looks like there are items in the queue.
-			// We'll speculatively try to steal one by incrementing
-			// the tail cursor. As this may be running concurrently
-			// with try_local_pop() which is also speculatively trying
-			// to remove an item from the other end of the queue we
-			// need to re-read  the 'head' cursor afterwards to see
-			// if there was a potential race to dequeue the last item.
-			// Use seq_cst memory order both here and in try_local_pop()
-			// to ensure that either we will see their write to head or
-			// they will see our write to tail or we will both see each
-			// other's writes.
-			m_tail.store(tail + 1, std::memory_order_seq_cst);
-			head = m_head.load(std::memory_order_seq_cst);
+			return stolen[0];
+		}
 
-			if (difference(head, tail) > 0)
-			{
-				// There was still an item in the queue after incrementing tail.
-				// We managed to steal an item from the bottom of the stack.
-				return m_localQueue[tail & m_mask].load(std::memory_order_relaxed);
-			}
-			else
-			{
-				// Otherwise we failed to steal the last item.
-				// Restore the old tail position.
-				m_tail.store(tail, std::memory_order_seq_cst);
-				return nullptr;
-			}
+		/// A cheap pseudo-random number used to pick threads to steal from.
+		///
+		/// Must only be called by the thread that owns this state.
+		std::uint32_t next_random() noexcept
+		{
+			// xorshift32
+			auto x = m_randomState;
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			m_randomState = x;
+			return x;
 		}
 
 	private:
@@ -316,6 +627,32 @@ namespace cppcoro
 
 		auto_reset_event m_wakeUpEvent;
 
+		// Operations that didn't fit in the local queue. These are run by
+		// this thread before it looks for work elsewhere, so that a burst
+		// of operations stays on the thread that scheduled them, but may
+		// also be stolen by other threads.
+		lock_free_queue m_overflowQueue;
+
+		// The operation most recently scheduled by this thread, which it runs
+		// next. This is usually the continuation of the operation it is
+		// running, so running it straight away, rather than letting it be
+		// stolen, keeps data that the two operations share in this thread's
+		// cache.
+		std::atomic<schedule_operation*> m_runNext;
+
+		// Number of operations run in a row from m_runNext.
+		std::uint32_t m_runNextCount;
+
+		// Number of times this thread has looked for an operation to run.
+		// Only written by this thread.
+		std::atomic<std::uint64_t> m_dispatchCount;
+
+		// The value of m_dispatchCount when another thread last found an
+		// operation in m_runNext. See try_steal_run_next().
+		std::atomic<std::uint64_t> m_runNextSeenDispatchCount;
+
+		std::uint32_t m_randomState;
+
 	};
 
 	void static_thread_pool::schedule_operation::await_suspend(
@@ -334,8 +671,7 @@ namespace cppcoro
 		: m_threadCount(threadCount > 0 ? threadCount : 1)
 		, m_threadStates(std::make_unique<thread_state[]>(m_threadCount))
 		, m_stopRequested(false)
-		, m_globalQueueHead(nullptr)
-		, m_globalQueueTail(nullptr)
+		, m_globalQueues(std::make_unique<lock_free_queue[]>(m_threadCount))
 		, m_sleepingThreadCount(0)
 	{
 		m_threads.reserve(threadCount);
@@ -374,15 +710,20 @@ namespace cppcoro
 
 		auto tryGetRemote = [&]()
 		{
-			// Try to get some new work first from the global queue
-			// then if that queue is empty then try to steal from
-			// the local queues of other worker threads.
+			// Try to get some new work first from the operations
+			// that overflowed our local queue, then from the global
+			// queue and then if that queue is empty then try to steal
+			// from the queues of other worker threads.
 			// We try to get new work from the global queue first
 			// before stealing as stealing from other threads has
 			// the side-effect of those threads running out of work
 			// sooner and then having to steal work which increases
 			// contention.
-			auto* op = try_global_dequeue();
+			auto* op = localState.try_overflow_dequeue();
+			if (op == nullptr)
+			{
+				op = try_global_dequeue(threadIndex);
+			}
 			if (op == nullptr)
 			{
 				op = try_steal_from_other_thread(threadIndex);
@@ -392,12 +733,16 @@ namespace cppcoro
 
 		while (true)
 		{
-			// Process operations from the local queue.
+			// Process operations from the run-next slot and the local queue.
 			schedule_operation* op;
 
 			while (true)
 			{
-				op = localState.try_local_pop();
+				op = localState.try_run_next_pop(m_globalQueues[threadIndex]);
+				if (op == nullptr)
+				{
+					op = localState.try_local_pop();
+				}
 				if (op == nullptr)
 				{
 					op = tryGetRemote();
@@ -515,8 +860,16 @@ namespace cppcoro
 
 	void static_thread_pool::schedule_impl(schedule_operation* operation) noexcept
 	{
-		if (s_currentThreadPool != this ||
-			!s_currentState->try_local_enqueue(operation))
+		if (s_currentThreadPool == this)
+		{
+			// There's no need to wake up another thread for the operation in
+			// the run-next slot, as this thread is about to run it.
+			if (!s_currentState->set_run_next(operation))
+			{
+				return;
+			}
+		}
+		else
 		{
 			remote_enqueue(operation);
 		}
@@ -526,27 +879,17 @@ namespace cppcoro
 
 	void static_thread_pool::remote_enqueue(schedule_operation* operation) noexcept
 	{
-		auto* tail = m_globalQueueTail.load(std::memory_order_relaxed);
-		do
-		{
-			operation->m_next = tail;
-		} while (!m_globalQueueTail.compare_exchange_weak(
-			tail,
-			operation,
-			std::memory_order_seq_cst,
-			std::memory_order_relaxed));
+		m_globalQueues[local::producer_index() % m_threadCount].push(operation);
 	}
 
 	bool static_thread_pool::has_any_queued_work_for(std::uint32_t threadIndex) noexcept
 	{
-		if (m_globalQueueTail.load(std::memory_order_seq_cst) != nullptr)
-		{
-			return true;
-		}
-
-		if (m_globalQueueHead.load(std::memory_order_seq_cst) != nullptr)
+		for (std::uint32_t i = 0; i < m_threadCount; ++i)
 		{
-			return true;
+			if (m_globalQueues[i].has_any_queued_work())
+			{
+				return true;
+			}
 		}
 
 		for (std::uint32_t i = 0; i < m_threadCount; ++i)
@@ -568,14 +911,12 @@ namespace cppcoro
 		// don't bounce cache-lines around between threads/cores unnecessarily when
 		// multiple threads are all spinning waiting for work.
 
-		if (m_globalQueueTail.load(std::memory_order_relaxed) != nullptr)
-		{
-			return true;
-		}
-
-		if (m_globalQueueHead.load(std::memory_order_relaxed) != nullptr)
+		for (std::uint32_t i = 0; i < m_threadCount; ++i)
 		{
-			return true;
+			if (m_globalQueues[i].approx_has_any_queued_work())
+			{
+				return true;
+			}
 		}
 
 		for (std::uint32_t i = 0; i < m_threadCount; ++i)
@@ -641,53 +982,43 @@ namespace cppcoro
 	}
 
 	static_thread_pool::schedule_operation*
-	static_thread_pool::try_global_dequeue() noexcept
+	static_thread_pool::try_global_dequeue(std::uint32_t thisThreadIndex) noexcept
 	{
-		std::scoped_lock lock{ m_globalQueueMutex };
-
-		auto* head = m_globalQueueHead.load(std::memory_order_relaxed);
-		if (head == nullptr)
+		// Start with this thread's own queue so that threads taking work
+		// from the global queues tend not to contend with each other.
+		for (std::uint32_t i = 0; i < m_threadCount; ++i)
 		{
-			// Use seq-cst memory order so that when we check for an item in the
-			// global queue after signalling an intent to sleep that either we
-			// will see their enqueue or they will see our signal to sleep and
-			// wake us up.
-			if (m_globalQueueTail.load(std::memory_order_seq_cst) == nullptr)
-			{
-				return nullptr;
-			}
-
-			// Acquire the entire set of queued operations in a single operation.
-			auto* tail = m_globalQueueTail.exchange(nullptr, std::memory_order_acquire);
-			if (tail == nullptr)
+			const std::uint32_t queueIndex = (thisThreadIndex + i) % m_threadCount;
+			auto* op = m_threadStates[thisThreadIndex].try_dequeue_all_from(
+				m_globalQueues[queueIndex]);
+			if (op != nullptr)
 			{
-				return nullptr;
+				return op;
 			}
-
-			// Reverse the list 
-			do
-			{
-				auto* next = std::exchange(tail->m_next, head);
-				head = std::exchange(tail, next);
-			} while (tail != nullptr);
 		}
 
-		m_globalQueueHead = head->m_next;
-
-		return head;
+		return nullptr;
 	}
 
 	static_thread_pool::schedule_operation*
 	static_thread_pool::try_steal_from_other_thread(std::uint32_t thisThreadIndex) noexcept
 	{
+		auto& thisThreadState = m_threadStates[thisThreadIndex];
+
+		// Start from a random thread so that idle threads spread their
+		// steal attempts across the busy threads instead of all contending
+		// for the lock of the same one.
+		const std::uint32_t startIndex = thisThreadState.next_random() % m_threadCount;
+
 		// Try first with non-blocking steal attempts.
 
 		bool anyLocksUnavailable = false;
-		for (std::uint32_t otherThreadIndex = 0; otherThreadIndex < m_threadCount; ++otherThreadIndex)
+		for (std::uint32_t i = 0; i < m_threadCount; ++i)
 		{
+			const std::uint32_t otherThreadIndex = (startIndex + i) % m_threadCount;
 			if (otherThreadIndex == thisThreadIndex) continue;
 			auto& otherThreadState = m_threadStates[otherThreadIndex];
-			auto* op = otherThreadState.try_steal(&anyLocksUnavailable);
+			auto* op = otherThreadState.try_steal(thisThreadState, &anyLocksUnavailable);
 			if (op != nullptr)
 			{
 				return op;
@@ -698,11 +1029,12 @@ namespace cppcoro
 		{
 			// We didn't check all of the other threads for work to steal yet.
 			// Try again, this time waiting to acquire the locks.
-			for (std::uint32_t otherThreadIndex = 0; otherThreadIndex < m_threadCount; ++otherThreadIndex)
+			for (std::uint32_t i = 0; i < m_threadCount; ++i)
 			{
+				const std::uint32_t otherThreadIndex = (startIndex + i) % m_threadCount;
 				if (otherThreadIndex == thisThreadIndex) continue;
 				auto& otherThreadState = m_threadStates[otherThreadIndex];
-				auto* op = otherThreadState.try_steal();
+				auto* op = otherThreadState.try_steal(thisThreadState);
 				if (op != nullptr)
 				{
 					return op;
@@ -710,6 +1042,32 @@ namespace cppcoro
 			}
 		}
 
+		// Finally, take the operations that overflowed another thread's
+		// local queue, in case that thread is busy running something else.
+		for (std::uint32_t i = 0; i < m_threadCount; ++i)
+		{
+			const std::uint32_t otherThreadIndex = (startIndex + i) % m_threadCount;
+			if (otherThreadIndex == thisThreadIndex) continue;
+			auto* op = m_threadStates[otherThreadIndex].try_steal_overflow(thisThreadState);
+			if (op != nullptr)
+			{
+				return op;
+			}
+		}
+
+		// And as a last resort, the operation that another thread was going
+		// to run next.
+		for (std::uint32_t i = 0; i < m_threadCount; ++i)
+		{
+			const std::uint32_t otherThreadIndex = (startIndex + i) % m_threadCount;
+			if (otherThreadIndex == thisThreadIndex) continue;
+			auto* op = m_threadStates[otherThreadIndex].try_steal_run_next();
+			if (op != nullptr)
+			{
+				return op;
+			}
+		}
+
 		return nullptr;
 	}
 
@@ -739,7 +1097,12 @@ namespace cppcoro
 		// guaranteed of finding a thread to wake-up here, but not necessarily
 		// in a single pass due to threads potentially waking themselves up
 		// in try_clear_intent_to_sleep().
-		while (true)
+		//
+		// The exception is when the pool is shutting down, as shutdown() wakes
+		// up all of the threads without updating the count. This can happen
+		// if another thread ran the scheduled operation, completing the
+		// application's work, before this thread got here.
+		while (!is_shutdown_requested())
 		{
 			for (std::uint32_t i = 0; i < m_threadCount; ++i)
 			{
@@ -72,4 +72,211 @@ cppcoro::file_write_operation_cancellable cppcoro::writable_file::write(
 	};
 }
 
+#elif CPPCORO_OS_LINUX
+# include <fcntl.h>
+# include <linux/io_uring.h>
+# include <unistd.h>
+# include <cerrno>
+# include <limits>
+
+namespace
+{
+	namespace local
+	{
+		constexpr std::uint32_t sync_range_flags =
+			SYNC_FILE_RANGE_WAIT_BEFORE |
+			SYNC_FILE_RANGE_WRITE |
+			SYNC_FILE_RANGE_WAIT_AFTER;
+
+		std::uint64_t sync_range_length(std::uint64_t length) noexcept
+		{
+			// io_uring only takes a 32-bit length. A length of zero means
+			// "up to the end of the file", which covers the requested range.
+			return length <= std::numeric_limits<std::uint32_t>::max() ? length : 0;
+		}
+	}
+}
+
+void cppcoro::writable_file::set_size(
+	std::uint64_t fileSize)
+{
+	if (::ftruncate(m_fileHandle.fd(), static_cast<off_t>(fileSize)) == -1)
+	{
+		throw std::system_error
+		{
+			errno,
+			std::system_category(),
+			"error setting file size: ftruncate"
+		};
+	}
+}
+
+cppcoro::file_write_operation cppcoro::writable_file::write(
+	std::uint64_t offset,
+	const void* buffer,
+	std::size_t byteCount) noexcept
+{
+	return file_write_operation{
+		*m_ioService,
+		m_fileHandle.fd(),
+		offset,
+		buffer,
+		byteCount
+	};
+}
+
+cppcoro::file_write_operation_cancellable cppcoro::writable_file::write(
+	std::uint64_t offset,
+	const void* buffer,
+	std::size_t byteCount,
+	cancellation_token ct) noexcept
+{
+	return file_write_operation_cancellable{
+		*m_ioService,
+		m_fileHandle.fd(),
+		offset,
+		buffer,
+		byteCount,
+		std::move(ct)
+	};
+}
+
+cppcoro::file_writev_operation cppcoro::writable_file::write(
+	std::uint64_t offset,
+	std::span<const iovec> buffers) noexcept
+{
+	return file_writev_operation{
+		*m_ioService,
+		m_fileHandle.fd(),
+		offset,
+		buffers
+	};
+}
+
+cppcoro::file_writev_operation_cancellable cppcoro::writable_file::write(
+	std::uint64_t offset,
+	std::span<const iovec> buffers,
+	cancellation_token ct) noexcept
+{
+	return file_writev_operation_cancellable{
+		*m_ioService,
+		m_fileHandle.fd(),
+		offset,
+		buffers,
+		std::move(ct)
+	};
+}
+
+cppcoro::file_sync_operation cppcoro::writable_file::flush() noexcept
+{
+	return file_sync_operation{
+		*m_ioService,
+		m_fileHandle.fd(),
+		detail::lnx::io_opcode::fsync,
+		0,
+		0,
+		0
+	};
+}
+
+cppcoro::file_sync_operation_cancellable cppcoro::writable_file::flush(
+	cancellation_token ct) noexcept
+{
+	return file_sync_operation_cancellable{
+		*m_ioService,
+		m_fileHandle.fd(),
+		detail::lnx::io_opcode::fsync,
+		0,
+		0,
+		0,
+		std::move(ct)
+	};
+}
+
+cppcoro::file_sync_operation cppcoro::writable_file::flush_data() noexcept
+{
+	return file_sync_operation{
+		*m_ioService,
+		m_fileHandle.fd(),
+		detail::lnx::io_opcode::fsync,
+		IORING_FSYNC_DATASYNC,
+		0,
+		0
+	};
+}
+
+cppcoro::file_sync_operation_cancellable cppcoro::writable_file::flush_data(
+	cancellation_token ct) noexcept
+{
+	return file_sync_operation_cancellable{
+		*m_ioService,
+		m_fileHandle.fd(),
+		detail::lnx::io_opcode::fsync,
+		IORING_FSYNC_DATASYNC,
+		0,
+		0,
+		std::move(ct)
+	};
+}
+
+cppcoro::file_sync_operation cppcoro::writable_file::preallocate(
+	std::uint64_t offset,
+	std::uint64_t length) noexcept
+{
+	return file_sync_operation{
+		*m_ioService,
+		m_fileHandle.fd(),
+		detail::lnx::io_opcode::fallocate,
+		0,
+		offset,
+		length
+	};
+}
+
+cppcoro::file_sync_operation_cancellable cppcoro::writable_file::preallocate(
+	std::uint64_t offset,
+	std::uint64_t length,
+	cancellation_token ct) noexcept
+{
+	return file_sync_operation_cancellable{
+		*m_ioService,
+		m_fileHandle.fd(),
+		detail::lnx::io_opcode::fallocate,
+		0,
+		offset,
+		length,
+		std::move(ct)
+	};
+}
+
+cppcoro::file_sync_operation cppcoro::writable_file::sync_range(
+	std::uint64_t offset,
+	std::uint64_t length) noexcept
+{
+	return file_sync_operation{
+		*m_ioService,
+		m_fileHandle.fd(),
+		detail::lnx::io_opcode::sync_file_range,
+		local::sync_range_flags,
+		offset,
+		local::sync_range_length(length)
+	};
+}
+
+cppcoro::file_sync_operation_cancellable cppcoro::writable_file::sync_range(
+	std::uint64_t offset,
+	std::uint64_t length,
+	cancellation_token ct) noexcept
+{
+	return file_sync_operation_cancellable{
+		*m_ioService,
+		m_fileHandle.fd(),
+		detail::lnx::io_opcode::sync_file_range,
+		local::sync_range_flags,
+		offset,
+		local::sync_range_length(length),
+		std::move(ct)
+	};
+}
+
 #endif
@@ -3,7 +3,7 @@
 // Licenced under MIT license. See LICENSE.txt for details.
 ///////////////////////////////////////////////////////////////////////////////
 
-#include <cppcoro\write_only_file.hpp>
+#include <cppcoro/write_only_file.hpp>
 
 #if CPPCORO_OS_WINNT
 # ifndef WIN32_LEAN_AND_MEAN
@@ -13,7 +13,7 @@
 
 cppcoro::write_only_file cppcoro::write_only_file::open(
 	io_service& ioService,
-	const std::experimental::filesystem::path& path,
+	const std::filesystem::path& path,
 	file_open_mode openMode,
 	file_share_mode shareMode,
 	file_buffering_mode bufferingMode)
@@ -34,4 +34,32 @@ cppcoro::write_only_file::write_only_file(
 {
 }
 
+#elif CPPCORO_OS_LINUX
+# include <fcntl.h>
+
+cppcoro::write_only_file cppcoro::write_only_file::open(
+	io_service& ioService,
+	const std::filesystem::path& path,
+	file_open_mode openMode,
+	file_share_mode shareMode,
+	file_buffering_mode bufferingMode)
+{
+	return write_only_file(file::open(
+		O_WRONLY,
+		ioService,
+		path,
+		openMode,
+		shareMode,
+		bufferingMode),
+		ioService);
+}
+
+cppcoro::write_only_file::write_only_file(
+	detail::lnx::safe_file_descriptor&& fileHandle,
+	io_service& ioService) noexcept
+	: file(std::move(fileHandle), &ioService)
+	, writable_file(detail::lnx::safe_file_descriptor{}, &ioService)
+{
+}
+
 #endif
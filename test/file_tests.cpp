@@ -12,11 +12,15 @@
 #include <cppcoro/when_all.hpp>
 #include <cppcoro/cancellation_source.hpp>
 #include <cppcoro/on_scope_exit.hpp>
+#include <cppcoro/static_thread_pool.hpp>
 
 #include <random>
 #include <thread>
 #include <cassert>
+#include <cstring>
+#include <filesystem>
 #include <string>
+#include <vector>
 
 #include "io_service_fixture.hpp"
 
@@ -25,7 +29,7 @@
 
 TEST_SUITE_BEGIN("file");
 
-namespace fs = std::experimental::filesystem;
+namespace fs = std::filesystem;
 
 namespace
 {
@@ -61,14 +65,14 @@ namespace
 			fs::remove_all(m_path);
 		}
 
-		const std::experimental::filesystem::path& temp_dir()
+		const fs::path& temp_dir()
 		{
 			return m_path;
 		}
 
 	private:
 
-		std::experimental::filesystem::path m_path;
+		fs::path m_path;
 
 	};
 
@@ -212,4 +216,208 @@ TEST_CASE_FIXTURE(temp_dir_with_io_service_fixture, "cancel read")
 	}());
 }
 
+#if CPPCORO_OS_LINUX
+TEST_CASE_FIXTURE(temp_dir_with_io_service_fixture, "temporary file is unnamed")
+{
+	cppcoro::sync_wait([&]() -> cppcoro::task<>
+	{
+		cppcoro::io_work_scope ioScope{ io_service() };
+		auto f = cppcoro::read_write_file::open(
+			io_service(),
+			temp_dir() / "temp.txt",
+			cppcoro::file_open_mode::create_always,
+			cppcoro::file_share_mode::none,
+			cppcoro::file_buffering_mode::temporary | cppcoro::file_buffering_mode::sequential);
+
+		CHECK(fs::is_empty(temp_dir()));
+
+		char buffer1[100];
+		std::memset(buffer1, 0xAB, sizeof(buffer1));
+		CHECK(co_await f.write(0, buffer1, sizeof(buffer1)) == sizeof(buffer1));
+		CHECK(f.size() == sizeof(buffer1));
+
+		char buffer2[100];
+		CHECK(co_await f.read(0, buffer2, sizeof(buffer2)) == sizeof(buffer2));
+		CHECK(std::memcmp(buffer1, buffer2, sizeof(buffer1)) == 0);
+	}());
+}
+
+TEST_CASE_FIXTURE(temp_dir_with_io_service_fixture, "vectored read and write")
+{
+	cppcoro::sync_wait([&]() -> cppcoro::task<>
+	{
+		cppcoro::io_work_scope ioScope{ io_service() };
+		auto f = cppcoro::read_write_file::open(io_service(), temp_dir() / "foo.txt");
+
+		char header[10];
+		char body[100];
+		std::memset(header, 'h', sizeof(header));
+		std::memset(body, 'b', sizeof(body));
+
+		const iovec writeBuffers[] = {
+			{ header, sizeof(header) },
+			{ body, sizeof(body) }
+		};
+		CHECK(co_await f.write(5, writeBuffers) == sizeof(header) + sizeof(body));
+		CHECK(f.size() == 5 + sizeof(header) + sizeof(body));
+
+		char header2[10];
+		char body2[100];
+		iovec readBuffers[] = {
+			{ header2, sizeof(header2) },
+			{ body2, sizeof(body2) }
+		};
+		CHECK(co_await f.read(5, readBuffers) == sizeof(header2) + sizeof(body2));
+		CHECK(std::memcmp(header, header2, sizeof(header)) == 0);
+		CHECK(std::memcmp(body, body2, sizeof(body)) == 0);
+	}());
+}
+
+TEST_CASE_FIXTURE(temp_dir_with_io_service_fixture, "preallocate and flush")
+{
+	cppcoro::sync_wait([&]() -> cppcoro::task<>
+	{
+		cppcoro::io_work_scope ioScope{ io_service() };
+		auto f = cppcoro::write_only_file::open(io_service(), temp_dir() / "wal.log");
+
+		co_await f.preallocate(0, 64 * 1024);
+		CHECK(f.size() == 64 * 1024);
+
+		char buffer[4096];
+		std::memset(buffer, 0xAB, sizeof(buffer));
+		co_await f.write(0, buffer, sizeof(buffer));
+
+		co_await f.sync_range(0, sizeof(buffer));
+		co_await f.flush_data();
+		co_await f.flush();
+
+		cppcoro::cancellation_source canceller;
+		canceller.request_cancellation();
+		CHECK_THROWS_AS(co_await f.flush(canceller.token()), const cppcoro::operation_cancelled&);
+	}());
+}
+
+TEST_CASE_FIXTURE(temp_dir_with_io_service_fixture, "copy between files")
+{
+	cppcoro::sync_wait([&]() -> cppcoro::task<>
+	{
+		cppcoro::io_work_scope ioScope{ io_service() };
+
+		auto source = cppcoro::read_write_file::open(io_service(), temp_dir() / "source.data");
+		char buffer[1000];
+		for (int i = 0; i < 1000; ++i)
+		{
+			buffer[i] = static_cast<char>('a' + i % 26);
+		}
+		co_await source.write(0, buffer, sizeof(buffer));
+
+		auto destination = cppcoro::write_only_file::open(io_service(), temp_dir() / "destination.data");
+		CHECK(co_await source.copy_to(100, destination, 10, 500) == 500);
+		CHECK(destination.size() == 510);
+
+		// Copying from the end of the file copies nothing.
+		CHECK(co_await source.copy_to(1000, destination, 0, 500) == 0);
+
+		auto check = cppcoro::read_only_file::open(io_service(), temp_dir() / "destination.data");
+		char readBuffer[500];
+		CHECK(co_await check.read(10, readBuffer, sizeof(readBuffer)) == sizeof(readBuffer));
+		CHECK(std::memcmp(readBuffer, buffer + 100, sizeof(readBuffer)) == 0);
+	}());
+}
+
+TEST_CASE_FIXTURE(temp_dir_with_io_service_fixture, "copy large file between files")
+{
+	cppcoro::sync_wait([&]() -> cppcoro::task<>
+	{
+		cppcoro::io_work_scope ioScope{ io_service() };
+
+		constexpr std::size_t size = 3 * 1024 * 1024 + 100;
+		std::vector<char> buffer(size);
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			buffer[i] = static_cast<char>('a' + i % 26);
+		}
+
+		auto source = cppcoro::read_write_file::open(io_service(), temp_dir() / "source.data");
+		co_await source.write(0, buffer.data(), size);
+
+		auto destination = cppcoro::write_only_file::open(io_service(), temp_dir() / "destination.data");
+
+		// Each operation copies a bounded amount so that it doesn't hold up
+		// the I/O thread performing it for long.
+		std::size_t copiedCount = 0;
+		while (copiedCount < size)
+		{
+			const std::size_t count = co_await source.copy_to(
+				copiedCount, destination, copiedCount, size - copiedCount);
+			REQUIRE(count > 0);
+			CHECK(count <= 1024 * 1024);
+			copiedCount += count;
+		}
+
+		CHECK(destination.size() == size);
+	}());
+}
+
+TEST_CASE_FIXTURE(temp_dir_with_io_service_fixture, "map read-only file")
+{
+	cppcoro::static_thread_pool threadPool{ 1 };
+
+	cppcoro::sync_wait([&]() -> cppcoro::task<>
+	{
+		cppcoro::io_work_scope ioScope{ io_service() };
+
+		{
+			auto f = cppcoro::write_only_file::open(io_service(), temp_dir() / "foo.bin");
+			char buffer[10000];
+			for (std::size_t i = 0; i < sizeof(buffer); ++i)
+			{
+				buffer[i] = static_cast<char>('a' + i % 26);
+			}
+			co_await f.write(0, buffer, sizeof(buffer));
+		}
+
+		auto f = cppcoro::read_only_file::open(io_service(), temp_dir() / "foo.bin");
+
+		auto whole = f.map();
+		REQUIRE(whole.size() == 10000);
+
+		co_await whole.prefetch(threadPool, 0, whole.size());
+		CHECK(static_cast<char>(whole.data()[27]) == 'b');
+
+		// Offsets that are not page-aligned are supported.
+		auto part = f.map(5000, 10);
+		REQUIRE(part.size() == 10);
+		CHECK(static_cast<char>(part.data()[0]) == 'a' + 5000 % 26);
+	}());
+}
+
+TEST_CASE_FIXTURE(temp_dir_with_io_service_fixture, "prefetch of truncated mapped file throws")
+{
+	cppcoro::static_thread_pool threadPool{ 1 };
+
+	cppcoro::sync_wait([&]() -> cppcoro::task<>
+	{
+		cppcoro::io_work_scope ioScope{ io_service() };
+
+		auto writer = cppcoro::write_only_file::open(io_service(), temp_dir() / "foo.bin");
+
+		const std::vector<char> buffer(1024 * 1024, 'x');
+		co_await writer.write(0, buffer.data(), buffer.size());
+
+		auto f = cppcoro::read_only_file::open(io_service(), temp_dir() / "foo.bin");
+
+		auto whole = f.map();
+		REQUIRE(whole.size() == buffer.size());
+
+		// Pages past the new end of the file can no longer be read in, which
+		// must be reported rather than raising SIGBUS.
+		writer.set_size(4096);
+		CHECK_THROWS_AS(
+			co_await whole.prefetch(threadPool, 0, whole.size()),
+			const std::system_error&);
+	}());
+}
+#endif
+
 TEST_SUITE_END();
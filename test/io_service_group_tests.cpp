@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright (c) Lewis Baker
+// Licenced under MIT license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cppcoro/io_service_group.hpp>
+#include <cppcoro/task.hpp>
+#include <cppcoro/sync_wait.hpp>
+#include <cppcoro/when_all.hpp>
+
+#include <thread>
+#include <vector>
+
+#include <ostream>
+#include "doctest/doctest.h"
+
+TEST_SUITE_BEGIN("io_service_group");
+
+TEST_CASE("construct with shard count")
+{
+	cppcoro::io_service_group group{ 3 };
+	CHECK(group.shard_count() == 3);
+	CHECK(group.current_shard() == nullptr);
+}
+
+TEST_CASE("schedule from outside the group round-robins across shards")
+{
+	cppcoro::io_service_group group{ 2 };
+
+	auto getShard = [&]() -> cppcoro::task<cppcoro::io_service*>
+	{
+		co_await group.schedule();
+		co_return group.current_shard();
+	};
+
+	auto shard1 = cppcoro::sync_wait(getShard());
+	auto shard2 = cppcoro::sync_wait(getShard());
+
+	CHECK(shard1 != nullptr);
+	CHECK(shard2 != nullptr);
+	CHECK(shard1 != shard2);
+}
+
+TEST_CASE("schedule from a shard stays on that shard")
+{
+	cppcoro::io_service_group group{ 4 };
+
+	auto run = [&]() -> cppcoro::task<>
+	{
+		co_await group.schedule();
+
+		auto* shard = group.current_shard();
+		REQUIRE(shard != nullptr);
+
+		const auto threadId = std::this_thread::get_id();
+		for (int i = 0; i < 100; ++i)
+		{
+			co_await group.schedule();
+			CHECK(group.current_shard() == shard);
+			CHECK(std::this_thread::get_id() == threadId);
+		}
+	};
+
+	std::vector<cppcoro::task<>> tasks;
+	for (int i = 0; i < 8; ++i)
+	{
+		tasks.push_back(run());
+	}
+
+	cppcoro::sync_wait(cppcoro::when_all(std::move(tasks)));
+}
+
+TEST_SUITE_END();
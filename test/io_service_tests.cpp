@@ -17,6 +17,16 @@
 #include <thread>
 #include <vector>
 
+#if CPPCORO_OS_LINUX
+# include <cstddef>
+# include <filesystem>
+# include <span>
+# include <string>
+# include <system_error>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
 #include <ostream>
 #include "doctest/doctest.h"
 
@@ -69,6 +79,133 @@ TEST_CASE("schedule coroutine")
 		}()));
 }
 
+#if CPPCORO_OS_LINUX
+TEST_CASE("schedule coroutine with epoll backend")
+{
+	cppcoro::io_service service{ 0, cppcoro::io_service_backend::epoll };
+	CHECK(service.backend() == cppcoro::io_service_backend::epoll);
+
+	std::atomic<int> completedCount = 0;
+
+	auto runOnIoThread = [&]() -> cppcoro::task<>
+	{
+		co_await service.schedule();
+		++completedCount;
+	};
+
+	std::vector<std::thread> ioThreads;
+	auto joinOnExit = cppcoro::on_scope_exit([&]
+	{
+		service.stop();
+		for (auto& thread : ioThreads)
+		{
+			thread.join();
+		}
+	});
+
+	for (int i = 0; i < 2; ++i)
+	{
+		ioThreads.emplace_back([&] { service.process_events(); });
+	}
+
+	std::vector<cppcoro::task<>> tasks;
+	for (int i = 0; i < 1000; ++i)
+	{
+		tasks.emplace_back(runOnIoThread());
+	}
+
+	cppcoro::sync_wait(cppcoro::when_all(std::move(tasks)));
+
+	CHECK(completedCount == 1000);
+}
+
+TEST_CASE("schedule coroutine with submission polling")
+{
+	using namespace std::literals::chrono_literals;
+
+	cppcoro::io_service_options options;
+	options.submissionPolling = true;
+	options.submissionPollIdleTimeout = 1ms;
+
+	// Falls back to regular submission if not permitted.
+	cppcoro::io_service service{ options };
+	if (service.backend() != cppcoro::io_service_backend::io_uring)
+	{
+		CHECK_FALSE(service.is_submission_polling_enabled());
+	}
+
+	MESSAGE("submission polling enabled: " << service.is_submission_polling_enabled());
+
+	std::atomic<int> completedCount = 0;
+
+	auto runOnIoThread = [&]() -> cppcoro::task<>
+	{
+		co_await service.schedule();
+		++completedCount;
+
+		// Give the kernel polling thread time to go to sleep so that the
+		// next submission has to wake it up.
+		co_await service.schedule_after(5ms);
+		++completedCount;
+	};
+
+	std::thread ioThread{ [&] { service.process_events(); } };
+	auto joinOnExit = cppcoro::on_scope_exit([&]
+	{
+		service.stop();
+		ioThread.join();
+	});
+
+	std::vector<cppcoro::task<>> tasks;
+	for (int i = 0; i < 100; ++i)
+	{
+		tasks.emplace_back(runOnIoThread());
+	}
+
+	cppcoro::sync_wait(cppcoro::when_all(std::move(tasks)));
+
+	CHECK(completedCount == 200);
+}
+
+TEST_CASE("register files and buffers")
+{
+	cppcoro::io_service service;
+
+	int fds[2];
+	REQUIRE(::pipe(fds) == 0);
+	auto closeOnExit = cppcoro::on_scope_exit([&]
+	{
+		::close(fds[0]);
+		::close(fds[1]);
+	});
+
+	service.register_file(fds[0]);
+	service.register_file(fds[1]);
+
+	std::vector<std::byte> storage(2 * 4096);
+	std::span<std::byte> buffers[] = {
+		std::span<std::byte>{ storage }.first(4096),
+		std::span<std::byte>{ storage }.last(4096)
+	};
+
+	service.register_buffers(buffers);
+
+	if (service.backend() == cppcoro::io_service_backend::io_uring)
+	{
+		// Only one set of buffers can be registered at a time.
+		CHECK_THROWS_AS(service.register_buffers(buffers), const std::system_error&);
+	}
+
+	service.unregister_buffers();
+	service.register_buffers(buffers);
+	service.unregister_buffers();
+
+	// Descriptors must be unregistered before they are closed.
+	service.unregister_file(fds[0]);
+	service.unregister_file(fds[1]);
+}
+#endif
+
 TEST_CASE_FIXTURE(io_service_fixture_with_threads<2>, "multiple I/O threads servicing events")
 {
 	std::atomic<int> completedCount = 0;
@@ -92,6 +229,46 @@ TEST_CASE_FIXTURE(io_service_fixture_with_threads<2>, "multiple I/O threads serv
 	CHECK(completedCount == 1000);
 }
 
+TEST_CASE("busy-polling I/O thread")
+{
+	using namespace std::literals::chrono_literals;
+
+	cppcoro::io_service_options options;
+	options.busyPollDuration = 10ms;
+
+	cppcoro::io_service ioService{ options };
+
+	std::thread ioThread{ [&] { ioService.process_events(); } };
+	auto stopOnExit = cppcoro::on_scope_exit([&]
+	{
+		ioService.stop();
+		ioThread.join();
+	});
+
+	auto runOnIoThread = [&]() -> cppcoro::task<std::thread::id>
+	{
+		co_await ioService.schedule();
+		co_return std::this_thread::get_id();
+	};
+
+	// Each schedule() arrives while the I/O thread is idle.
+	for (int i = 0; i < 100; ++i)
+	{
+		CHECK(cppcoro::sync_wait(runOnIoThread()) == ioThread.get_id());
+	}
+
+	const auto stats = ioService.get_busy_poll_stats();
+	CHECK(stats.productivePollCount <= stats.pollCount);
+
+#if CPPCORO_OS_LINUX
+	CHECK(stats.pollCount > 0);
+#endif
+
+	MESSAGE(
+		stats.productivePollCount << " of " << stats.pollCount
+		<< " busy-polls found an event");
+}
+
 TEST_CASE("Multiple concurrent timers")
 {
 	cppcoro::io_service ioService;
@@ -227,4 +404,215 @@ TEST_CASE_FIXTURE(io_service_fixture_with_threads<1>, "Many concurrent timers")
 		<< "ms");
 }
 
+TEST_CASE_FIXTURE(io_service_fixture_with_threads<1>, "Many cancelled timers"
+	* doctest::timeout{ 5.0 })
+{
+	using namespace std::literals::chrono_literals;
+
+	auto startTimer = [&](cppcoro::cancellation_token ct) -> cppcoro::task<>
+	{
+		CHECK_THROWS_AS(
+			co_await io_service().schedule_after(20'000ms, std::move(ct)),
+			const cppcoro::operation_cancelled&);
+	};
+
+	constexpr std::uint32_t taskCount = 10'000;
+
+	auto runManyTimers = [&]() -> cppcoro::task<>
+	{
+		cppcoro::cancellation_source source;
+
+		std::vector<cppcoro::task<>> tasks;
+
+		tasks.reserve(taskCount);
+
+		for (std::uint32_t i = 0; i < taskCount; ++i)
+		{
+			tasks.emplace_back(startTimer(source.token()));
+		}
+
+		co_await cppcoro::when_all_ready(
+			cppcoro::when_all(std::move(tasks)),
+			[&]() -> cppcoro::task<>
+			{
+				co_await io_service().schedule_after(10ms);
+				source.request_cancellation();
+			}());
+	};
+
+	cppcoro::sync_wait(runManyTimers());
+}
+
+TEST_CASE("Timers with coarse timer resolution")
+{
+	using namespace std::literals::chrono_literals;
+
+	cppcoro::io_service_options options;
+	options.timerResolution = 10ms;
+
+	cppcoro::io_service ioService{ options };
+
+	auto startTimer = [&](std::chrono::milliseconds duration)
+		-> cppcoro::task<std::chrono::high_resolution_clock::duration>
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		co_await ioService.schedule_after(duration);
+
+		auto end = std::chrono::high_resolution_clock::now();
+
+		co_return end - start;
+	};
+
+	auto test = [&]() -> cppcoro::task<>
+	{
+		auto[time1, time2] = co_await cppcoro::when_all(
+			startTimer(1ms),
+			startTimer(25ms));
+
+		// Timers must never fire early, even if rounded to a coarser tick.
+		CHECK(time1 >= 1ms);
+		CHECK(time2 >= 25ms);
+	};
+
+	cppcoro::sync_wait(cppcoro::when_all_ready(
+		[&]() -> cppcoro::task<>
+		{
+			auto stopIoOnExit = cppcoro::on_scope_exit([&] { ioService.stop(); });
+			co_await test();
+		}(),
+		[&]() -> cppcoro::task<>
+		{
+			ioService.process_events();
+			co_return;
+		}()));
+}
+
+#if CPPCORO_OS_LINUX
+TEST_CASE("Timers processed by the event loop"
+	* doctest::timeout{ 5.0 })
+{
+	using namespace std::literals::chrono_literals;
+
+	cppcoro::io_service_options options;
+	options.timerMode = cppcoro::io_service_timer_mode::event_loop;
+
+	cppcoro::io_service ioService{ options };
+
+	auto startTimer = [&](std::chrono::milliseconds duration)
+		-> cppcoro::task<std::chrono::high_resolution_clock::duration>
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		co_await ioService.schedule_after(duration);
+
+		auto end = std::chrono::high_resolution_clock::now();
+
+		co_return end - start;
+	};
+
+	auto longWait = [&](cppcoro::cancellation_token ct) -> cppcoro::task<>
+	{
+		CHECK_THROWS_AS(
+			co_await ioService.schedule_after(20'000ms, std::move(ct)),
+			const cppcoro::operation_cancelled&);
+	};
+
+	auto test = [&]() -> cppcoro::task<>
+	{
+		cppcoro::cancellation_source source;
+
+		auto[time1, time2] = co_await cppcoro::when_all(
+			startTimer(5ms),
+			startTimer(20ms));
+
+		CHECK(time1 >= 5ms);
+		CHECK(time2 >= 20ms);
+
+		co_await cppcoro::when_all_ready(
+			longWait(source.token()),
+			[&]() -> cppcoro::task<>
+			{
+				co_await ioService.schedule_after(1ms);
+				source.request_cancellation();
+			}());
+	};
+
+	cppcoro::sync_wait(cppcoro::when_all_ready(
+		[&]() -> cppcoro::task<>
+		{
+			auto stopIoOnExit = cppcoro::on_scope_exit([&] { ioService.stop(); });
+			co_await test();
+		}(),
+		[&]() -> cppcoro::task<>
+		{
+			ioService.process_events();
+			co_return;
+		}()));
+}
+
+TEST_CASE("Timer fires after a failed read of the event loop's timerfd"
+	* doctest::timeout{ 5.0 })
+{
+	using namespace std::literals::chrono_literals;
+
+	cppcoro::io_service_options options;
+	options.backend = cppcoro::io_service_backend::epoll;
+	options.timerMode = cppcoro::io_service_timer_mode::event_loop;
+
+	cppcoro::io_service ioService{ options };
+
+	int timerFd = -1;
+	for (const auto& entry : std::filesystem::directory_iterator{ "/proc/self/fd" })
+	{
+		std::error_code ec;
+		if (std::filesystem::read_symlink(entry.path(), ec) == "anon_inode:[timerfd]")
+		{
+			timerFd = std::stoi(entry.path().filename().string());
+		}
+	}
+	REQUIRE(timerFd != -1);
+
+	const int savedTimerFd = ::dup(timerFd);
+	const int directoryFd = ::open("/", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	REQUIRE(savedTimerFd != -1);
+	REQUIRE(directoryFd != -1);
+	auto closeOnExit = cppcoro::on_scope_exit([&]
+	{
+		::close(savedTimerFd);
+		::close(directoryFd);
+	});
+
+	// While the reactor waits for the timerfd to become readable, put a
+	// directory in its place so that the read fails when the timer expires.
+	// The timer only fires if the read is restarted after the timerfd has
+	// been put back.
+	std::thread injector{ [&]
+	{
+		std::this_thread::sleep_for(10ms);
+		::dup2(directoryFd, timerFd);
+		std::this_thread::sleep_for(100ms);
+		::dup2(savedTimerFd, timerFd);
+	} };
+	auto joinOnExit = cppcoro::on_scope_exit([&] { injector.join(); });
+
+	cppcoro::sync_wait(cppcoro::when_all_ready(
+		[&]() -> cppcoro::task<>
+		{
+			auto stopIoOnExit = cppcoro::on_scope_exit([&] { ioService.stop(); });
+
+			auto start = std::chrono::high_resolution_clock::now();
+			co_await ioService.schedule_after(50ms);
+			auto end = std::chrono::high_resolution_clock::now();
+
+			CHECK(end - start >= 50ms);
+		}(),
+		[&]() -> cppcoro::task<>
+		{
+			ioService.process_events();
+			co_return;
+		}()));
+}
+#endif
+
 TEST_SUITE_END();
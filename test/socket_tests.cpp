@@ -4,7 +4,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <cppcoro/io_service.hpp>
+#include <cppcoro/read_only_file.hpp>
 #include <cppcoro/net/socket.hpp>
+#include <cppcoro/net/recv_buffer_pool.hpp>
 #include <cppcoro/task.hpp>
 #include <cppcoro/when_all.hpp>
 #include <cppcoro/sync_wait.hpp>
@@ -12,6 +14,15 @@
 #include <cppcoro/cancellation_source.hpp>
 #include <cppcoro/cancellation_token.hpp>
 #include <cppcoro/async_scope.hpp>
+#include <cppcoro/single_consumer_event.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <vector>
 
 #include "doctest/doctest.h"
 
@@ -364,96 +375,335 @@ TEST_CASE("send/recv TCP/IPv4 many connections")
 
 #endif
 
-TEST_CASE("udp send_to/recv_from")
+TEST_CASE("TCP/IPv4 accept_many")
 {
 	io_service ioSvc;
 
-	auto server = [&](socket serverSocket) -> task<int>
+	auto listeningSocket = socket::create_tcpv4(ioSvc);
+
+	listeningSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+	listeningSocket.listen(20);
+
+	constexpr int clientCount = 20;
+
+	auto server = [&]() -> task<int>
 	{
-		std::uint8_t buffer[100];
+		int acceptedCount = 0;
 
-		auto[bytesReceived, remoteEndPoint] = co_await serverSocket.recv_from(buffer, 100);
-		CHECK(bytesReceived == 50);
+		auto connections = listeningSocket.accept_many(ioSvc);
+		for (auto it = co_await connections.begin(); it != connections.end(); co_await ++it)
+		{
+			socket s = std::move(*it);
+			CHECK(s.remote_endpoint().is_ipv4());
 
-		// Send an ACK response.
+			// Closing the connection ends the client's recv().
+			s.close_send();
+			co_await s.disconnect();
+
+			if (++acceptedCount == clientCount)
+			{
+				break;
+			}
+		}
+
+		co_return acceptedCount;
+	};
+
+	auto client = [&]() -> task<>
+	{
+		auto s = socket::create_tcpv4(ioSvc);
+		co_await s.connect(listeningSocket.local_endpoint());
+
+		std::uint8_t buffer[1];
+		CHECK(co_await s.recv(buffer, 1) == 0);
+	};
+
+	auto manyClients = [&]() -> task<int>
+	{
+		std::vector<task<>> clientTasks;
+		clientTasks.reserve(clientCount);
+		for (int i = 0; i < clientCount; ++i)
 		{
-			const std::uint8_t response[1] = { 0 };
-			co_await serverSocket.send_to(remoteEndPoint, &response, 1);
+			clientTasks.emplace_back(client());
 		}
 
-		// Second message received won't fit within buffer.
+		co_await when_all(std::move(clientTasks));
+		co_return 0;
+	};
+
+	(void)sync_wait(when_all(
+		[&]() -> task<int>
+		{
+			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
+			auto [acceptedCount, ignored] = co_await when_all(server(), manyClients());
+			CHECK(acceptedCount == clientCount);
+			co_return 0;
+		}(),
+		[&]() -> task<int>
+		{
+			ioSvc.process_events();
+			co_return 0;
+		}()));
+}
+
+TEST_CASE("TCP/IPv4 accept_many cancellation")
+{
+	io_service ioSvc;
+
+	auto listeningSocket = socket::create_tcpv4(ioSvc);
+
+	listeningSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+	listeningSocket.listen(3);
+
+	cancellation_source canceller;
+
+	auto server = [&]() -> task<int>
+	{
+		auto connections = listeningSocket.accept_many(ioSvc, canceller.token());
 		try
 		{
-			std::tie(bytesReceived, remoteEndPoint) = co_await serverSocket.recv_from(buffer, 100);
+			(void)co_await connections.begin();
 			FAIL("Should have thrown");
 		}
-		catch (const std::system_error&)
+		catch (const operation_cancelled&)
 		{
-			// TODO: Map this situation to some kind of error_condition value.
-			// The win32 ERROR_MORE_DATA error code doesn't seem to map to any of the standard std::errc values.
-			//
-			// CHECK(ex.code() == ???);
-			//
-			// Possibly also need to switch to returning a std::error_code directly rather than
-			// throwing a std::system_error for this case.
 		}
 
-		// Send an NACK response.
-		{
-			const std::uint8_t response[1] = { 1 };
-			co_await serverSocket.send_to(remoteEndPoint, response, 1);
-		}
+		co_return 0;
+	};
 
+	auto cancel = [&]() -> task<int>
+	{
+		co_await ioSvc.schedule();
+		canceller.request_cancellation();
 		co_return 0;
 	};
 
-	ip_endpoint serverAddress;
+	(void)sync_wait(when_all(
+		[&]() -> task<int>
+		{
+			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
+			(void)co_await when_all(server(), cancel());
+			co_return 0;
+		}(),
+		[&]() -> task<int>
+		{
+			ioSvc.process_events();
+			co_return 0;
+		}()));
+}
 
-	task<int> serverTask;
+TEST_CASE("TCP/IPv4 accept_many cancellation while client connecting")
+{
+	io_service ioSvc;
 
-	{
-		auto serverSocket = socket::create_udpv4(ioSvc);
-		serverSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
-		serverAddress = serverSocket.local_endpoint();
-		serverTask = server(std::move(serverSocket));
-	}
+	auto listeningSocket = socket::create_tcpv4(ioSvc);
 
-	auto client = [&]() -> task<int>
+	listeningSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+	listeningSocket.listen(5);
+
+	cancellation_source canceller;
+
+	auto server = [&]() -> task<int>
 	{
-		auto socket = socket::create_udpv4(ioSvc);
+		int acceptedCount = 0;
 
-		// don't need to bind(), should be implicitly bound on first send_to().
+		auto connections = listeningSocket.accept_many(ioSvc, canceller.token());
+		try
+		{
+			for (auto it = co_await connections.begin(); it != connections.end(); co_await ++it)
+			{
+				socket s = std::move(*it);
+				if (++acceptedCount == 1)
+				{
+					// The next client is connecting while we cancel.
+					canceller.request_cancellation();
+				}
+			}
 
-		// Send first message of 50 bytes
+			FAIL("Should have thrown");
+		}
+		catch (const operation_cancelled&)
 		{
-			std::uint8_t buffer[50] = { 0 };
-			co_await socket.send_to(serverAddress, buffer, 50);
 		}
 
-		// Receive ACK message
+		CHECK(acceptedCount >= 1);
+		co_return 0;
+	};
+
+	auto clients = [&]() -> task<int>
+	{
+		auto first = socket::create_tcpv4(ioSvc);
+		co_await first.connect(listeningSocket.local_endpoint());
+
+		auto second = socket::create_tcpv4(ioSvc);
+		co_await second.connect(listeningSocket.local_endpoint());
+		co_return 0;
+	};
+
+	(void)sync_wait(when_all(
+		[&]() -> task<int>
 		{
-			std::uint8_t buffer[1];
-			auto[bytesReceived, ackAddress] = co_await socket.recv_from(buffer, 1);
-			CHECK(bytesReceived == 1);
-			CHECK(buffer[0] == 0);
-			CHECK(ackAddress == serverAddress);
+			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
+			(void)co_await when_all(server(), clients());
+			co_return 0;
+		}(),
+		[&]() -> task<int>
+		{
+			ioSvc.process_events();
+			co_return 0;
+		}()));
+}
+
+TEST_CASE("TCP/IPv4 accept_many destroyed while client connecting")
+{
+	io_service ioSvc;
+
+	auto listeningSocket = socket::create_tcpv4(ioSvc);
+
+	listeningSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+	listeningSocket.listen(5);
+
+	single_consumer_event generatorDestroyed;
+
+	auto server = [&]() -> task<int>
+	{
+		{
+			auto connections = listeningSocket.accept_many(ioSvc);
+			auto it = co_await connections.begin();
+			socket s = std::move(*it);
+
+			// Destroying the generator here, while the next client is
+			// connecting, must stop it accepting further connections.
 		}
+		generatorDestroyed.set();
 
-		// Send second message of 128 bytes
+		// Hangs if the generator's accept is still running and takes
+		// every connection.
+		auto acceptingSocket = socket::create_tcpv4(ioSvc);
+		co_await listeningSocket.accept(acceptingSocket);
+		co_return 0;
+	};
+
+	auto clients = [&]() -> task<int>
+	{
+		auto first = socket::create_tcpv4(ioSvc);
+		co_await first.connect(listeningSocket.local_endpoint());
+
+		// May be accepted by the generator before it is destroyed.
+		auto second = socket::create_tcpv4(ioSvc);
+		co_await second.connect(listeningSocket.local_endpoint());
+
+		co_await generatorDestroyed;
+		auto third = socket::create_tcpv4(ioSvc);
+		co_await third.connect(listeningSocket.local_endpoint());
+		co_return 0;
+	};
+
+	(void)sync_wait(when_all(
+		[&]() -> task<int>
 		{
-			std::uint8_t buffer[128] = { 0 };
-			co_await socket.send_to(serverAddress, buffer, 128);
+			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
+			(void)co_await when_all(server(), clients());
+			co_return 0;
+		}(),
+		[&]() -> task<int>
+		{
+			ioSvc.process_events();
+			co_return 0;
+		}()));
+}
+
+TEST_CASE("TCP/IPv4 send_all/scatter recv")
+{
+	io_service ioSvc;
+
+	auto listeningSocket = socket::create_tcpv4(ioSvc);
+
+	listeningSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+	listeningSocket.listen(1);
+
+	// Large enough that the payload can't be sent with a single send.
+	constexpr std::size_t payloadSize = 4 * 1024 * 1024;
+	constexpr int frameCount = 3;
+
+	auto server = [&]() -> task<int>
+	{
+		auto acceptingSocket = socket::create_tcpv4(ioSvc);
+
+		co_await listeningSocket.accept(acceptingSocket);
+
+		std::vector<std::uint8_t> payload(payloadSize);
+		for (int frame = 0; frame < frameCount; ++frame)
+		{
+			char header[8];
+			char trailer[4];
+			std::size_t headerSize = 0;
+			std::size_t payloadReceived = 0;
+			std::size_t trailerSize = 0;
+			while (trailerSize < sizeof(trailer))
+			{
+				const std::array<mutable_buffer, 3> buffers = {
+					mutable_buffer{ header + headerSize, sizeof(header) - headerSize },
+					mutable_buffer{ payload.data() + payloadReceived, payloadSize - payloadReceived },
+					mutable_buffer{ trailer + trailerSize, sizeof(trailer) - trailerSize }
+				};
+				std::size_t bytesReceived = co_await acceptingSocket.recv(buffers);
+				REQUIRE(bytesReceived > 0);
+
+				const auto consume = [&](std::size_t& size, std::size_t capacity)
+				{
+					const std::size_t n = std::min(bytesReceived, capacity - size);
+					size += n;
+					bytesReceived -= n;
+				};
+				consume(headerSize, sizeof(header));
+				consume(payloadReceived, payloadSize);
+				consume(trailerSize, sizeof(trailer));
+			}
+
+			CHECK(std::string_view(header, sizeof(header)) == "[header]");
+			CHECK(std::string_view(trailer, sizeof(trailer)) == "[end");
+			bool isPayloadIntact = true;
+			for (std::size_t i = 0; i < payloadSize; ++i)
+			{
+				isPayloadIntact &= payload[i] == static_cast<std::uint8_t>((i + frame) % 251);
+			}
+			CHECK(isPayloadIntact);
 		}
 
-		// Receive NACK message
+		std::uint8_t byte;
+		const std::size_t bytesReceived = co_await acceptingSocket.recv(&byte, 1);
+		CHECK(bytesReceived == 0);
+
+		co_return 0;
+	};
+
+	auto client = [&]() -> task<int>
+	{
+		auto connectingSocket = socket::create_tcpv4(ioSvc);
+
+		co_await connectingSocket.connect(listeningSocket.local_endpoint());
+
+		std::vector<std::uint8_t> payload(payloadSize);
+		for (int frame = 0; frame < frameCount; ++frame)
 		{
-			std::uint8_t buffer[1];
-			auto[bytesReceived, ackAddress] = co_await socket.recv_from(buffer, 1);
-			CHECK(bytesReceived == 1);
-			CHECK(buffer[0] == 1);
-			CHECK(ackAddress == serverAddress);
+			for (std::size_t i = 0; i < payloadSize; ++i)
+			{
+				payload[i] = static_cast<std::uint8_t>((i + frame) % 251);
+			}
+
+			const std::array<const_buffer, 3> buffers = {
+				const_buffer{ "[header]", 8 },
+				const_buffer{ payload.data(), payloadSize },
+				const_buffer{ "[end", 4 }
+			};
+			const std::size_t bytesSent = co_await connectingSocket.send_all(buffers);
+			CHECK(bytesSent == payloadSize + 12);
 		}
 
+		connectingSocket.close_send();
+
 		co_return 0;
 	};
 
@@ -461,7 +711,7 @@ TEST_CASE("udp send_to/recv_from")
 		[&]() -> task<int>
 		{
 			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
-			(void)co_await when_all(std::move(serverTask), client());
+			(void)co_await when_all(server(), client());
 			co_return 0;
 		}(),
 		[&]() -> task<int>
@@ -471,4 +721,823 @@ TEST_CASE("udp send_to/recv_from")
 		}()));
 }
 
+TEST_CASE("TCP/IPv4 send_all more buffers than a single send")
+{
+	io_service ioSvc;
+
+	auto listeningSocket = socket::create_tcpv4(ioSvc);
+
+	listeningSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+	listeningSocket.listen(1);
+
+	// More than socket_send_buffers_operation_impl::max_buffer_count, some
+	// of them large enough to need several sends, and some of them empty.
+	constexpr std::size_t bufferCount = 40;
+
+	std::vector<std::vector<std::uint8_t>> chunks(bufferCount);
+	std::vector<std::uint8_t> expected;
+	for (std::size_t i = 0; i < bufferCount; ++i)
+	{
+		const std::size_t chunkSize = i % 10 == 0 ? 0 : (i % 3 == 0 ? 512 * 1024 : i);
+		for (std::size_t j = 0; j < chunkSize; ++j)
+		{
+			chunks[i].push_back(static_cast<std::uint8_t>((i * 7 + j) % 251));
+		}
+
+		expected.insert(expected.end(), chunks[i].begin(), chunks[i].end());
+	}
+
+	auto server = [&]() -> task<int>
+	{
+		auto acceptingSocket = socket::create_tcpv4(ioSvc);
+
+		co_await listeningSocket.accept(acceptingSocket);
+
+		std::vector<std::uint8_t> received(expected.size() + 1);
+		std::size_t totalBytesReceived = 0;
+		while (true)
+		{
+			const std::size_t bytesReceived = co_await acceptingSocket.recv(
+				received.data() + totalBytesReceived,
+				received.size() - totalBytesReceived);
+			if (bytesReceived == 0)
+			{
+				break;
+			}
+
+			totalBytesReceived += bytesReceived;
+			REQUIRE(totalBytesReceived <= expected.size());
+		}
+
+		received.resize(totalBytesReceived);
+		CHECK(received == expected);
+
+		co_return 0;
+	};
+
+	auto client = [&]() -> task<int>
+	{
+		auto connectingSocket = socket::create_tcpv4(ioSvc);
+
+		co_await connectingSocket.connect(listeningSocket.local_endpoint());
+
+		std::vector<const_buffer> buffers;
+		for (const auto& chunk : chunks)
+		{
+			buffers.emplace_back(chunk.data(), chunk.size());
+		}
+
+		const std::size_t bytesSent = co_await connectingSocket.send_all(buffers);
+		CHECK(bytesSent == expected.size());
+
+		connectingSocket.close_send();
+
+		co_return 0;
+	};
+
+	(void)sync_wait(when_all(
+		[&]() -> task<int>
+		{
+			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
+			(void)co_await when_all(server(), client());
+			co_return 0;
+		}(),
+		[&]() -> task<int>
+		{
+			ioSvc.process_events();
+			co_return 0;
+		}()));
+}
+
+TEST_CASE("TCP/IPv4 send_file")
+{
+	io_service ioSvc;
+
+	// Large enough that the file can't be sent with a single send_file().
+	constexpr std::size_t fileSize = 4 * 1024 * 1024 + 123;
+
+	// A range from the middle of the file, sent after the whole file.
+	constexpr std::uint64_t rangeOffset = 12345;
+	constexpr std::size_t rangeSize = 100'000;
+
+	std::vector<char> contents(fileSize);
+	for (std::size_t i = 0; i < fileSize; ++i)
+	{
+		contents[i] = static_cast<char>(i % 251);
+	}
+
+	const auto path = std::filesystem::temp_directory_path() / "cppcoro_send_file_test.data";
+	auto removeOnExit = on_scope_exit([&] { std::filesystem::remove(path); });
+	{
+		std::ofstream out{ path, std::ios::binary };
+		out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+	}
+
+	auto file = read_only_file::open(ioSvc, path);
+
+	auto listeningSocket = socket::create_tcpv4(ioSvc);
+
+	listeningSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+	listeningSocket.listen(1);
+
+	auto server = [&]() -> task<int>
+	{
+		auto acceptingSocket = socket::create_tcpv4(ioSvc);
+
+		co_await listeningSocket.accept(acceptingSocket);
+
+		std::vector<char> received(fileSize + rangeSize + 1);
+		std::size_t totalBytesReceived = 0;
+		while (true)
+		{
+			const std::size_t bytesReceived = co_await acceptingSocket.recv(
+				received.data() + totalBytesReceived,
+				received.size() - totalBytesReceived);
+			if (bytesReceived == 0)
+			{
+				break;
+			}
+
+			totalBytesReceived += bytesReceived;
+			REQUIRE(totalBytesReceived <= fileSize + rangeSize);
+		}
+
+		REQUIRE(totalBytesReceived == fileSize + rangeSize);
+		CHECK(std::equal(
+			contents.begin(), contents.end(), received.begin()));
+		CHECK(std::equal(
+			contents.begin() + rangeOffset,
+			contents.begin() + rangeOffset + rangeSize,
+			received.begin() + fileSize));
+
+		co_return 0;
+	};
+
+	auto client = [&]() -> task<int>
+	{
+		auto connectingSocket = socket::create_tcpv4(ioSvc);
+
+		co_await connectingSocket.connect(listeningSocket.local_endpoint());
+
+		auto sendRange = [&](std::uint64_t offset, std::size_t size) -> task<>
+		{
+			std::size_t totalBytesSent = 0;
+			while (totalBytesSent < size)
+			{
+				const std::size_t bytesSent = co_await connectingSocket.send_file(
+					file, offset + totalBytesSent, size - totalBytesSent);
+				REQUIRE(bytesSent > 0);
+				REQUIRE(bytesSent <= size - totalBytesSent);
+				totalBytesSent += bytesSent;
+			}
+		};
+
+		co_await sendRange(0, fileSize);
+		co_await sendRange(rangeOffset, rangeSize);
+
+		connectingSocket.close_send();
+
+		co_return 0;
+	};
+
+	(void)sync_wait(when_all(
+		[&]() -> task<int>
+		{
+			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
+			(void)co_await when_all(server(), client());
+			co_return 0;
+		}(),
+		[&]() -> task<int>
+		{
+			ioSvc.process_events();
+			co_return 0;
+		}()));
+}
+
+TEST_CASE("TCP/IPv4 send_file cancellation")
+{
+	io_service ioSvc;
+
+	constexpr std::size_t fileSize = 1024 * 1024;
+
+	const auto path = std::filesystem::temp_directory_path() / "cppcoro_send_file_cancel_test.data";
+	auto removeOnExit = on_scope_exit([&] { std::filesystem::remove(path); });
+	{
+		std::ofstream out{ path, std::ios::binary };
+		const std::vector<char> contents(fileSize, 'x');
+		out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+	}
+
+	auto file = read_only_file::open(ioSvc, path);
+
+	auto listeningSocket = socket::create_tcpv4(ioSvc);
+
+	listeningSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+	listeningSocket.listen(1);
+
+	auto acceptingSocket = socket::create_tcpv4(ioSvc);
+	auto connectingSocket = socket::create_tcpv4(ioSvc);
+
+	auto test = [&]() -> task<int>
+	{
+		(void)co_await when_all(
+			listeningSocket.accept(acceptingSocket),
+			connectingSocket.connect(listeningSocket.local_endpoint()));
+
+		cancellation_source source;
+		auto cancelLater = [&]() -> task<>
+		{
+			co_await ioSvc.schedule_after(std::chrono::milliseconds(50));
+			source.request_cancellation();
+		};
+
+		// Nothing is received, so the file is sent over and over until the
+		// socket buffers fill up and a send_file() waits to be cancelled.
+		auto sendUntilCancelled = [&]() -> task<>
+		{
+			try
+			{
+				while (true)
+				{
+					(void)co_await connectingSocket.send_file(
+						file, 0, fileSize, source.token());
+				}
+			}
+			catch (const operation_cancelled&)
+			{
+			}
+
+			CHECK(source.is_cancellation_requested());
+		};
+
+		(void)co_await when_all(cancelLater(), sendUntilCancelled());
+
+		co_return 0;
+	};
+
+	(void)sync_wait(when_all(
+		[&]() -> task<int>
+		{
+			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
+			(void)co_await test();
+			co_return 0;
+		}(),
+		[&]() -> task<int>
+		{
+			ioSvc.process_events();
+			co_return 0;
+		}()));
+}
+
+#if CPPCORO_OS_LINUX
+TEST_CASE("TCP/IPv4 recv into recv_buffer_pool")
+{
+	io_service ioSvc;
+
+	// Each connection has at most one receive outstanding and releases its
+	// lease before starting the next, so it never needs more than one buffer.
+	constexpr int clientCount = 8;
+	recv_buffer_pool pool{ ioSvc, 64, clientCount };
+
+	auto listeningSocket = socket::create_tcpv4(ioSvc);
+
+	listeningSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+	listeningSocket.listen(clientCount);
+
+	constexpr std::size_t bytesPerClient = 1000;
+
+	auto handleConnection = [&](socket s) -> task<std::size_t>
+	{
+		std::size_t totalBytesReceived = 0;
+		while (true)
+		{
+			auto lease = co_await s.recv(pool);
+			if (lease.empty())
+			{
+				break;
+			}
+
+			CHECK(lease.size() <= pool.buffer_size());
+			for (std::size_t i = 0; i < lease.size(); ++i)
+			{
+				CHECK(lease.data()[i] == std::byte((totalBytesReceived + i) % 251));
+			}
+
+			totalBytesReceived += lease.size();
+		}
+
+		co_return totalBytesReceived;
+	};
+
+	auto server = [&]() -> task<int>
+	{
+		std::vector<task<std::size_t>> handlers;
+
+		auto connections = listeningSocket.accept_many(ioSvc);
+		for (auto it = co_await connections.begin(); it != connections.end(); co_await ++it)
+		{
+			handlers.emplace_back(handleConnection(std::move(*it)));
+			if (handlers.size() == clientCount)
+			{
+				break;
+			}
+		}
+
+		for (std::size_t bytesReceived : co_await when_all(std::move(handlers)))
+		{
+			CHECK(bytesReceived == bytesPerClient);
+		}
+
+		co_return 0;
+	};
+
+	auto client = [&]() -> task<>
+	{
+		auto s = socket::create_tcpv4(ioSvc);
+		co_await s.connect(listeningSocket.local_endpoint());
+
+		std::uint8_t buffer[bytesPerClient];
+		for (std::size_t i = 0; i < bytesPerClient; ++i)
+		{
+			buffer[i] = static_cast<std::uint8_t>(i % 251);
+		}
+
+		std::size_t bytesSent = 0;
+		while (bytesSent < bytesPerClient)
+		{
+			bytesSent += co_await s.send(buffer + bytesSent, bytesPerClient - bytesSent);
+		}
+
+		s.close_send();
+	};
+
+	auto manyClients = [&]() -> task<int>
+	{
+		std::vector<task<>> clientTasks;
+		clientTasks.reserve(clientCount);
+		for (int i = 0; i < clientCount; ++i)
+		{
+			clientTasks.emplace_back(client());
+		}
+
+		co_await when_all(std::move(clientTasks));
+		co_return 0;
+	};
+
+	(void)sync_wait(when_all(
+		[&]() -> task<int>
+		{
+			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
+			(void)co_await when_all(server(), manyClients());
+			co_return 0;
+		}(),
+		[&]() -> task<int>
+		{
+			ioSvc.process_events();
+			co_return 0;
+		}()));
+}
+#endif
+
+#if CPPCORO_OS_LINUX
+TEST_CASE("TCP/IPv4 send_zerocopy")
+{
+	io_service ioSvc;
+
+	auto listeningSocket = socket::create_tcpv4(ioSvc);
+
+	listeningSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+	listeningSocket.listen(1);
+
+	constexpr std::size_t chunkSize = 256 * 1024;
+	constexpr std::size_t totalSize = 16 * chunkSize;
+
+	auto server = [&]() -> task<int>
+	{
+		auto acceptingSocket = socket::create_tcpv4(ioSvc);
+
+		co_await listeningSocket.accept(acceptingSocket);
+
+		std::vector<std::uint8_t> buffer(chunkSize);
+		std::size_t totalBytesReceived = 0;
+		std::size_t bytesReceived;
+		do
+		{
+			bytesReceived = co_await acceptingSocket.recv(buffer.data(), buffer.size());
+			for (std::size_t i = 0; i < bytesReceived; ++i)
+			{
+				CHECK(buffer[i] == static_cast<std::uint8_t>((totalBytesReceived + i) % 251));
+			}
+
+			totalBytesReceived += bytesReceived;
+		} while (bytesReceived > 0);
+
+		CHECK(totalBytesReceived == totalSize);
+
+		co_return 0;
+	};
+
+	auto client = [&]() -> task<int>
+	{
+		auto connectingSocket = socket::create_tcpv4(ioSvc);
+
+		co_await connectingSocket.connect(listeningSocket.local_endpoint());
+
+		std::vector<std::uint8_t> buffer(totalSize);
+		for (std::size_t i = 0; i < totalSize; ++i)
+		{
+			buffer[i] = static_cast<std::uint8_t>(i % 251);
+		}
+
+		// Keep several sends in flight, only waiting for each buffer to be
+		// released once all of the data has been queued.
+		std::vector<zerocopy_send> sends;
+		std::size_t totalBytesSent = 0;
+		while (totalBytesSent < totalSize)
+		{
+			sends.push_back(co_await connectingSocket.send_zerocopy(
+				buffer.data() + totalBytesSent,
+				std::min(chunkSize, totalSize - totalBytesSent)));
+			CHECK(sends.back().bytes_sent() > 0);
+			totalBytesSent += sends.back().bytes_sent();
+		}
+
+		connectingSocket.close_send();
+
+		for (auto& send : sends)
+		{
+			co_await send.buffer_released();
+			CHECK(send.is_buffer_released());
+		}
+
+		co_return 0;
+	};
+
+	(void)sync_wait(when_all(
+		[&]() -> task<int>
+		{
+			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
+			(void)co_await when_all(server(), client());
+			co_return 0;
+		}(),
+		[&]() -> task<int>
+		{
+			ioSvc.process_events();
+			co_return 0;
+		}()));
+}
+
+TEST_CASE("TCP/IPv4 send_zerocopy cancellation")
+{
+	io_service ioSvc;
+
+	auto listeningSocket = socket::create_tcpv4(ioSvc);
+
+	listeningSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+	listeningSocket.listen(1);
+
+	auto acceptingSocket = socket::create_tcpv4(ioSvc);
+	auto connectingSocket = socket::create_tcpv4(ioSvc);
+
+	auto test = [&]() -> task<int>
+	{
+		(void)co_await when_all(
+			listeningSocket.accept(acceptingSocket),
+			connectingSocket.connect(listeningSocket.local_endpoint()));
+
+		// Nothing is received, so sends stall once the socket buffers fill up.
+		std::vector<std::uint8_t> buffer(1024 * 1024);
+
+		cancellation_source source;
+		auto cancelLater = [&]() -> task<>
+		{
+			co_await ioSvc.schedule_after(std::chrono::milliseconds(50));
+			source.request_cancellation();
+		};
+
+		auto sendUntilCancelled = [&]() -> task<>
+		{
+			std::vector<zerocopy_send> sends;
+			try
+			{
+				while (true)
+				{
+					sends.push_back(co_await connectingSocket.send_zerocopy(
+						buffer.data(), buffer.size(), source.token()));
+				}
+			}
+			catch (const operation_cancelled&)
+			{
+			}
+
+			CHECK(source.is_cancellation_requested());
+
+			// Closing the receiving socket with data left unreceived resets
+			// the connection, after which the kernel releases the buffers.
+			{
+				auto closingSocket = std::move(acceptingSocket);
+			}
+
+			for (auto& send : sends)
+			{
+				co_await send.buffer_released();
+			}
+		};
+
+		(void)co_await when_all(cancelLater(), sendUntilCancelled());
+
+		co_return 0;
+	};
+
+	(void)sync_wait(when_all(
+		[&]() -> task<int>
+		{
+			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
+			(void)co_await test();
+			co_return 0;
+		}(),
+		[&]() -> task<int>
+		{
+			ioSvc.process_events();
+			co_return 0;
+		}()));
+}
+#endif
+
+TEST_CASE("udp send_to/recv_from")
+{
+	io_service ioSvc;
+
+	auto server = [&](socket serverSocket) -> task<int>
+	{
+		std::uint8_t buffer[100];
+
+		auto[bytesReceived, remoteEndPoint] = co_await serverSocket.recv_from(buffer, 100);
+		CHECK(bytesReceived == 50);
+
+		// Send an ACK response.
+		{
+			const std::uint8_t response[1] = { 0 };
+			co_await serverSocket.send_to(remoteEndPoint, &response, 1);
+		}
+
+		// Second message received won't fit within buffer.
+		try
+		{
+			std::tie(bytesReceived, remoteEndPoint) = co_await serverSocket.recv_from(buffer, 100);
+			FAIL("Should have thrown");
+		}
+		catch (const std::system_error&)
+		{
+			// TODO: Map this situation to some kind of error_condition value.
+			// The win32 ERROR_MORE_DATA error code doesn't seem to map to any of the standard std::errc values.
+			//
+			// CHECK(ex.code() == ???);
+			//
+			// Possibly also need to switch to returning a std::error_code directly rather than
+			// throwing a std::system_error for this case.
+		}
+
+		// Send an NACK response.
+		{
+			const std::uint8_t response[1] = { 1 };
+			co_await serverSocket.send_to(remoteEndPoint, response, 1);
+		}
+
+		co_return 0;
+	};
+
+	ip_endpoint serverAddress;
+
+	task<int> serverTask;
+
+	{
+		auto serverSocket = socket::create_udpv4(ioSvc);
+		serverSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+		serverAddress = serverSocket.local_endpoint();
+		serverTask = server(std::move(serverSocket));
+	}
+
+	auto client = [&]() -> task<int>
+	{
+		auto socket = socket::create_udpv4(ioSvc);
+
+		// don't need to bind(), should be implicitly bound on first send_to().
+
+		// Send first message of 50 bytes
+		{
+			std::uint8_t buffer[50] = { 0 };
+			co_await socket.send_to(serverAddress, buffer, 50);
+		}
+
+		// Receive ACK message
+		{
+			std::uint8_t buffer[1];
+			auto[bytesReceived, ackAddress] = co_await socket.recv_from(buffer, 1);
+			CHECK(bytesReceived == 1);
+			CHECK(buffer[0] == 0);
+			CHECK(ackAddress == serverAddress);
+		}
+
+		// Send second message of 128 bytes
+		{
+			std::uint8_t buffer[128] = { 0 };
+			co_await socket.send_to(serverAddress, buffer, 128);
+		}
+
+		// Receive NACK message
+		{
+			std::uint8_t buffer[1];
+			auto[bytesReceived, ackAddress] = co_await socket.recv_from(buffer, 1);
+			CHECK(bytesReceived == 1);
+			CHECK(buffer[0] == 1);
+			CHECK(ackAddress == serverAddress);
+		}
+
+		co_return 0;
+	};
+
+	(void)sync_wait(when_all(
+		[&]() -> task<int>
+		{
+			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
+			(void)co_await when_all(std::move(serverTask), client());
+			co_return 0;
+		}(),
+		[&]() -> task<int>
+		{
+			ioSvc.process_events();
+			co_return 0;
+		}()));
+}
+
+#if CPPCORO_OS_LINUX
+TEST_CASE("udp send_to_batch/recv_from_batch")
+{
+	io_service ioSvc;
+
+	constexpr std::size_t datagramCount = 8;
+
+	auto serverSocket = socket::create_udpv4(ioSvc);
+	serverSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+
+	auto clientSocket = socket::create_udpv4(ioSvc);
+	clientSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+
+	auto server = [&]() -> task<int>
+	{
+		std::uint8_t buffers[datagramCount][16];
+		datagram_buffer datagrams[datagramCount];
+		for (std::size_t i = 0; i < datagramCount; ++i)
+		{
+			datagrams[i].buffer = buffers[i];
+			datagrams[i].size = sizeof(buffers[i]);
+		}
+
+		std::size_t receivedCount = 0;
+		while (receivedCount < datagramCount)
+		{
+			const std::size_t count = co_await serverSocket.recv_from_batch(
+				std::span{ datagrams }.subspan(receivedCount));
+			CHECK(count > 0);
+
+			for (std::size_t i = receivedCount; i < receivedCount + count; ++i)
+			{
+				CHECK(datagrams[i].endpoint == clientSocket.local_endpoint());
+
+				// The last datagram doesn't fit within its buffer.
+				CHECK(datagrams[i].bytesTransferred == i + 1 + (i == datagramCount - 1 ? 16 : 0));
+				CHECK(buffers[i][0] == i);
+			}
+
+			receivedCount += count;
+		}
+
+		co_return 0;
+	};
+
+	auto client = [&]() -> task<int>
+	{
+		std::uint8_t payloads[datagramCount][32];
+		datagram_buffer datagrams[datagramCount];
+		for (std::size_t i = 0; i < datagramCount; ++i)
+		{
+			payloads[i][0] = static_cast<std::uint8_t>(i);
+			datagrams[i].buffer = payloads[i];
+			datagrams[i].size = i + 1 + (i == datagramCount - 1 ? 16 : 0);
+			datagrams[i].endpoint = serverSocket.local_endpoint();
+		}
+
+		std::size_t sentCount = 0;
+		while (sentCount < datagramCount)
+		{
+			sentCount += co_await clientSocket.send_to_batch(
+				std::span<const datagram_buffer>{ datagrams }.subspan(sentCount));
+		}
+
+		co_return 0;
+	};
+
+	(void)sync_wait(when_all(
+		[&]() -> task<int>
+		{
+			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
+			(void)co_await when_all(server(), client());
+			co_return 0;
+		}(),
+		[&]() -> task<int>
+		{
+			ioSvc.process_events();
+			co_return 0;
+		}()));
+}
+#endif
+
+#if CPPCORO_OS_LINUX
+TEST_CASE("udp send_to_segmented/recv_from_coalesced")
+{
+	io_service ioSvc;
+
+	constexpr std::size_t segmentSize = 100;
+	constexpr std::size_t payloadSize = 1050;
+
+	auto serverSocket = socket::create_udpv4(ioSvc);
+	serverSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+	serverSocket.set_udp_gro(true);
+
+	auto clientSocket = socket::create_udpv4(ioSvc);
+	clientSocket.bind(ipv4_endpoint{ ipv4_address::loopback(), 0 });
+
+	auto server = [&]() -> task<int>
+	{
+		std::uint8_t buffer[65536];
+
+		std::size_t totalBytesReceived = 0;
+		while (totalBytesReceived < payloadSize)
+		{
+			auto [bytesReceived, remoteEndPoint, receivedSegmentSize] =
+				co_await serverSocket.recv_from_coalesced(buffer, sizeof(buffer));
+			CHECK(remoteEndPoint == clientSocket.local_endpoint());
+			CHECK(bytesReceived > 0);
+
+			// Every datagram but the last has the full segment size.
+			CHECK(receivedSegmentSize <= segmentSize);
+			totalBytesReceived += bytesReceived;
+		}
+
+		CHECK(totalBytesReceived == payloadSize);
+
+		co_return 0;
+	};
+
+	auto client = [&]() -> task<int>
+	{
+		std::uint8_t payload[payloadSize];
+		for (std::size_t i = 0; i < payloadSize; ++i)
+		{
+			payload[i] = static_cast<std::uint8_t>(i);
+		}
+
+		auto bytesSent = co_await clientSocket.send_to_segmented(
+			serverSocket.local_endpoint(), payload, payloadSize, segmentSize);
+		CHECK(bytesSent == payloadSize);
+
+		co_return 0;
+	};
+
+	(void)sync_wait(when_all(
+		[&]() -> task<int>
+		{
+			auto stopOnExit = on_scope_exit([&] { ioSvc.stop(); });
+			(void)co_await when_all(server(), client());
+			co_return 0;
+		}(),
+		[&]() -> task<int>
+		{
+			ioSvc.process_events();
+			co_return 0;
+		}()));
+}
+#endif
+
+#if CPPCORO_OS_LINUX
+TEST_CASE("closing a registered socket unregisters it")
+{
+	io_service ioSvc;
+
+	int fd;
+	{
+		auto s = socket::create_tcpv4(ioSvc);
+		fd = s.native_handle();
+		ioSvc.register_file(fd);
+	}
+
+	// The new socket reuses the descriptor number, which could only be
+	// registered again if closing the old socket dropped its registration.
+	auto s = socket::create_tcpv4(ioSvc);
+	REQUIRE(s.native_handle() == fd);
+	CHECK_NOTHROW(ioSvc.register_file(fd));
+}
+#endif
+
 TEST_SUITE_END();
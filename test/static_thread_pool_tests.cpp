@@ -8,6 +8,7 @@
 #include <cppcoro/sync_wait.hpp>
 #include <cppcoro/when_all.hpp>
 
+#include <atomic>
 #include <vector>
 #include <thread>
 #include <cassert>
@@ -31,6 +32,27 @@ TEST_CASE("construct/destruct to specific thread count")
 	CHECK(threadPool.thread_count() == 5);
 }
 
+TEST_CASE("destruct straight after work scheduled from a pool thread completes")
+{
+	// A pool thread may still be waking another thread for work that has
+	// already run, and completed, by the time the pool is destroyed.
+	for (int i = 0; i < 1000; ++i)
+	{
+		cppcoro::static_thread_pool threadPool{ 4 };
+
+		auto subTask = [&]() -> cppcoro::task<>
+		{
+			co_await threadPool.schedule();
+		};
+
+		cppcoro::sync_wait([&]() -> cppcoro::task<>
+		{
+			co_await threadPool.schedule();
+			co_await cppcoro::when_all(subTask(), subTask(), subTask());
+		}());
+	}
+}
+
 TEST_CASE("run one task")
 {
 	cppcoro::static_thread_pool threadPool{ 2 };
@@ -65,6 +87,178 @@ TEST_CASE("launch many tasks remotely")
 	cppcoro::sync_wait(cppcoro::when_all(std::move(tasks)));
 }
 
+TEST_CASE("schedule from many producer threads")
+{
+	// Reports how the throughput of scheduling onto the pool from outside
+	// of its threads scales with the number of threads doing so.
+	cppcoro::static_thread_pool tp;
+
+	constexpr std::uint32_t operationsPerThread = 20'000;
+
+	for (std::uint32_t producerCount = 1; producerCount <= 64; producerCount *= 2)
+	{
+		std::atomic<std::uint32_t> completedCount = 0;
+
+		auto makeTask = [&]() -> cppcoro::task<>
+		{
+			co_await tp.schedule();
+			completedCount.fetch_add(1, std::memory_order_relaxed);
+		};
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		std::vector<std::thread> producers;
+		for (std::uint32_t i = 0; i < producerCount; ++i)
+		{
+			producers.emplace_back([&]
+			{
+				std::vector<cppcoro::task<>> tasks;
+				tasks.reserve(operationsPerThread);
+				for (std::uint32_t j = 0; j < operationsPerThread; ++j)
+				{
+					tasks.push_back(makeTask());
+				}
+
+				cppcoro::sync_wait(cppcoro::when_all(std::move(tasks)));
+			});
+		}
+
+		for (auto& producer : producers)
+		{
+			producer.join();
+		}
+
+		auto end = std::chrono::high_resolution_clock::now();
+
+		const std::uint64_t operationCount = std::uint64_t(producerCount) * operationsPerThread;
+		CHECK(completedCount.load() == operationCount);
+
+		const auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+		std::cout << producerCount << " producer threads scheduled "
+			<< operationCount << " operations in " << elapsedUs << "us ("
+			<< (elapsedUs > 0 ? operationCount / elapsedUs : 0) << " per us)" << std::endl;
+	}
+}
+
+TEST_CASE("schedule burst larger than local queue")
+{
+	// Scheduling this many operations from one of the pool's threads
+	// overflows its local queue.
+	cppcoro::static_thread_pool tp{ 2 };
+
+	constexpr std::uint32_t burstSize = 500'000;
+
+	std::atomic<std::uint32_t> completedCount = 0;
+
+	auto makeTask = [&]() -> cppcoro::task<>
+	{
+		co_await tp.schedule();
+		completedCount.fetch_add(1, std::memory_order_relaxed);
+	};
+
+	cppcoro::sync_wait([&]() -> cppcoro::task<>
+	{
+		co_await tp.schedule();
+
+		std::vector<cppcoro::task<>> tasks;
+		tasks.reserve(burstSize);
+		for (std::uint32_t i = 0; i < burstSize; ++i)
+		{
+			tasks.push_back(makeTask());
+		}
+
+		co_await cppcoro::when_all(std::move(tasks));
+	}());
+
+	CHECK(completedCount.load() == burstSize);
+}
+
+TEST_CASE("schedule burst larger than maximum local queue size")
+{
+	// With a single thread nothing is stolen, so the local queue fills up
+	// to its maximum size and the rest of the burst has to overflow.
+	cppcoro::static_thread_pool tp{ 1 };
+
+	constexpr std::uint32_t burstSize = 1'000'000;
+
+	std::atomic<std::uint32_t> completedCount = 0;
+
+	auto makeTask = [&]() -> cppcoro::task<>
+	{
+		co_await tp.schedule();
+		completedCount.fetch_add(1, std::memory_order_relaxed);
+	};
+
+	cppcoro::sync_wait([&]() -> cppcoro::task<>
+	{
+		co_await tp.schedule();
+
+		std::vector<cppcoro::task<>> tasks;
+		tasks.reserve(burstSize);
+		for (std::uint32_t i = 0; i < burstSize; ++i)
+		{
+			tasks.push_back(makeTask());
+		}
+
+		co_await cppcoro::when_all(std::move(tasks));
+	}());
+
+	CHECK(completedCount.load() == burstSize);
+}
+
+TEST_CASE("reschedule from a pool thread")
+{
+	// Reports the cost of a pool thread scheduling a continuation that
+	// it then runs itself.
+	cppcoro::static_thread_pool tp{ 4 };
+
+	constexpr std::uint32_t rescheduleCount = 1'000'000;
+
+	cppcoro::sync_wait([&]() -> cppcoro::task<>
+	{
+		co_await tp.schedule();
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		for (std::uint32_t i = 0; i < rescheduleCount; ++i)
+		{
+			co_await tp.schedule();
+		}
+
+		auto end = std::chrono::high_resolution_clock::now();
+
+		std::cout << rescheduleCount << " reschedules took "
+			<< std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+			<< "us" << std::endl;
+	}());
+}
+
+TEST_CASE("rescheduling in a loop doesn't starve other queued work")
+{
+	cppcoro::static_thread_pool tp{ 1 };
+
+	std::atomic<bool> done = false;
+
+	auto rescheduleUntilDone = [&]() -> cppcoro::task<>
+	{
+		co_await tp.schedule();
+		while (!done.load())
+		{
+			co_await tp.schedule();
+		}
+	};
+
+	auto setDone = [&]() -> cppcoro::task<>
+	{
+		co_await tp.schedule();
+		done = true;
+	};
+
+	cppcoro::sync_wait(cppcoro::when_all(rescheduleUntilDone(), setDone()));
+
+	CHECK(done.load());
+}
+
 cppcoro::task<std::uint64_t> sum_of_squares(
 	std::uint32_t start,
 	std::uint32_t end,
@@ -287,4 +481,63 @@ TEST_CASE("for_each_async")
 
 }
 
+TEST_CASE("fork-join from one thread balances across the pool")
+{
+	// All of the forked tasks are initially queued to a single thread's
+	// local queue. Report how long it takes for every thread in the pool
+	// to be running them, and how long they take to complete.
+	cppcoro::static_thread_pool tp;
+
+	constexpr std::uint32_t taskCount = 100'000;
+
+	std::atomic<std::uint32_t> threadsRunningCount = 0;
+	std::atomic<std::uint32_t> completedCount = 0;
+	std::chrono::high_resolution_clock::time_point start;
+	std::atomic<std::int64_t> balancedAfterUs = -1;
+
+	auto makeTask = [&](std::uint64_t value) -> cppcoro::task<>
+	{
+		co_await tp.schedule();
+
+		thread_local bool hasRunTask = false;
+		if (!hasRunTask)
+		{
+			hasRunTask = true;
+			if (threadsRunningCount.fetch_add(1) + 1 == tp.thread_count())
+			{
+				balancedAfterUs = std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::high_resolution_clock::now() - start).count();
+			}
+		}
+
+		(void)collatz_distance(value);
+		completedCount.fetch_add(1, std::memory_order_relaxed);
+	};
+
+	cppcoro::sync_wait([&]() -> cppcoro::task<>
+	{
+		co_await tp.schedule();
+
+		std::vector<cppcoro::task<>> tasks;
+		tasks.reserve(taskCount);
+		for (std::uint32_t i = 0; i < taskCount; ++i)
+		{
+			tasks.push_back(makeTask(i + 1));
+		}
+
+		start = std::chrono::high_resolution_clock::now();
+
+		co_await cppcoro::when_all(std::move(tasks));
+
+		auto end = std::chrono::high_resolution_clock::now();
+
+		std::cout << "fork-join of " << taskCount << " tasks took "
+			<< std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+			<< "us, all " << tp.thread_count() << " threads were running tasks after "
+			<< balancedAfterUs.load() << "us" << std::endl;
+	}());
+
+	CHECK(completedCount.load() == taskCount);
+}
+
 TEST_SUITE_END();